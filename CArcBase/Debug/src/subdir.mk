@@ -6,17 +6,20 @@
 CPP_SRCS += \
 ../src/CArcBase.cpp \
 ../src/CArcBaseDllMain.cpp \
-../src/CArcStringList.cpp 
+../src/CArcStringList.cpp \
+../src/CArcTrace.cpp 
 
 OBJS += \
 ./src/CArcBase.o \
 ./src/CArcBaseDllMain.o \
-./src/CArcStringList.o 
+./src/CArcStringList.o \
+./src/CArcTrace.o 
 
 CPP_DEPS += \
 ./src/CArcBase.d \
 ./src/CArcBaseDllMain.d \
-./src/CArcStringList.d 
+./src/CArcStringList.d \
+./src/CArcTrace.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -0,0 +1,194 @@
+// +---------------------------------------------------------------------------------------------------------+
+// |  FILE:  CArcTrace.h                                                                                     |
+// +---------------------------------------------------------------------------------------------------------+
+// |  PURPOSE: This file defines a lightweight timeline trace buffer. Spans recorded by the device, image    |
+// |           and fits libraries can be exported to the Chrome trace event format ( chrome://tracing or     |
+// |           https://ui.perfetto.dev ).                                                                    |
+// |                                                                                                         |
+// |  AUTHOR:  Caltech Optical Observatories			DATE: October 18, 2026                               |
+// +---------------------------------------------------------------------------------------------------------+
+#ifndef _ARC_CARCTRACE_H_
+#define _ARC_CARCTRACE_H_
+
+#ifdef _WINDOWS
+	#pragma warning( disable: 4251 )
+#endif
+
+#include <cstdint>
+#include <atomic>
+#include <string>
+
+#include <CArcBaseDllMain.h>
+
+
+
+// +---------------------------------------------------------------------------------------------------------+
+// |  Scoped span macro. Records a span from the point of declaration until the end of the enclosing scope.  |
+// |  The name and category MUST be string literals ( or otherwise have static storage duration ).          |
+// +---------------------------------------------------------------------------------------------------------+
+#define ARC_TRACE_CONCAT_( a, b )			a##b
+#define ARC_TRACE_CONCAT( a, b )			ARC_TRACE_CONCAT_( a, b )
+
+#define ARC_TRACE_SPAN( name, category )	arc::gen3::CArcTraceSpan ARC_TRACE_CONCAT( _arcTraceSpan_, __LINE__ )( name, category )
+
+
+
+namespace arc
+{
+	namespace gen3
+	{
+		// +-----------------------------------------------------------------------------------------------------+
+		// |  CArcTrace Class                                                                                    |
+		// +-----------------------------------------------------------------------------------------------------+
+
+		/** @class CArcTrace
+		 *  Process wide timeline trace buffer. Tracing is disabled by default, in which case recording a span
+		 *  costs a single relaxed atomic load. When enabled, spans are stored in a fixed capacity ring buffer;
+		 *  once full, the oldest spans are overwritten and counted as dropped.
+		 */
+		class GEN3_CARCBASE_API CArcTrace
+		{
+			public:
+
+				/** Default number of spans held by the trace buffer.
+				 */
+				static constexpr std::uint32_t DEFAULT_CAPACITY = 65536;
+
+				/** Enables or disables tracing. Enabling the trace does not clear previously recorded spans.
+				 *  @param bOnOff - <code>true</code> to enable tracing; <code>false</code> to disable.
+				 *  @param uiCapacity - The maximum number of spans to hold. The buffer is only re-sized ( and
+				 *                      cleared ) if this differs from the current capacity.
+				 *  @throws std::invalid_argument if tracing is enabled with a capacity of zero.
+				 */
+				static void enable( bool bOnOff, std::uint32_t uiCapacity = DEFAULT_CAPACITY );
+
+				/** Returns whether or not tracing is currently enabled.
+				 *  @return <code>true</code> if tracing is enabled; <code>false</code> otherwise.
+				 */
+				static bool isEnabled( void )
+				{
+					return m_bEnabled.load( std::memory_order_relaxed );
+				}
+
+				/** Returns the current trace time.
+				 *  @return The number of nanoseconds since the trace epoch ( monotonic ).
+				 */
+				static std::uint64_t now( void );
+
+				/** Records a completed span. Does nothing if tracing is disabled.
+				 *  @param pszName - The span name. Must have static storage duration ( i.e. a string literal ).
+				 *  @param pszCategory - The span category. Must have static storage duration.
+				 *  @param u64Begin - The span start time, as returned by now().
+				 *  @param u64End - The span end time, as returned by now().
+				 */
+				static void record( const char* pszName, const char* pszCategory, std::uint64_t u64Begin, std::uint64_t u64End );
+
+				/** Discards all recorded spans and resets the dropped span count.
+				 */
+				static void clear( void );
+
+				/** Returns the number of spans currently held by the trace buffer.
+				 *  @return The span count.
+				 */
+				static std::uint32_t count( void );
+
+				/** Returns the number of spans that were overwritten because the trace buffer was full.
+				 *  @return The dropped span count.
+				 */
+				static std::uint64_t dropped( void );
+
+				/** Returns the recorded spans as a Chrome trace event format JSON string.
+				 *  @return The JSON document.
+				 */
+				static std::string toJSON( void );
+
+				/** Writes the recorded spans to the specified file in the Chrome trace event format. The file
+				 *  can be loaded into chrome://tracing or https://ui.perfetto.dev.
+				 *  @param sFilename - The output file path.
+				 *  @throws std::runtime_error
+				 */
+				static void exportJSON( const std::string& sFilename );
+
+			private:
+
+				static std::atomic<bool>	m_bEnabled;
+		};
+
+
+		// +-----------------------------------------------------------------------------------------------------+
+		// |  CArcTraceSpan Class                                                                                |
+		// +-----------------------------------------------------------------------------------------------------+
+
+		/** @class CArcTraceSpan
+		 *  Records a span from construction ( or begin() ) until destruction ( or end() ). The span is only
+		 *  timed if tracing is enabled when it begins.
+		 */
+		class GEN3_CARCBASE_API CArcTraceSpan
+		{
+			public:
+
+				/** Constructor. Creates an inactive span; use begin() to start it.
+				 */
+				CArcTraceSpan( void ) : m_pszName( nullptr ), m_pszCategory( nullptr ), m_u64Begin( 0 )
+				{
+				}
+
+				/** Constructor. Starts a span.
+				 *  @param pszName - The span name. Must have static storage duration ( i.e. a string literal ).
+				 *  @param pszCategory - The span category. Must have static storage duration.
+				 */
+				CArcTraceSpan( const char* pszName, const char* pszCategory ) : CArcTraceSpan()
+				{
+					begin( pszName, pszCategory );
+				}
+
+				/** Destructor. Ends the span, if active.
+				 */
+				~CArcTraceSpan( void )
+				{
+					end();
+				}
+
+				/** Ends any active span and starts a new one. Useful for timing consecutive phases.
+				 *  @param pszName - The span name. Must have static storage duration ( i.e. a string literal ).
+				 *  @param pszCategory - The span category. Must have static storage duration.
+				 */
+				void begin( const char* pszName, const char* pszCategory )
+				{
+					end();
+
+					if ( CArcTrace::isEnabled() )
+					{
+						m_pszName     = pszName;
+						m_pszCategory = pszCategory;
+						m_u64Begin    = CArcTrace::now();
+					}
+				}
+
+				/** Ends the span, if active.
+				 */
+				void end( void )
+				{
+					if ( m_pszName != nullptr )
+					{
+						CArcTrace::record( m_pszName, m_pszCategory, m_u64Begin, CArcTrace::now() );
+
+						m_pszName = nullptr;
+					}
+				}
+
+				CArcTraceSpan( const CArcTraceSpan& ) = delete;
+				CArcTraceSpan& operator=( const CArcTraceSpan& ) = delete;
+
+			private:
+
+				const char*		m_pszName;
+				const char*		m_pszCategory;
+				std::uint64_t	m_u64Begin;
+		};
+
+	}	// end gen3 namespace
+}	// end arc namespace
+
+
+#endif	// _ARC_CARCTRACE_H_
@@ -0,0 +1,337 @@
+// +------------------------------------------------------------------------------------------------------------------+
+// |  FILE:  CArcTrace.cpp                                                                                            |
+// +------------------------------------------------------------------------------------------------------------------+
+// |  PURPOSE: This file implements a lightweight timeline trace buffer.                                              |
+// |                                                                                                                  |
+// |  AUTHOR:  Caltech Optical Observatories			DATE: October 18, 2026                                        |
+// +------------------------------------------------------------------------------------------------------------------+
+#ifdef _WINDOWS
+
+	#include <windows.h>
+
+#else
+
+	#include <unistd.h>
+
+#endif
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <mutex>
+#include <chrono>
+
+#include <CArcTrace.h>
+#include <CArcBase.h>
+
+
+
+namespace arc
+{
+	namespace gen3
+	{
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// | Trace buffer                                                                                             |
+		// +----------------------------------------------------------------------------------------------------------+
+		// | The buffer is file local so that the public header does not expose the container types. Names and        |
+		// | categories are stored by pointer; they are required to have static storage duration.                    |
+		// +----------------------------------------------------------------------------------------------------------+
+		namespace
+		{
+			typedef struct ARC_TRACE_EVENT
+			{
+				const char*		pszName;
+				const char*		pszCategory;
+				std::uint64_t	u64Begin;
+				std::uint64_t	u64Duration;
+				std::uint32_t	uiThreadId;
+			} TraceEvent_t;
+
+			struct TraceBuffer_t
+			{
+				std::mutex					tMutex;
+				std::vector<TraceEvent_t>	vEvents;
+				std::uint32_t				uiNext    = 0;
+				std::uint32_t				uiCount   = 0;
+				std::uint64_t				u64Dropped = 0;
+			};
+
+			TraceBuffer_t& traceBuffer( void )
+			{
+				static TraceBuffer_t tBuffer;
+
+				return tBuffer;
+			}
+
+			const std::chrono::steady_clock::time_point& traceEpoch( void )
+			{
+				static const std::chrono::steady_clock::time_point tEpoch = std::chrono::steady_clock::now();
+
+				return tEpoch;
+			}
+
+			// Small, stable per-thread ids read better in the trace viewers than hashed std::thread::id's
+			std::uint32_t traceThreadId( void )
+			{
+				static std::atomic<std::uint32_t> uiNextId( 1 );
+
+				thread_local std::uint32_t uiThreadId = uiNextId.fetch_add( 1, std::memory_order_relaxed );
+
+				return uiThreadId;
+			}
+
+			void jsonEscape( std::ostream& os, const char* psz )
+			{
+				for ( ; psz != nullptr && *psz != '\0'; psz++ )
+				{
+					switch ( *psz )
+					{
+						case '"':  os << "\\\""; break;
+						case '\\': os << "\\\\"; break;
+						case '\n': os << "\\n";  break;
+						case '\t': os << "\\t";  break;
+						default:   os << *psz;
+					}
+				}
+			}
+		}
+
+
+		std::atomic<bool> CArcTrace::m_bEnabled( false );
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  enable                                                                                                  |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Enables or disables tracing. The trace buffer is allocated ( or re-sized and cleared ) here so that no  |
+		// |  allocation occurs while recording.                                                                      |
+		// |                                                                                                          |
+		// |  <IN> bOnOff     - 'true' to enable tracing; 'false' to disable.                                         |
+		// |  <IN> uiCapacity - The maximum number of spans to hold.                                                  |
+		// |                                                                                                          |
+		// |  Throws std::invalid_argument if the capacity is zero.                                                   |
+		// +----------------------------------------------------------------------------------------------------------+
+		void CArcTrace::enable( bool bOnOff, std::uint32_t uiCapacity )
+		{
+			if ( bOnOff )
+			{
+				if ( uiCapacity == 0 )
+				{
+					THROW_INVALID_ARGUMENT( "Trace capacity must be greater than zero." );
+				}
+
+				auto& tBuffer = traceBuffer();
+
+				std::lock_guard<std::mutex> tLock( tBuffer.tMutex );
+
+				if ( tBuffer.vEvents.size() != uiCapacity )
+				{
+					tBuffer.vEvents.assign( uiCapacity, TraceEvent_t() );
+					tBuffer.uiNext     = 0;
+					tBuffer.uiCount    = 0;
+					tBuffer.u64Dropped = 0;
+				}
+
+				traceEpoch();
+			}
+
+			m_bEnabled.store( bOnOff, std::memory_order_relaxed );
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  now                                                                                                     |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Returns the number of nanoseconds since the trace epoch.                                                |
+		// +----------------------------------------------------------------------------------------------------------+
+		std::uint64_t CArcTrace::now( void )
+		{
+			return static_cast<std::uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - traceEpoch() ).count() );
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  record                                                                                                  |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Records a completed span. Does nothing if tracing is disabled.                                          |
+		// |                                                                                                          |
+		// |  <IN> pszName     - The span name ( static storage duration ).                                           |
+		// |  <IN> pszCategory - The span category ( static storage duration ).                                       |
+		// |  <IN> u64Begin    - The span start time, as returned by now().                                           |
+		// |  <IN> u64End      - The span end time, as returned by now().                                             |
+		// +----------------------------------------------------------------------------------------------------------+
+		void CArcTrace::record( const char* pszName, const char* pszCategory, std::uint64_t u64Begin, std::uint64_t u64End )
+		{
+			if ( !isEnabled() )
+			{
+				return;
+			}
+
+			auto uiThreadId = traceThreadId();
+
+			auto& tBuffer = traceBuffer();
+
+			std::lock_guard<std::mutex> tLock( tBuffer.tMutex );
+
+			auto uiCapacity = static_cast<std::uint32_t>( tBuffer.vEvents.size() );
+
+			if ( uiCapacity == 0 )
+			{
+				return;
+			}
+
+			tBuffer.vEvents[ tBuffer.uiNext ] = { pszName, pszCategory, u64Begin, ( u64End > u64Begin ? u64End - u64Begin : 0 ), uiThreadId };
+
+			tBuffer.uiNext = ( tBuffer.uiNext + 1 ) % uiCapacity;
+
+			if ( tBuffer.uiCount < uiCapacity )
+			{
+				tBuffer.uiCount++;
+			}
+			else
+			{
+				tBuffer.u64Dropped++;
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  clear                                                                                                   |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Discards all recorded spans and resets the dropped span count.                                          |
+		// +----------------------------------------------------------------------------------------------------------+
+		void CArcTrace::clear( void )
+		{
+			auto& tBuffer = traceBuffer();
+
+			std::lock_guard<std::mutex> tLock( tBuffer.tMutex );
+
+			tBuffer.uiNext     = 0;
+			tBuffer.uiCount    = 0;
+			tBuffer.u64Dropped = 0;
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  count                                                                                                   |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Returns the number of spans currently held by the trace buffer.                                         |
+		// +----------------------------------------------------------------------------------------------------------+
+		std::uint32_t CArcTrace::count( void )
+		{
+			auto& tBuffer = traceBuffer();
+
+			std::lock_guard<std::mutex> tLock( tBuffer.tMutex );
+
+			return tBuffer.uiCount;
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  dropped                                                                                                 |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Returns the number of spans overwritten because the trace buffer was full.                              |
+		// +----------------------------------------------------------------------------------------------------------+
+		std::uint64_t CArcTrace::dropped( void )
+		{
+			auto& tBuffer = traceBuffer();
+
+			std::lock_guard<std::mutex> tLock( tBuffer.tMutex );
+
+			return tBuffer.u64Dropped;
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  toJSON                                                                                                  |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Returns the recorded spans, oldest first, as a Chrome trace event format document. Each span is a       |
+		// |  complete ( "ph":"X" ) event with microsecond timestamps.                                                |
+		// +----------------------------------------------------------------------------------------------------------+
+		std::string CArcTrace::toJSON( void )
+		{
+			std::vector<TraceEvent_t> vEvents;
+			std::uint64_t u64Dropped = 0;
+
+			{
+				auto& tBuffer = traceBuffer();
+
+				std::lock_guard<std::mutex> tLock( tBuffer.tMutex );
+
+				auto uiCapacity = static_cast<std::uint32_t>( tBuffer.vEvents.size() );
+				auto uiFirst    = ( tBuffer.uiCount < uiCapacity ? 0 : tBuffer.uiNext );
+
+				vEvents.reserve( tBuffer.uiCount );
+
+				for ( std::uint32_t i = 0; i < tBuffer.uiCount; i++ )
+				{
+					vEvents.push_back( tBuffer.vEvents[ ( uiFirst + i ) % uiCapacity ] );
+				}
+
+				u64Dropped = tBuffer.u64Dropped;
+			}
+
+			#ifdef _WINDOWS
+				auto uiProcessId = static_cast<std::uint32_t>( GetCurrentProcessId() );
+			#else
+				auto uiProcessId = static_cast<std::uint32_t>( getpid() );
+			#endif
+
+			std::ostringstream oss;
+
+			oss << std::fixed << std::setprecision( 3 );
+
+			oss << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped\":" << u64Dropped << "},\"traceEvents\":[";
+
+			for ( std::size_t i = 0; i < vEvents.size(); i++ )
+			{
+				oss << ( i > 0 ? ",\n" : "\n" ) << "{\"name\":\"";
+
+				jsonEscape( oss, vEvents[ i ].pszName );
+
+				oss << "\",\"cat\":\"";
+
+				jsonEscape( oss, vEvents[ i ].pszCategory );
+
+				oss << "\",\"ph\":\"X\",\"ts\":" << ( vEvents[ i ].u64Begin / 1000.0 )
+					<< ",\"dur\":" << ( vEvents[ i ].u64Duration / 1000.0 )
+					<< ",\"pid\":" << uiProcessId
+					<< ",\"tid\":" << vEvents[ i ].uiThreadId << "}";
+			}
+
+			oss << "\n]}\n";
+
+			return oss.str();
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  exportJSON                                                                                              |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Writes the recorded spans to the specified file in the Chrome trace event format.                       |
+		// |                                                                                                          |
+		// |  <IN> sFilename - The output file path.                                                                  |
+		// |                                                                                                          |
+		// |  Throws std::runtime_error on error.                                                                     |
+		// +----------------------------------------------------------------------------------------------------------+
+		void CArcTrace::exportJSON( const std::string& sFilename )
+		{
+			std::ofstream ofs( sFilename.c_str() );
+
+			if ( !ofs.is_open() )
+			{
+				THROW( "Failed to open trace file: %s", sFilename.c_str() );
+			}
+
+			ofs << toJSON();
+
+			if ( !ofs.good() )
+			{
+				THROW( "Failed to write trace file: %s", sFilename.c_str() );
+			}
+		}
+
+	}	// end gen3 namespace
+}	// end arc namespace
@@ -6,17 +6,26 @@
 CPP_SRCS += \
 ../src/ArcDeinterlaceCAPI.cpp \
 ../src/CArcDeinterlace.cpp \
-../src/CArcDeinterlaceDllMain.cpp 
+../src/CArcDeinterlaceDllMain.cpp \
+../src/CArcDLaceGeometry.cpp \
+../src/CArcDLaceSimd.cpp \
+../src/IArcPluginV2.cpp 
 
 OBJS += \
 ./src/ArcDeinterlaceCAPI.o \
 ./src/CArcDeinterlace.o \
-./src/CArcDeinterlaceDllMain.o 
+./src/CArcDeinterlaceDllMain.o \
+./src/CArcDLaceGeometry.o \
+./src/CArcDLaceSimd.o \
+./src/IArcPluginV2.o 
 
 CPP_DEPS += \
 ./src/ArcDeinterlaceCAPI.d \
 ./src/CArcDeinterlace.d \
-./src/CArcDeinterlaceDllMain.d 
+./src/CArcDeinterlaceDllMain.d \
+./src/CArcDLaceGeometry.d \
+./src/CArcDLaceSimd.d \
+./src/IArcPluginV2.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
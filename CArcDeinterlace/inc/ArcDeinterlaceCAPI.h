@@ -112,6 +112,41 @@ extern "C" {		// Using a C++ compiler
 	GEN3_CARCDEINTERLACE_API void ArcDLace_run( unsigned long long ulHandle, void* pBuf, unsigned int uiCols, unsigned int uiRows,
 		unsigned int uiAlg, unsigned int uiArg, ArcStatus_t* pStatus );
 
+	/** Deinterlaces the source image buffer into a destination buffer, without an intermediate copy.
+	 *  @param ulHandle	- A reference to a deinterlace object.
+	 *  @param pSrc		- The image buffer data.
+	 *  @param pDst		- The buffer to receive the deinterlaced image. Must not overlap pSrc, unless equal to it.
+	 *  @param uiCols	- The number of columns in the image.
+	 *  @param uiRows	- The number of rows in the image.
+	 *  @param uiAlg	- The deinterlace algorithm.
+	 *  @param uiArg	- An algorithm dependent argument. Use DLACE_NO_ARG if not needed.
+	 *  @param pStatus	- Success state; equals ARC_STATUS_OK or ARC_STATUS_ERROR.
+	 */
+	GEN3_CARCDEINTERLACE_API void ArcDLace_runTo( unsigned long long ulHandle, const void* pSrc, void* pDst, unsigned int uiCols, unsigned int uiRows,
+		unsigned int uiAlg, unsigned int uiArg, ArcStatus_t* pStatus );
+
+	/** Deinterlaces a stack of contiguous frames, such as a continuous readout buffer, splitting whole frames
+	 *  across the deinterlace threads.
+	 *  @param ulHandle	- A reference to a deinterlace object.
+	 *  @param pSrc		- The frames.
+	 *  @param pDst		- The buffer to receive the deinterlaced frames. Must not overlap pSrc, unless equal to it.
+	 *  @param uiCols	- The number of columns in each frame.
+	 *  @param uiRows	- The number of rows in each frame.
+	 *  @param uiFrames	- The number of frames.
+	 *  @param uiAlg	- The deinterlace algorithm.
+	 *  @param uiArg	- An algorithm dependent argument. Use DLACE_NO_ARG if not needed.
+	 *  @param pStatus	- Success state; equals ARC_STATUS_OK or ARC_STATUS_ERROR.
+	 */
+	GEN3_CARCDEINTERLACE_API void ArcDLace_runFrames( unsigned long long ulHandle, const void* pSrc, void* pDst, unsigned int uiCols, unsigned int uiRows,
+		unsigned int uiFrames, unsigned int uiAlg, unsigned int uiArg, ArcStatus_t* pStatus );
+
+	/** Sets the number of threads the built-in deinterlace algorithms may use.
+	 *  @param ulHandle	- A reference to a deinterlace object.
+	 *  @param uiCount	- The thread count; 0 uses one thread per hardware thread.
+	 *  @param pStatus	- Success state; equals ARC_STATUS_OK or ARC_STATUS_ERROR.
+	 */
+	GEN3_CARCDEINTERLACE_API void ArcDLace_setThreadCount( unsigned long long ulHandle, unsigned int uiCount, ArcStatus_t* pStatus );
+
 	/** Returns the last reported error message.
 	 *  @return The last error message.
 	 */
@@ -0,0 +1,166 @@
+// +------------------------------------------------------------------------------------------------------------------+
+// |  FILE:  CArcDLaceGeometry.h  ( Gen3 )                                                                            |
+// +------------------------------------------------------------------------------------------------------------------+
+// |  PURPOSE: This file defines the readout geometry descriptor, which describes a detector layout as data, and the  |
+// |           copy plan CArcDeinterlace builds from it. New layouts can be deinterlaced without writing code.        |
+// +------------------------------------------------------------------------------------------------------------------+
+
+#ifndef _GEN3_CARCDLACEGEOMETRY_H_
+#define _GEN3_CARCDLACEGEOMETRY_H_
+
+#ifdef _WINDOWS
+	#pragma warning( disable: 4251 )
+#endif
+
+#include <cstdint>
+#include <vector>
+
+#include <CArcDeinterlaceDllMain.h>
+
+
+
+namespace arc
+{
+	namespace gen3
+	{
+
+		namespace dlace
+		{
+
+			/** Defined in CArcDeinterlace.h */
+			enum class e_Alg : std::uint32_t;
+
+
+			/** Maximum number of amplifiers in a geometry */
+			const std::uint32_t MAX_AMPLIFIERS = 64;
+
+
+			/** @enum e_Corner
+			 *  Defines the tile corner an amplifier starts reading from. Each line is read horizontally away from the
+			 *  corner, and successive lines move vertically away from it. Row 0 is the start of the image buffer and
+			 *  is at the bottom.
+			 */
+			enum class e_Corner : std::uint32_t
+			{
+				BOTTOM_LEFT = 0,
+				BOTTOM_RIGHT,
+				TOP_LEFT,
+				TOP_RIGHT
+			};
+
+
+			/** @struct Amplifier
+			 *  One amplifier ( readout channel ) of a geometry.
+			 */
+			struct Amplifier
+			{
+				/** Tile column, 0 = left */
+				std::uint32_t uiTileCol;
+
+				/** Tile row, 0 = bottom */
+				std::uint32_t uiTileRow;
+
+				/** Corner the readout starts from */
+				e_Corner eCorner;
+			};
+
+
+			/** @struct Geometry
+			 *  Readout geometry descriptor. The image is split into uiGridCols x uiGridRows equal tiles, one per
+			 *  amplifier. All amplifiers read one line of their tile at the same time and the raw stream holds one
+			 *  pixel from each in turn, in vAmps order. Each line starts with uiPrescan and ends with uiOverscan
+			 *  pixels, which are dropped, so the image is outputCols() wide. If uiFrames > 1 the raw stream holds
+			 *  that many frames one after another ( e.g. CDS reset and signal frames ), which are stacked upwards.
+			 */
+			struct GEN3_CARCDEINTERLACE_API Geometry
+			{
+				/** Number of tile columns */
+				std::uint32_t uiGridCols = 1;
+
+				/** Number of tile rows */
+				std::uint32_t uiGridRows = 1;
+
+				/** The amplifiers, in raw interleave order. One per tile. */
+				std::vector<Amplifier> vAmps;
+
+				/** Serial prescan pixels at the start of each line */
+				std::uint32_t uiPrescan = 0;
+
+				/** Serial overscan pixels at the end of each line */
+				std::uint32_t uiOverscan = 0;
+
+				/** Number of frames in the raw stream */
+				std::uint32_t uiFrames = 1;
+
+				/** Returns the width of the deinterlaced image.
+				 *  @param uiCols - The raw image width.
+				 *  @return The raw width less the prescan and overscan columns.
+				 */
+				std::uint32_t outputCols( std::uint32_t uiCols ) const;
+
+				/** Compares two geometries.
+				 *  @param tGeometry - The geometry to compare with.
+				 *  @return true if the geometries are the same.
+				 */
+				bool operator==( const Geometry& tGeometry ) const;
+			};
+
+
+			/** @struct Plan
+			 *  A copy plan: a geometry resolved for one image size into a list of steps, each of which de-interleaves
+			 *  a run of raw groups into one output run per amplifier. Consecutive lines that continue the same output
+			 *  runs are merged into one step.
+			 */
+			struct GEN3_CARCDEINTERLACE_API Plan
+			{
+				/** The geometry the plan was built for */
+				Geometry tGeometry;
+
+				/** The raw image width */
+				std::uint32_t uiCols;
+
+				/** The raw image height */
+				std::uint32_t uiRows;
+
+				/** The number of output pixels ( outputCols() x uiRows ) */
+				std::uint64_t u64Pixels;
+
+				/** Bit k set: amplifier k writes backwards */
+				std::uint64_t u64Reverse;
+
+				/** Per step: raw offset of the first group */
+				std::vector<std::uint64_t> vSrc;
+
+				/** Per step: output offset of the first pixel of each amplifier ( vAmps.size() entries ) */
+				std::vector<std::uint64_t> vDst;
+
+				/** Per step: number of groups */
+				std::vector<std::uint64_t> vGroups;
+			};
+
+
+			/** Builds the copy plan for a geometry and raw image size.
+			 *  @param tGeometry - The geometry.
+			 *  @param uiCols	 - The raw image width.
+			 *  @param uiRows	 - The raw image height.
+			 *  @return The plan.
+			 *  @throws std::invalid_argument if the geometry is invalid or does not fit the image size.
+			 */
+			GEN3_CARCDEINTERLACE_API Plan makePlan( const Geometry& tGeometry, std::uint32_t uiCols, std::uint32_t uiRows );
+
+			/** Returns the predefined geometry for a built-in algorithm. Deinterlacing with it gives the same image as
+			 *  the algorithm, for image sizes that divide evenly into its tiles.
+			 *  @param eAlg	  - The algorithm. CUSTOM has no geometry.
+			 *  @param uiArg  - The channel count, for HAWAII_RG ( 1, or EVEN up to MAX_AMPLIFIERS ).
+			 *  @return The geometry.
+			 *  @throws std::invalid_argument if the algorithm has no geometry.
+			 */
+			GEN3_CARCDEINTERLACE_API Geometry geometry( arc::gen3::dlace::e_Alg eAlg, std::uint32_t uiArg = 0 );
+
+		}	// end dlace namespace
+
+	}		// end gen3 namespace
+}			// end arc namespace
+
+
+#endif		// _GEN3_CARCDLACEGEOMETRY_H_
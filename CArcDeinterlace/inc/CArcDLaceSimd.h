@@ -0,0 +1,97 @@
+// +------------------------------------------------------------------------------------------------------------------+
+// |  FILE:  CArcDLaceSimd.h  ( Gen3 )                                                                                |
+// +------------------------------------------------------------------------------------------------------------------+
+// |  PURPOSE: This file defines the de-interleave kernels used by the built-in deinterlace algorithms, with SSE2,    |
+// |           AVX2 and AVX-512 implementations selected at run time.                                                 |
+// +------------------------------------------------------------------------------------------------------------------+
+
+#ifndef _GEN3_CARCDLACESIMD_H_
+#define _GEN3_CARCDLACESIMD_H_
+
+#include <cstdint>
+
+#include <CArcDeinterlace.h>
+
+
+
+namespace arc
+{
+	namespace gen3
+	{
+
+		namespace dlace
+		{
+
+			/** De-interleave kernel. Splits a raw stream of N-pixel groups into N output streams: pixel k of group g
+			 *  is written to ppDst[ k ][ g ], or to ppDst[ k ][ -g ] if bit k of u64Reverse is set, in which case
+			 *  ppDst[ k ] points at the last pixel of the stream. The output streams must not overlap the input.
+			 *  @param pSrc		  - The raw pixels ( N x u64Groups ).
+			 *  @param ppDst	  - The N output stream pointers.
+			 *  @param u64Reverse - Bit k set writes stream k backwards.
+			 *  @param u64Groups  - The number of N-pixel groups.
+			 */
+			template <typename T> using DLaceKernel_t = void ( * )( const T* pSrc, T* const* ppDst, std::uint64_t u64Reverse, std::uint64_t u64Groups );
+
+
+			/** @struct SimdKernels
+			 *  The de-interleave kernels for one instruction set.
+			 */
+			template <typename T> struct SimdKernels
+			{
+				/** 1-way: single amplifier geometries */
+				DLaceKernel_t<T> split1;
+
+				/** 2-way: parallel, serial, hawaiiRG */
+				DLaceKernel_t<T> split2;
+
+				/** 4-way: quadCCD, quadIR, quadIRCDS, hawaiiRG */
+				DLaceKernel_t<T> split4;
+
+				/** 8-way: eight amplifier geometries, hawaiiRG */
+				DLaceKernel_t<T> split8;
+
+				/** 16-way: sta1600, hawaiiRG */
+				DLaceKernel_t<T> split16;
+
+				/** 32-way: hawaiiRG ( H2RG ) */
+				DLaceKernel_t<T> split32;
+
+				/** 64-way: hawaiiRG ( H4RG ) */
+				DLaceKernel_t<T> split64;
+			};
+
+
+			/** Returns the kernels for an instruction set. All instruction sets produce identical output.
+			 *  @param eSimd - The instruction set. Must not exceed simdSupported().
+			 *  @return The kernel table.
+			 */
+			template <typename T> const SimdKernels<T>& simdKernels( arc::gen3::dlace::e_Simd eSimd );
+
+			/** Returns the kernel for a stream count.
+			 *  @param eSimd	 - The instruction set. Must not exceed simdSupported().
+			 *  @param uiStreams - The number of streams.
+			 *  @return The kernel, or nullptr if there is none for the stream count; use deinterleave() instead.
+			 */
+			template <typename T> DLaceKernel_t<T> simdKernel( arc::gen3::dlace::e_Simd eSimd, std::uint32_t uiStreams );
+
+			/** Scalar de-interleave for any stream count. Same as DLaceKernel_t, with the stream count passed in.
+			 *  @param pSrc		  - The raw pixels ( uiStreams x u64Groups ).
+			 *  @param ppDst	  - The uiStreams output stream pointers.
+			 *  @param uiStreams  - The number of streams ( 1 - MAX_AMPLIFIERS ).
+			 *  @param u64Reverse - Bit k set writes stream k backwards.
+			 *  @param u64Groups  - The number of groups.
+			 */
+			template <typename T> void deinterleave( const T* pSrc, T* const* ppDst, std::uint32_t uiStreams, std::uint64_t u64Reverse, std::uint64_t u64Groups );
+
+			/** Returns the best instruction set supported by the CPU and operating system ( CPUID ).
+			 *  @return The instruction set.
+			 */
+			arc::gen3::dlace::e_Simd simdSupported( void );
+
+		}	// end dlace namespace
+
+	}		// end gen3 namespace
+}			// end arc namespace
+
+
+#endif		// _GEN3_CARCDLACESIMD_H_
@@ -24,6 +24,7 @@
 #include <vector>
 
 #include <CArcDeinterlaceDllMain.h>
+#include <CArcDLaceGeometry.h>
 #include <CArcPluginManager.h>
 #include <CArcBase.h>
 
@@ -62,6 +63,36 @@ namespace arc
 				CUSTOM
 			};
 
+
+			/** @enum e_Simd
+			*  Defines the instruction sets the built-in deinterlace algorithms can use.
+			*/
+			enum class e_Simd : std::uint32_t
+			{
+				SCALAR = 0,
+				SSE2,
+				AVX2,
+				AVX512
+			};
+
+
+			/** @struct FrameStack
+			 *  Describes a batch of frames of the same size stored in one buffer, such as the frames of a continuous
+			 *  readout buffer or the planes of a FITS cube. A stride of 0 means the frames follow one another with
+			 *  no gap.
+			 */
+			struct FrameStack
+			{
+				/** The number of frames */
+				std::uint32_t uiFrames = 1;
+
+				/** Pixels from the start of one raw frame to the next ( 0 = uiCols x uiRows ) */
+				std::uint64_t u64SrcStride = 0;
+
+				/** Pixels from the start of one deinterlaced frame to the next ( 0 = the deinterlaced frame size ) */
+				std::uint64_t u64DstStride = 0;
+			};
+
 		}	// end dlace namespace
 
 
@@ -98,6 +129,43 @@ namespace arc
 			 */
 			void run( T* pBuf, std::uint32_t uiCols, std::uint32_t uiRows, arc::gen3::dlace::e_Alg eAlg, const std::initializer_list<std::uint32_t>& tArgList = {} );
 
+			/** Deinterlace the source buffer data into a destination buffer using the specified algorithm. Unlike the
+			 *  in-place run(), the algorithm writes directly to the destination, so no intermediate copy is made.
+			 *  @param pSrc		- Pointer to the buffer to deinterlace.
+			 *  @param pDst		- Pointer to the buffer to receive the deinterlaced image ( uiCols x uiRows pixels ). Must
+			 *					  not overlap pSrc, unless it is the same buffer, in which case the in-place run() is used.
+			 *  @param uiCols	- The number of columns in the buffer.
+			 *  @param uiRows	- The number of rows in the buffer.
+			 *  @param eAlg		- The algorithm to use to deinterlace the buffer.
+			 *  @param tArgList	- A reference to a list of algorithm dependent arguments ( default = {}, empty list ).
+			 *  @see CArcDeinterlace::e_Alg
+			 *  @throws std::exception on error.
+			 */
+			void run( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows, arc::gen3::dlace::e_Alg eAlg, const std::initializer_list<std::uint32_t>& tArgList = {} );
+
+			/** Deinterlace the buffer data using a readout geometry. The copy plan for the geometry and image size is
+			 *  built on first use and cached.
+			 *  @param pBuf		 - Pointer to the buffer to deinterlace. Receives geometry.outputCols( uiCols ) x uiRows pixels.
+			 *  @param uiCols	 - The number of columns in the buffer.
+			 *  @param uiRows	 - The number of rows in the buffer.
+			 *  @param tGeometry - The readout geometry.
+			 *  @see arc::gen3::dlace::Geometry
+			 *  @throws std::exception on error.
+			 */
+			void run( T* pBuf, std::uint32_t uiCols, std::uint32_t uiRows, const arc::gen3::dlace::Geometry& tGeometry );
+
+			/** Deinterlace the source buffer data into a destination buffer using a readout geometry.
+			 *  @param pSrc		 - Pointer to the buffer to deinterlace.
+			 *  @param pDst		 - Pointer to the buffer to receive the deinterlaced image ( geometry.outputCols( uiCols )
+			 *					   x uiRows pixels ). Must not overlap pSrc, unless it is the same buffer.
+			 *  @param uiCols	 - The number of columns in the buffer.
+			 *  @param uiRows	 - The number of rows in the buffer.
+			 *  @param tGeometry - The readout geometry.
+			 *  @see arc::gen3::dlace::Geometry
+			 *  @throws std::exception on error.
+			 */
+			void run( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows, const arc::gen3::dlace::Geometry& tGeometry );
+
 			/** Deinterlace the buffer data using a custom algorithm loaded through the plugin manager.
 			 *  @param pBuf		- Pointer to the buffer to deinterlace.
 			 *  @param uiCols	- The number of columns in the buffer.
@@ -108,7 +176,86 @@ namespace arc
 			 */
 			void run( T* pBuf, std::uint32_t uiCols, std::uint32_t uiRows, const std::string& sAlg, const std::initializer_list<std::uint32_t>& tArgList = {} );
 
-			/** Returns the deinterlace plugin manager.
+			/** Deinterlace the buffer data using a plugin algorithm resolved by findAlgorithm().
+			 *  @param pBuf		- Pointer to the buffer to deinterlace.
+			 *  @param uiCols	- The number of columns in the buffer.
+			 *  @param uiRows	- The number of rows in the buffer.
+			 *  @param tAlg		- The plugin algorithm.
+			 *  @param tArgList	- A reference to a list of algorithm dependent arguments ( default = {}, empty list ).
+			 *  @throws std::exception on error.
+			 */
+			void run( T* pBuf, std::uint32_t uiCols, std::uint32_t uiRows, const arc::gen3::PluginAlg_t& tAlg, const std::initializer_list<std::uint32_t>& tArgList = {} );
+
+			/** Deinterlace the source buffer data into a destination buffer using a plugin algorithm resolved by
+			 *  findAlgorithm().
+			 *  @param pSrc		- Pointer to the buffer to deinterlace.
+			 *  @param pDst		- Pointer to the buffer to receive the deinterlaced image ( uiCols x uiRows pixels ). Must
+			 *					  not overlap pSrc, unless it is the same buffer, in which case the in-place run() is used.
+			 *  @param uiCols	- The number of columns in the buffer.
+			 *  @param uiRows	- The number of rows in the buffer.
+			 *  @param tAlg		- The plugin algorithm.
+			 *  @param tArgList	- A reference to a list of algorithm dependent arguments ( default = {}, empty list ).
+			 *  @throws std::exception on error.
+			 */
+			void run( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows, const arc::gen3::PluginAlg_t& tAlg, const std::initializer_list<std::uint32_t>& tArgList = {} );
+
+			/** Deinterlace a stack of frames using the specified algorithm. The arguments are checked once and, if there
+			 *  are at least as many frames as deinterlace threads, whole frames are split across the threads; fewer
+			 *  frames are deinterlaced in turn, each split across the threads. The output is identical to calling the
+			 *  single frame run() on each frame.
+			 *  @param pSrc		- Pointer to the frames to deinterlace.
+			 *  @param pDst		- Pointer to the buffer to receive the deinterlaced frames. Must not overlap pSrc, unless
+			 *					  it is the same buffer, in which case each frame is deinterlaced in place and the
+			 *					  destination stride must equal the source stride.
+			 *  @param uiCols	- The number of columns in each frame.
+			 *  @param uiRows	- The number of rows in each frame.
+			 *  @param tStack	- The frame count and strides.
+			 *  @param eAlg		- The algorithm to use to deinterlace the frames.
+			 *  @param tArgList	- A reference to a list of algorithm dependent arguments ( default = {}, empty list ).
+			 *  @see arc::gen3::dlace::FrameStack
+			 *  @throws std::exception on error.
+			 */
+			void run( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows, const arc::gen3::dlace::FrameStack& tStack, arc::gen3::dlace::e_Alg eAlg, const std::initializer_list<std::uint32_t>& tArgList = {} );
+
+			/** Deinterlace a stack of frames using a readout geometry. The copy plan is looked up once for the whole
+			 *  stack. Frames are split across the threads as for the algorithm stack run().
+			 *  @param pSrc		 - Pointer to the frames to deinterlace.
+			 *  @param pDst		 - Pointer to the buffer to receive the deinterlaced frames, each geometry.outputCols(
+			 *					   uiCols ) x uiRows pixels. Must not overlap pSrc, unless it is the same buffer.
+			 *  @param uiCols	 - The number of columns in each frame.
+			 *  @param uiRows	 - The number of rows in each frame.
+			 *  @param tStack	 - The frame count and strides.
+			 *  @param tGeometry - The readout geometry.
+			 *  @see arc::gen3::dlace::FrameStack
+			 *  @throws std::exception on error.
+			 */
+			void run( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows, const arc::gen3::dlace::FrameStack& tStack, const arc::gen3::dlace::Geometry& tGeometry );
+
+			/** Deinterlace a stack of frames using a plugin algorithm resolved by findAlgorithm(). Contiguous frames
+			 *  are passed to the plugin in one call. Frames are only split across the threads if the algorithm has
+			 *  the PLUGIN_THREAD_SAFE capability.
+			 *  @param pSrc		- Pointer to the frames to deinterlace.
+			 *  @param pDst		- Pointer to the buffer to receive the deinterlaced frames. Must not overlap pSrc, unless
+			 *					  it is the same buffer.
+			 *  @param uiCols	- The number of columns in each frame.
+			 *  @param uiRows	- The number of rows in each frame.
+			 *  @param tStack	- The frame count and strides.
+			 *  @param tAlg		- The plugin algorithm.
+			 *  @param tArgList	- A reference to a list of algorithm dependent arguments ( default = {}, empty list ).
+			 *  @see arc::gen3::dlace::FrameStack
+			 *  @throws std::exception on error.
+			 */
+			void run( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows, const arc::gen3::dlace::FrameStack& tStack, const arc::gen3::PluginAlg_t& tAlg, const std::initializer_list<std::uint32_t>& tArgList = {} );
+
+			/** Resolves a plugin algorithm name with a single hash lookup, for the run() methods that take a
+			 *  PluginAlg_t. The result stays valid while the plugins are loaded.
+			 *  @param sAlg - The algorithm name.
+			 *  @return The plugin algorithm.
+			 *  @throws std::runtime_error if no plugin is loaded or none has the algorithm.
+			 */
+			static const arc::gen3::PluginAlg_t& findAlgorithm( const std::string& sAlg );
+
+			/** Returns the deinterlace plugin manager. It is created on first use and shared by all instances.
 			 *  @return The plugin manager.
 			 */
 			static arc::gen3::CArcPluginManager* getPluginManager( void );
@@ -118,6 +265,41 @@ namespace arc
 			 */
 			std::uint32_t maxTVal( void );
 
+			/** Sets the number of threads the built-in deinterlace algorithms may use. The output is identical for
+			 *  any thread count. Small images use fewer threads. More threads than the host has hardware threads
+			 *  only add overhead.
+			 *  @param uiCount - The thread count; 0 uses one thread per hardware thread ( default = 1 ).
+			 */
+			void setThreadCount( std::uint32_t uiCount );
+
+			/** Returns the number of threads the built-in deinterlace algorithms may use.
+			 *  @return The thread count.
+			 */
+			std::uint32_t getThreadCount( void );
+
+			/** Sets the instruction set used by the built-in deinterlace algorithms. The default is the best one
+			 *  supported by the CPU. All instruction sets produce identical output.
+			 *  @param eSimd - The instruction set.
+			 *  @throws std::invalid_argument if the CPU does not support the instruction set.
+			 */
+			void setSimd( arc::gen3::dlace::e_Simd eSimd );
+
+			/** Returns the instruction set used by the built-in deinterlace algorithms.
+			 *  @return The instruction set.
+			 */
+			arc::gen3::dlace::e_Simd getSimd( void );
+
+			/** Returns the best instruction set supported by the CPU.
+			 *  @return The instruction set.
+			 */
+			static arc::gen3::dlace::e_Simd supportedSimd( void );
+
+			/** Minimum number of pixels given to each deinterlace thread */
+			static const std::uint32_t MIN_THREAD_PIXELS = ( 256 * 1024 );
+
+			/** Number of geometry copy plans kept */
+			static const std::uint32_t PLAN_CACHE_SIZE = 8;
+
 		protected:
 
 			///** Intermediate buffer deleter.
@@ -125,62 +307,124 @@ namespace arc
 			// */
 			//template<typename T> static void arrayDeleter( T* p );
 
+			/** Runs the specified algorithm from the source buffer into the destination buffer.
+			 *  @param pSrc		- Pointer to the buffer data to deinterlace.
+			 *  @param pDst		- Pointer to the buffer to receive the deinterlaced data. Must not overlap pSrc.
+			 *  @param uiCols	- The number of columns in the buffer.
+			 *  @param uiRows	- The number of rows in the buffer.
+			 *  @param eAlg		- The algorithm to use to deinterlace the buffer.
+			 *  @param tArgList	- A reference to a list of algorithm dependent arguments.
+			 *  @throws std::exception on error.
+			 */
+			void deinterlace( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows, arc::gen3::dlace::e_Alg eAlg, const std::initializer_list<std::uint32_t>& tArgList );
+
+			/** Runs a geometry copy plan from the source buffer into the destination buffer.
+			 *  @param pSrc		- Pointer to the buffer data to deinterlace.
+			 *  @param pDst		- Pointer to the buffer to receive the deinterlaced data. Must not overlap pSrc.
+			 *  @param tPlan	- The copy plan.
+			 */
+			void deinterlace( const T* pSrc, T* pDst, const arc::gen3::dlace::Plan& tPlan );
+
+			/** Returns the copy plan for a geometry and image size, from the cache or newly built.
+			 *  @param tGeometry - The readout geometry.
+			 *  @param uiCols	 - The number of columns in the buffer.
+			 *  @param uiRows	 - The number of rows in the buffer.
+			 *  @return The plan. Valid until the next call.
+			 *  @throws std::invalid_argument if the geometry does not fit the image size.
+			 */
+			const arc::gen3::dlace::Plan& plan( const arc::gen3::dlace::Geometry& tGeometry, std::uint32_t uiCols, std::uint32_t uiRows );
+
+			/** Makes sure the intermediate buffer can hold an image.
+			 *  @param uiCols - The number of columns in the image.
+			 *  @param uiRows - The number of rows in the image.
+			 *  @throws std::exception if the buffer cannot be allocated.
+			 */
+			void reserveNewData( std::uint32_t uiCols, std::uint32_t uiRows );
+
+			/** Runs an algorithm kernel over a set of independent output blocks, split across the deinterlace threads.
+			 *  @param u64Pixels - The number of pixels the kernel moves in total.
+			 *  @param uiBlocks	 - The number of blocks.
+			 *  @param fnKernel	 - The kernel, called as fnKernel( uiFirstBlock, uiLastBlock ), last exclusive.
+			 *  @throws std::exception thrown by the kernel on any thread, once all the threads have finished.
+			 */
+			template <typename F> void partition( std::uint64_t u64Pixels, std::uint32_t uiBlocks, F fnKernel );
+
+			/** Runs a single frame kernel over a stack of frames, in place or from one buffer into another.
+			 *  @param pSrc			- Pointer to the frames to deinterlace.
+			 *  @param pDst			- Pointer to the buffer to receive the deinterlaced frames, or pSrc.
+			 *  @param uiCols		- The number of columns in each frame.
+			 *  @param uiRows		- The number of rows in each frame.
+			 *  @param tStack		- The frame count and strides.
+			 *  @param u64DstPixels	- The number of pixels in each deinterlaced frame.
+			 *  @param uiCaps		- The kernel capabilities, dlace::PLUGIN_THREAD_SAFE and dlace::PLUGIN_IN_PLACE.
+			 *  @param fnFrame		- The kernel, called as fnFrame( pFrameSrc, pFrameDst ).
+			 *  @throws std::exception on error, including any thrown by the kernel.
+			 */
+			template <typename F> void runFrames( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows, const arc::gen3::dlace::FrameStack& tStack, std::uint64_t u64DstPixels, std::uint32_t uiCaps, F fnFrame );
+
 			/** Parallel deinterlace algorithm.
-			 *  @param pBuf   - Pointer to the buffer data to deinterlace.
+			 *  @param pSrc   - Pointer to the buffer data to deinterlace.
+			 *  @param pDst   - Pointer to the buffer to receive the deinterlaced data. Must not overlap pSrc.
 			 *  @param uiCols - The number of columns in the buffer.
 			 *  @param uiRows - The number of rows in the buffer.
 			 *  @throws std::exception on error.
 			 */
-			void parallel( T* pBuf, std::uint32_t uiCols, std::uint32_t uiRows );
+			void parallel( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows );
 
 			/** Serial deinterlace algorithm.
-			 *  @param pBuf   - Pointer to the buffer data to deinterlace.
+			 *  @param pSrc   - Pointer to the buffer data to deinterlace.
+			 *  @param pDst   - Pointer to the buffer to receive the deinterlaced data. Must not overlap pSrc.
 			 *  @param uiCols - The number of columns in the buffer.
 			 *  @param uiRows - The number of rows in the buffer.
 			 *  @throws std::exception on error.
 			 */
-			void serial( T* pBuf, std::uint32_t uiCols, std::uint32_t uiRows );
+			void serial( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows );
 
 			/** Quad CCD deinterlace algorithm.
-			 *  @param pBuf   - Pointer to the buffer data to deinterlace.
+			 *  @param pSrc   - Pointer to the buffer data to deinterlace.
+			 *  @param pDst   - Pointer to the buffer to receive the deinterlaced data. Must not overlap pSrc.
 			 *  @param uiCols - The number of columns in the buffer.
 			 *  @param uiRows - The number of rows in the buffer.
 			 *  @throws std::exception on error.
 			 */
-			void quadCCD( T* pBuf, std::uint32_t uiCols, std::uint32_t uiRows );
+			void quadCCD( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows );
 
 			/** Quad IR deinterlace algorithm.
-			 *  @param pBuf   - Pointer to the buffer data to deinterlace.
+			 *  @param pSrc   - Pointer to the buffer data to deinterlace.
+			 *  @param pDst   - Pointer to the buffer to receive the deinterlaced data. Must not overlap pSrc.
 			 *  @param uiCols - The number of columns in the buffer.
 			 *  @param uiRows - The number of rows in the buffer.
 			 *  @throws std::exception on error.
 			 */
-			void quadIR( T* pBuf, std::uint32_t uiCols, std::uint32_t uiRows );
+			void quadIR( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows );
 
 			/** Quad IR CDS ( correlated double sampling ) deinterlace algorithm.
-			 *  @param pBuf   - Pointer to the buffer data to deinterlace.
+			 *  @param pSrc   - Pointer to the buffer data to deinterlace.
+			 *  @param pDst   - Pointer to the buffer to receive the deinterlaced data. Must not overlap pSrc.
 			 *  @param uiCols - The number of columns in the buffer.
-			 *  @param uiRows - The number of rows in the buffer.
+			 *  @param uiRows - The number of rows in the buffer. Must be a multiple of four.
 			 *  @throws std::exception on error.
 			 */
-			void quadIRCDS( T* pBuf, std::uint32_t uiCols, std::uint32_t uiRows );
+			void quadIRCDS( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows );
 
 			/** Hawaii RG deinterlace algorithm.
-			 *  @param pBuf			- Pointer to the buffer data to deinterlace.
+			 *  @param pSrc			- Pointer to the buffer data to deinterlace.
+			 *  @param pDst			- Pointer to the buffer to receive the deinterlaced data. Must not overlap pSrc.
 			 *  @param uiCols		- The number of columns in the buffer.
 			 *  @param uiRows		- The number of rows in the buffer.
 			 *  @param uiChannels	- The number of channels in the image ( 16, 32, ... ).
 			 *  @throws std::exception on error.
 			 */
-			void hawaiiRG( T* pBuf, std::uint32_t uiCols, std::uint32_t uiRows, std::uint32_t uiChannels );
+			void hawaiiRG( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows, std::uint32_t uiChannels );
 
 			/** STA 1600 deinterlace algorithm.
-			 *  @param pBuf	  - Pointer to the buffer data to deinterlace.
+			 *  @param pSrc	  - Pointer to the buffer data to deinterlace.
+			 *  @param pDst	  - Pointer to the buffer to receive the deinterlaced data. Must not overlap pSrc.
 			 *  @param uiCols - The number of columns in the buffer.
 			 *  @param uiRows - The number of rows in the buffer.
 			 *  @throws std::exception on error.
 			 */
-			void sta1600( T* pBuf, std::uint32_t uiCols, std::uint32_t uiRows );
+			void sta1600( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows );
 
 			/** version() text holder */
 			static const std::string m_sVersion;
@@ -194,6 +438,15 @@ namespace arc
 			/** Intermediate buffer rows */
 			std::uint32_t m_uiNewRows;
 
+			/** Number of deinterlace threads */
+			std::uint32_t m_uiThreadCount;
+
+			/** Instruction set used by the built-in algorithms */
+			arc::gen3::dlace::e_Simd m_eSimd;
+
+			/** Geometry copy plans, most recently used first */
+			std::vector<std::unique_ptr<arc::gen3::dlace::Plan>> m_vPlans;
+
 			/** Deinterlace plugin manager */
 			static std::unique_ptr<arc::gen3::CArcPluginManager> m_pPluginManager;
 
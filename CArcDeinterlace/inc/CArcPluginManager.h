@@ -16,9 +16,11 @@
 	#include <windows.h>
 #endif
 
+#include <unordered_map>
 #include <vector>
 
 #include <CArcDeinterlaceDllMain.h>
+#include <IArcPluginV2.h>
 #include <IArcPlugin.h>
 #include <CArcBase.h>
 
@@ -35,6 +37,9 @@ namespace arc
 		typedef arc::gen3::IArcPlugin* ( *PluginCreate )( );
 		typedef void( *PluginRelease )( IArcPlugin* );
 
+		typedef arc::gen3::IArcPluginV2* ( *PluginCreateV2 )( );
+		typedef void( *PluginReleaseV2 )( IArcPluginV2* );
+
 
 		/**
 		 * Define OS dependent custom library handle
@@ -54,7 +59,22 @@ namespace arc
 			ArcPluginLib	hlib;
 			PluginCreate	ctor;
 			PluginRelease	dtor;
-			IArcPlugin*		pObj;
+			IArcPlugin*		pObj;		// nullptr for version 2 plugins
+			PluginCreateV2	ctorV2;		// nullptr for version 1 plugins
+			PluginReleaseV2	dtorV2;		// nullptr for version 1 plugins
+			IArcPluginV2*	pObjV2;		// The plugin, or the CArcPluginV1Adapter that wraps pObj
+		};
+
+
+		/**
+		 * A plugin algorithm resolved by name, see CArcPluginManager::findAlgorithm(). Valid while the plugin
+		 * manager exists.
+		 */
+		struct PluginAlg_t
+		{
+			IArcPluginV2*	pPlugin;
+			std::uint32_t	uiAlg;
+			std::uint32_t	uiCaps;
 		};
 
 
@@ -79,12 +99,26 @@ namespace arc
 				 */
 				bool pluginLoaded( void );
 
-				/** Returns a loaded plugin object.
+				/** Returns a loaded version 1 plugin object.
 				 *  @param uiIndex - The index of the plugin object to return. For a single plugin use the default value ( default = 0 ).
-				 *  @return The plugin object at the specified index. May return nullptr.
+				 *  @return The plugin object at the specified index. May return nullptr, including for version 2 plugins.
 				 */
 				arc::gen3::IArcPlugin* getPluginObject( std::uint32_t uiIndex = 0 );
 
+				/** Returns a loaded plugin through the version 2 interface. Version 1 plugins are wrapped by a
+				 *  CArcPluginV1Adapter.
+				 *  @param uiIndex - The index of the plugin to return ( default = 0 ).
+				 *  @return The plugin at the specified index. May return nullptr.
+				 */
+				arc::gen3::IArcPluginV2* getPlugin( std::uint32_t uiIndex = 0 );
+
+				/** Finds an algorithm by name in all loaded plugins with a hash lookup. If more than one plugin has
+				 *  the name, the first plugin loaded wins.
+				 *  @param sAlg - The algorithm name.
+				 *  @return The algorithm, or nullptr if no plugin has it.
+				 */
+				const arc::gen3::PluginAlg_t* findAlgorithm( const std::string& sAlg );
+
 				/** Searches the specified directory for libraries that match the plugin interface.
 				 *  @param sLibPath - The directory to search for libraries in.
 				 *  @return <i>true</i> if at least one plugin was found and loaded; <i>false</i> otherwise.
@@ -115,14 +149,18 @@ namespace arc
 				 */
 				void loadCustomLibrary( const std::string sLibPath, const std::string sLibName );
 
-				/** Verifies that the specified library handle points to a custom deinterlace library.
+				/** Creates the plugin object if the specified library handle points to a custom deinterlace library
+				 *  ( version 2 or version 1 factory functions ).
 				 *  @param hCustomLib - A custom library handle.
-				 *  @return <i>true</i> if the "IS_CUSTOM_ALGORITHM" system returns 1; <i>false</i> otherwise ( i.e. the symbol is not found ).
+				 *  @return The new plugin entry, or nullptr if the factory functions are not found.
 				 */
 				Plugin_t* createInstance( ArcPluginLib hPluginLib );
 
 				/** The plugin list */
 				std::vector<Plugin_t*> m_pluginMap;
+
+				/** Algorithm name to plugin algorithm, for all loaded plugins */
+				std::unordered_map<std::string, arc::gen3::PluginAlg_t> m_algMap;
 		};
 
 	}
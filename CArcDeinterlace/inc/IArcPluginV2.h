@@ -0,0 +1,189 @@
+// +------------------------------------------------------------------------------------------------------------------+
+// |  FILE:  IArcPluginV2.h  ( Gen3 )                                                                                 |
+// +------------------------------------------------------------------------------------------------------------------+
+// |  PURPOSE: This file defines the version 2 ARC deinterlace plugin interface, which takes typed buffers, several   |
+// |           arguments, batches of frames and an optional destination, and the adapter that presents a version 1    |
+// |           plugin through it.                                                                                     |
+// +------------------------------------------------------------------------------------------------------------------+
+
+#ifndef _GEN3_IPLUGIN_V2_H_
+#define _GEN3_IPLUGIN_V2_H_
+
+#ifdef _WINDOWS
+	#pragma warning( disable: 4251 )
+#endif
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <CArcDeinterlaceDllMain.h>
+#include <IArcPlugin.h>
+#include <CArcBase.h>
+
+
+
+//
+// A version 2 plugin library exports:
+//
+//		extern "C" arc::gen3::IArcPluginV2* createPluginV2( void );
+//		extern "C" void releasePluginV2( arc::gen3::IArcPluginV2* pPlugin );
+//
+// Libraries that only export the version 1 createPlugin() / releasePlugin() pair are loaded through
+// CArcPluginV1Adapter.
+//
+namespace arc
+{
+	namespace gen3
+	{
+
+		namespace dlace
+		{
+
+			/** Plugin capability: run() may be called from several threads at once */
+			const std::uint32_t PLUGIN_THREAD_SAFE = 0x1;
+
+			/** Plugin capability: run() accepts pDst == pSrc */
+			const std::uint32_t PLUGIN_IN_PLACE = 0x2;
+
+			/** Plugin capability: the algorithm uses vector instructions */
+			const std::uint32_t PLUGIN_SIMD = 0x4;
+
+
+			/** @struct PluginJob
+			 *  Describes the image data passed to IArcPluginV2::run(). The frames are stored one after another, each
+			 *  uiCols x uiRows pixels, in both the source and destination buffers.
+			 */
+			struct PluginJob
+			{
+				/** The number of columns in each frame */
+				std::uint32_t uiCols = 0;
+
+				/** The number of rows in each frame */
+				std::uint32_t uiRows = 0;
+
+				/** The number of frames */
+				std::uint32_t uiFrames = 1;
+
+				/** The algorithm arguments. May be nullptr if uiArgCount is 0. */
+				const std::uint32_t* pArgs = nullptr;
+
+				/** The number of algorithm arguments */
+				std::uint32_t uiArgCount = 0;
+			};
+
+		}	// end dlace namespace
+
+
+		/** @interface IArcPluginV2
+		 *  Version 2 deinterlace plugin interface. Abstract class. Algorithms are addressed by index, which the
+		 *  plugin manager resolves from the algorithm name once.
+		 *  @see arc::gen3::CArcBase()
+		 */
+		class GEN3_CARCDEINTERLACE_API IArcPluginV2 : arc::gen3::CArcBase
+		{
+
+			public:
+
+				/** Destructor
+				 */
+				virtual ~IArcPluginV2( void );
+
+				/** Returns the number of algorithms supported by the plugin.
+				 *  @return The algorithm count.
+				 */
+				virtual std::uint32_t algorithmCount( void ) = 0;
+
+				/** Returns the name of an algorithm.
+				 *  @param uiAlg - The algorithm index ( 0 to algorithmCount() - 1 ).
+				 *  @return The algorithm name. Must stay valid while the plugin is loaded.
+				 *  @throws std::invalid_argument if the index is out of range.
+				 */
+				virtual const std::string& algorithmName( std::uint32_t uiAlg ) = 0;
+
+				/** Returns the capabilities of an algorithm.
+				 *  @param uiAlg - The algorithm index ( 0 to algorithmCount() - 1 ).
+				 *  @return The dlace::PLUGIN_xxx flags, OR'd together.
+				 */
+				virtual std::uint32_t capabilities( std::uint32_t uiAlg ) = 0;
+
+				/** Executes an algorithm on 16 bits-per-pixel frames.
+				 *  @param uiAlg - The algorithm index ( 0 to algorithmCount() - 1 ).
+				 *  @param pSrc	 - The frames to deinterlace.
+				 *  @param pDst	 - The buffer to receive the deinterlaced frames. Does not overlap pSrc, unless the
+				 *				   algorithm has the PLUGIN_IN_PLACE capability, in which case it may equal pSrc.
+				 *  @param tJob	 - The frame size, frame count and arguments.
+				 *  @throws std::exception on error.
+				 */
+				virtual void run( std::uint32_t uiAlg, const std::uint16_t* pSrc, std::uint16_t* pDst, const arc::gen3::dlace::PluginJob& tJob ) = 0;
+
+				/** Executes an algorithm on 32 bits-per-pixel frames.
+				 *  @param uiAlg - The algorithm index ( 0 to algorithmCount() - 1 ).
+				 *  @param pSrc	 - The frames to deinterlace.
+				 *  @param pDst	 - The buffer to receive the deinterlaced frames. Does not overlap pSrc, unless the
+				 *				   algorithm has the PLUGIN_IN_PLACE capability, in which case it may equal pSrc.
+				 *  @param tJob	 - The frame size, frame count and arguments.
+				 *  @throws std::exception on error.
+				 */
+				virtual void run( std::uint32_t uiAlg, const std::uint32_t* pSrc, std::uint32_t* pDst, const arc::gen3::dlace::PluginJob& tJob ) = 0;
+
+			protected:
+
+				/** Constructor */
+				IArcPluginV2( void );
+		};
+
+
+		/** @class CArcPluginV1Adapter
+		 *  Presents a version 1 plugin through the version 2 interface. Each frame is copied to the destination and
+		 *  deinterlaced there by IArcPlugin::run(), one frame at a time, with the first argument only. Algorithms
+		 *  report PLUGIN_IN_PLACE and nothing else.
+		 *  @see arc::gen3::IArcPluginV2()
+		 */
+		class GEN3_CARCDEINTERLACE_API CArcPluginV1Adapter : public arc::gen3::IArcPluginV2
+		{
+
+			public:
+
+				/** Constructor
+				 *  @param pPlugin - The version 1 plugin. Not owned; must outlive the adapter.
+				 *  @throws std::invalid_argument if pPlugin is nullptr.
+				 */
+				CArcPluginV1Adapter( arc::gen3::IArcPlugin* pPlugin );
+
+				/** Destructor
+				 */
+				virtual ~CArcPluginV1Adapter( void );
+
+				std::uint32_t algorithmCount( void );
+
+				const std::string& algorithmName( std::uint32_t uiAlg );
+
+				std::uint32_t capabilities( std::uint32_t uiAlg );
+
+				void run( std::uint32_t uiAlg, const std::uint16_t* pSrc, std::uint16_t* pDst, const arc::gen3::dlace::PluginJob& tJob );
+
+				void run( std::uint32_t uiAlg, const std::uint32_t* pSrc, std::uint32_t* pDst, const arc::gen3::dlace::PluginJob& tJob );
+
+			private:
+
+				/** Runs the version 1 plugin on each frame.
+				 *  @param uiAlg - The algorithm index.
+				 *  @param pSrc	 - The frames to deinterlace.
+				 *  @param pDst	 - The buffer to receive the deinterlaced frames.
+				 *  @param tJob	 - The frame size, frame count and arguments.
+				 */
+				template <typename T> void runFrames( std::uint32_t uiAlg, const T* pSrc, T* pDst, const arc::gen3::dlace::PluginJob& tJob );
+
+				/** The version 1 plugin */
+				arc::gen3::IArcPlugin* m_pPlugin;
+
+				/** The algorithm names, from IArcPlugin::getNameList() */
+				std::vector<std::string> m_vNames;
+		};
+
+	}		// end gen3 namespace
+}			// end arc namespace
+
+
+#endif	// _GEN3_IPLUGIN_V2_H_
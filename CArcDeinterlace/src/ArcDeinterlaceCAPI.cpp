@@ -206,41 +206,186 @@ GEN3_CARCDEINTERLACE_API void ArcDLace_run( unsigned long long ulHandle, void* p
 {
 	INIT_STATUS( pStatus, ARC_STATUS_OK )
 
-		auto list = ( uiArg != DLACE_NO_ARG ? std::initializer_list<std::uint32_t>{ uiArg } : std::initializer_list<std::uint32_t>{} );
-
 	try
 	{
 		VERIFY_INSTANCE_HANDLE( ulHandle )
 
 			if ( ulHandle == reinterpret_cast< std::uint64_t >( g_pDLace16.get() ) )
 			{
-				g_pDLace16->run( static_cast< unsigned short* >( pBuf ), uiCols, uiRows, static_cast< arc::gen3::dlace::e_Alg >( uiAlg ), list );
+				if ( uiArg == DLACE_NO_ARG )
+				{
+					g_pDLace16->run( static_cast< unsigned short * >( pBuf ), uiCols, uiRows, static_cast< arc::gen3::dlace::e_Alg >( uiAlg ) );
+				}
+
+				else
+				{
+					g_pDLace16->run( static_cast< unsigned short * >( pBuf ), uiCols, uiRows, static_cast< arc::gen3::dlace::e_Alg >( uiAlg ), { uiArg } );
+				}
+			}
+
+			else if ( ulHandle == reinterpret_cast< std::uint64_t >( g_pDLace32.get() ) )
+			{
+				if ( uiArg == DLACE_NO_ARG )
+				{
+					g_pDLace32->run( static_cast< unsigned int * >( pBuf ), uiCols, uiRows, static_cast< arc::gen3::dlace::e_Alg >( uiAlg ) );
+				}
+
+				else
+				{
+					g_pDLace32->run( static_cast< unsigned int * >( pBuf ), uiCols, uiRows, static_cast< arc::gen3::dlace::e_Alg >( uiAlg ), { uiArg } );
+				}
+			}
+	}
+	catch ( std::exception& e )
+	{
+		SET_ERROR_STATUS( pStatus, e );
+	}
+}
+
+
+// +------------------------------------------------------------------------------------------------------------------+
+// |  ArcDLace_runTo                                                                                                  |
+// +------------------------------------------------------------------------------------------------------------------+
+// |  Deinterlaces the source image buffer into a destination buffer, without an intermediate copy.                   |
+// |                                                                                                                  |
+// |  <IN>  -> ulHandle	- A reference to a deinterlace object.                                                        |
+// |  <IN>  -> pSrc		- The image buffer data.                                                                      |
+// |  <OUT> -> pDst		- The buffer to receive the deinterlaced image.                                               |
+// |  <IN>  -> uiCols	- The number of columns in the image.                                                         |
+// |  <IN>  -> uiRows	- The number of rows in the image.                                                            |
+// |  <IN>  -> uiAlg	- The deinterlace algorithm.                                                                  |
+// |  <IN>  -> uiArg	- An algorithm dependent argument. Use DLACE_NO_ARG if not needed.                            |
+// |  <OUT> -> pStatus	- Success state; equals ARC_STATUS_OK or ARC_STATUS_ERROR.                                    |
+// +------------------------------------------------------------------------------------------------------------------+
+GEN3_CARCDEINTERLACE_API void ArcDLace_runTo( unsigned long long ulHandle, const void* pSrc, void* pDst, unsigned int uiCols, unsigned int uiRows,
+	unsigned int uiAlg, unsigned int uiArg, ArcStatus_t* pStatus )
+{
+	INIT_STATUS( pStatus, ARC_STATUS_OK )
 
-				//if ( uiArg == DLACE_NO_ARG )
-				//{
-				//	g_pDLace16->run( static_cast< unsigned short * >( pBuf ), uiCols, uiRows, static_cast< arc::gen3::dlace::e_Alg >( uiAlg ) );
-				//}
+	try
+	{
+		VERIFY_INSTANCE_HANDLE( ulHandle )
 
-				//else
-				//{
-				//	g_pDLace16->run( static_cast< unsigned short * >( pBuf ), uiCols, uiRows, static_cast< arc::gen3::dlace::e_Alg >( uiAlg ), { uiArg } );
-				//}
+		if ( ulHandle == reinterpret_cast< std::uint64_t >( g_pDLace16.get() ) )
+		{
+			if ( uiArg == DLACE_NO_ARG )
+			{
+				g_pDLace16->run( static_cast< const unsigned short* >( pSrc ), static_cast< unsigned short* >( pDst ), uiCols, uiRows, static_cast< arc::gen3::dlace::e_Alg >( uiAlg ) );
 			}
 
-			else if ( ulHandle == reinterpret_cast< std::uint64_t >( g_pDLace32.get() ) )
+			else
 			{
-				g_pDLace32->run( static_cast< unsigned int* >( pBuf ), uiCols, uiRows, static_cast< arc::gen3::dlace::e_Alg >( uiAlg ), list );
+				g_pDLace16->run( static_cast< const unsigned short* >( pSrc ), static_cast< unsigned short* >( pDst ), uiCols, uiRows, static_cast< arc::gen3::dlace::e_Alg >( uiAlg ), { uiArg } );
+			}
+		}
 
-				//if ( uiArg == DLACE_NO_ARG )
-				//{
-				//	g_pDLace32->run( static_cast< unsigned int * >( pBuf ), uiCols, uiRows, static_cast< arc::gen3::dlace::e_Alg >( uiAlg ) );
-				//}
+		else if ( ulHandle == reinterpret_cast< std::uint64_t >( g_pDLace32.get() ) )
+		{
+			if ( uiArg == DLACE_NO_ARG )
+			{
+				g_pDLace32->run( static_cast< const unsigned int* >( pSrc ), static_cast< unsigned int* >( pDst ), uiCols, uiRows, static_cast< arc::gen3::dlace::e_Alg >( uiAlg ) );
+			}
 
-				//else
-				//{
-				//	g_pDLace32->run( static_cast< unsigned int * >( pBuf ), uiCols, uiRows, static_cast< arc::gen3::dlace::e_Alg >( uiAlg ), { uiArg } );
-				//}
+			else
+			{
+				g_pDLace32->run( static_cast< const unsigned int* >( pSrc ), static_cast< unsigned int* >( pDst ), uiCols, uiRows, static_cast< arc::gen3::dlace::e_Alg >( uiAlg ), { uiArg } );
 			}
+		}
+	}
+	catch ( std::exception& e )
+	{
+		SET_ERROR_STATUS( pStatus, e );
+	}
+}
+
+
+// +------------------------------------------------------------------------------------------------------------------+
+// |  ArcDLace_runFrames                                                                                              |
+// +------------------------------------------------------------------------------------------------------------------+
+// |  Deinterlaces a stack of contiguous frames, splitting whole frames across the deinterlace threads.               |
+// |                                                                                                                  |
+// |  <IN>  -> ulHandle	- A reference to a deinterlace object.                                                        |
+// |  <IN>  -> pSrc		- The frames.                                                                                 |
+// |  <OUT> -> pDst		- The buffer to receive the deinterlaced frames.                                              |
+// |  <IN>  -> uiCols	- The number of columns in each frame.                                                        |
+// |  <IN>  -> uiRows	- The number of rows in each frame.                                                           |
+// |  <IN>  -> uiFrames	- The number of frames.                                                                       |
+// |  <IN>  -> uiAlg	- The deinterlace algorithm.                                                                  |
+// |  <IN>  -> uiArg	- An algorithm dependent argument. Use DLACE_NO_ARG if not needed.                            |
+// |  <OUT> -> pStatus	- Success state; equals ARC_STATUS_OK or ARC_STATUS_ERROR.                                    |
+// +------------------------------------------------------------------------------------------------------------------+
+GEN3_CARCDEINTERLACE_API void ArcDLace_runFrames( unsigned long long ulHandle, const void* pSrc, void* pDst, unsigned int uiCols, unsigned int uiRows,
+	unsigned int uiFrames, unsigned int uiAlg, unsigned int uiArg, ArcStatus_t* pStatus )
+{
+	INIT_STATUS( pStatus, ARC_STATUS_OK )
+
+	arc::gen3::dlace::FrameStack tStack;
+
+	tStack.uiFrames = uiFrames;
+
+	try
+	{
+		VERIFY_INSTANCE_HANDLE( ulHandle )
+
+		if ( ulHandle == reinterpret_cast< std::uint64_t >( g_pDLace16.get() ) )
+		{
+			if ( uiArg == DLACE_NO_ARG )
+			{
+				g_pDLace16->run( static_cast< const unsigned short* >( pSrc ), static_cast< unsigned short* >( pDst ), uiCols, uiRows, tStack, static_cast< arc::gen3::dlace::e_Alg >( uiAlg ) );
+			}
+
+			else
+			{
+				g_pDLace16->run( static_cast< const unsigned short* >( pSrc ), static_cast< unsigned short* >( pDst ), uiCols, uiRows, tStack, static_cast< arc::gen3::dlace::e_Alg >( uiAlg ), { uiArg } );
+			}
+		}
+
+		else if ( ulHandle == reinterpret_cast< std::uint64_t >( g_pDLace32.get() ) )
+		{
+			if ( uiArg == DLACE_NO_ARG )
+			{
+				g_pDLace32->run( static_cast< const unsigned int* >( pSrc ), static_cast< unsigned int* >( pDst ), uiCols, uiRows, tStack, static_cast< arc::gen3::dlace::e_Alg >( uiAlg ) );
+			}
+
+			else
+			{
+				g_pDLace32->run( static_cast< const unsigned int* >( pSrc ), static_cast< unsigned int* >( pDst ), uiCols, uiRows, tStack, static_cast< arc::gen3::dlace::e_Alg >( uiAlg ), { uiArg } );
+			}
+		}
+	}
+	catch ( std::exception& e )
+	{
+		SET_ERROR_STATUS( pStatus, e );
+	}
+}
+
+
+// +------------------------------------------------------------------------------------------------------------------+
+// |  ArcDLace_setThreadCount                                                                                         |
+// +------------------------------------------------------------------------------------------------------------------+
+// |  Sets the number of threads the built-in deinterlace algorithms may use.                                         |
+// |                                                                                                                  |
+// |  <IN>  -> ulHandle	- A reference to a deinterlace object.                                                        |
+// |  <IN>  -> uiCount	- The thread count; 0 uses one thread per hardware thread.                                    |
+// |  <OUT> -> pStatus	- Success state; equals ARC_STATUS_OK or ARC_STATUS_ERROR.                                    |
+// +------------------------------------------------------------------------------------------------------------------+
+GEN3_CARCDEINTERLACE_API void ArcDLace_setThreadCount( unsigned long long ulHandle, unsigned int uiCount, ArcStatus_t* pStatus )
+{
+	INIT_STATUS( pStatus, ARC_STATUS_OK )
+
+	try
+	{
+		VERIFY_INSTANCE_HANDLE( ulHandle )
+
+		if ( ulHandle == reinterpret_cast< std::uint64_t >( g_pDLace16.get() ) )
+		{
+			g_pDLace16->setThreadCount( uiCount );
+		}
+
+		else if ( ulHandle == reinterpret_cast< std::uint64_t >( g_pDLace32.get() ) )
+		{
+			g_pDLace32->setThreadCount( uiCount );
+		}
 	}
 	catch ( std::exception& e )
 	{
@@ -384,13 +529,13 @@ GEN3_CARCDEINTERLACE_API const char** ArcDLace_pluginList( unsigned long long ul
 			THROW_INVALID_ARGUMENT( "Invalid plugin value [ %u ], expected range: 0 to %u", uiPlugin, pluginManager->pluginCount() );
 		}
 
-		auto pList = pluginManager->getPluginObject( uiPlugin )->getNameList();
+		auto pPlugin = pluginManager->getPlugin( uiPlugin );
 
 		g_pPluginList.reset( new std::vector<const char*> );
 
-		for ( std::uint32_t i = 0; i < pList->length(); i++ )
+		for ( std::uint32_t i = 0; i < pPlugin->algorithmCount(); i++ )
 		{
-			g_pPluginList->push_back( pList->at( i ).c_str() );
+			g_pPluginList->push_back( pPlugin->algorithmName( i ).c_str() );
 		}
 	}
 	catch ( std::exception& e )
@@ -428,7 +573,7 @@ GEN3_CARCDEINTERLACE_API unsigned int ArcDLace_pluginListCount( unsigned long lo
 			THROW_INVALID_ARGUMENT( "Invalid plugin value [ %u ], expected range: 0 to %u", uiPlugin, pluginManager->pluginCount() );
 		}
 
-		uiCount = pluginManager->getPluginObject( uiPlugin )->getCount();
+		uiCount = pluginManager->getPlugin( uiPlugin )->algorithmCount();
 	}
 	catch ( std::exception& e )
 	{
@@ -469,12 +614,43 @@ GEN3_CARCDEINTERLACE_API void ArcDLace_pluginRun( unsigned long long ulHandle, u
 			THROW_INVALID_ARGUMENT( "Invalid plugin value [ %u ], expected range: 0 to %u", uiPlugin, g_pDLace16->getPluginManager()->pluginCount() );
 		}
 
-		pluginManager->getPluginObject( uiPlugin )->run( pBuf,
-			uiCols,
-			uiRows,
-			( 8 * ( ulHandle == reinterpret_cast< std::uint64_t >( g_pDLace16.get() ) ? DLACE_BPP16 : DLACE_BPP32 ) ),
-			pszAlg,
-			uiArg );
+		auto pPlugin = pluginManager->getPlugin( uiPlugin );
+
+		//  Use the hashed lookup; only a name shadowed by an earlier plugin needs a scan of this plugin
+		// +--------------------------------------------------------+
+		const arc::gen3::PluginAlg_t* pAlg = pluginManager->findAlgorithm( pszAlg );
+
+		arc::gen3::PluginAlg_t tAlg { pPlugin, 0, 0 };
+
+		if ( pAlg != nullptr && pAlg->pPlugin == pPlugin )
+		{
+			tAlg = *pAlg;
+		}
+
+		else
+		{
+			while ( tAlg.uiAlg < pPlugin->algorithmCount() && pPlugin->algorithmName( tAlg.uiAlg ).compare( pszAlg ) != 0 )
+			{
+				tAlg.uiAlg++;
+			}
+
+			if ( pAlg == nullptr || tAlg.uiAlg >= pPlugin->algorithmCount() )
+			{
+				THROW( "Algorithm [ \'%s\' ] not found!", pszAlg );
+			}
+
+			tAlg.uiCaps = pPlugin->capabilities( tAlg.uiAlg );
+		}
+
+		if ( ulHandle == reinterpret_cast< std::uint64_t >( g_pDLace16.get() ) )
+		{
+			g_pDLace16->run( static_cast< unsigned short* >( pBuf ), uiCols, uiRows, tAlg, { uiArg } );
+		}
+
+		else
+		{
+			g_pDLace32->run( static_cast< unsigned int* >( pBuf ), uiCols, uiRows, tAlg, { uiArg } );
+		}
 
 		//pluginManager->getPluginObject( uiPlugin )->run( pBuf,
 		//												uiCols,
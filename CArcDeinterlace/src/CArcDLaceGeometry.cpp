@@ -0,0 +1,316 @@
+// +------------------------------------------------------------------------------------------------------------------+
+// |  FILE:  CArcDLaceGeometry.cpp  ( Gen3 )                                                                          |
+// +------------------------------------------------------------------------------------------------------------------+
+// |  PURPOSE: This file implements the readout geometry descriptor and copy plan builder.                            |
+// +------------------------------------------------------------------------------------------------------------------+
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <CArcDLaceGeometry.h>
+#include <CArcDeinterlace.h>
+#include <CArcBase.h>
+
+
+
+namespace arc
+{
+	namespace gen3
+	{
+
+		namespace dlace
+		{
+
+			/** Largest number of groups merged into one plan step, so that steps can be split across threads */
+			static const std::uint64_t MAX_STEP_GROUPS = ( 64 * 1024 );
+
+
+			// +----------------------------------------------------------------------------------------------------------+
+			// |  Geometry::outputCols                                                                                    |
+			// +----------------------------------------------------------------------------------------------------------+
+			// |  Returns the width of the deinterlaced image, i.e. the raw width less the prescan and overscan columns.  |
+			// |                                                                                                          |
+			// |  <IN>  -> uiCols - The raw image width.                                                                  |
+			// +----------------------------------------------------------------------------------------------------------+
+			std::uint32_t Geometry::outputCols( std::uint32_t uiCols ) const
+			{
+				return ( uiCols - ( uiGridCols * ( uiPrescan + uiOverscan ) ) );
+			}
+
+
+			// +----------------------------------------------------------------------------------------------------------+
+			// |  Geometry::operator==                                                                                    |
+			// +----------------------------------------------------------------------------------------------------------+
+			// |  Returns true if two geometries are the same.                                                            |
+			// +----------------------------------------------------------------------------------------------------------+
+			bool Geometry::operator==( const Geometry& tGeometry ) const
+			{
+				if ( uiGridCols != tGeometry.uiGridCols || uiGridRows != tGeometry.uiGridRows || uiPrescan != tGeometry.uiPrescan ||
+					 uiOverscan != tGeometry.uiOverscan || uiFrames != tGeometry.uiFrames || vAmps.size() != tGeometry.vAmps.size() )
+				{
+					return false;
+				}
+
+				return std::equal( vAmps.begin(), vAmps.end(), tGeometry.vAmps.begin(), []( const Amplifier& tA, const Amplifier& tB )
+				{
+					return ( tA.uiTileCol == tB.uiTileCol && tA.uiTileRow == tB.uiTileRow && tA.eCorner == tB.eCorner );
+				} );
+			}
+
+
+			// +----------------------------------------------------------------------------------------------------------+
+			// |  makePlan                                                                                                |
+			// +----------------------------------------------------------------------------------------------------------+
+			// |  Builds the copy plan for a geometry and raw image size. Each frame line ( one line from every           |
+			// |  amplifier ) becomes a step, and a step is merged into the one before it when the raw groups and every   |
+			// |  output run carry straight on, e.g. full width tiles. Columns left over when the width does not divide   |
+			// |  into the tiles are not written.                                                                         |
+			// |                                                                                                          |
+			// |  <IN>  -> tGeometry - The geometry.                                                                      |
+			// |  <IN>  -> uiCols    - The raw image width.                                                               |
+			// |  <IN>  -> uiRows    - The raw image height.                                                              |
+			// |                                                                                                          |
+			// |  Throws std::invalid_argument                                                                            |
+			// +----------------------------------------------------------------------------------------------------------+
+			Plan makePlan( const Geometry& tGeometry, std::uint32_t uiCols, std::uint32_t uiRows )
+			{
+				std::uint32_t uiAmps = static_cast< std::uint32_t >( tGeometry.vAmps.size() );
+
+				if ( uiAmps == 0 || uiAmps > MAX_AMPLIFIERS )
+				{
+					THROW_INVALID_ARGUMENT( "Invalid amplifier count [ %u ], must be 1 - %u.", uiAmps, MAX_AMPLIFIERS );
+				}
+
+				if ( tGeometry.uiGridCols == 0 || tGeometry.uiGridRows == 0 || ( tGeometry.uiGridCols * tGeometry.uiGridRows ) != uiAmps )
+				{
+					THROW_INVALID_ARGUMENT( "Tile grid [ %u x %u ] does not match the amplifier count [ %u ].", tGeometry.uiGridCols, tGeometry.uiGridRows, uiAmps );
+				}
+
+				std::vector<bool> vTileUsed( uiAmps, false );
+
+				for ( const auto& tAmp : tGeometry.vAmps )
+				{
+					if ( tAmp.uiTileCol >= tGeometry.uiGridCols || tAmp.uiTileRow >= tGeometry.uiGridRows ||
+						 vTileUsed[ ( tAmp.uiTileRow * tGeometry.uiGridCols ) + tAmp.uiTileCol ] )
+					{
+						THROW_INVALID_ARGUMENT( "Amplifier tile [ %u, %u ] is outside the grid or used twice.", tAmp.uiTileCol, tAmp.uiTileRow );
+					}
+
+					if ( static_cast< std::uint32_t >( tAmp.eCorner ) > static_cast< std::uint32_t >( e_Corner::TOP_RIGHT ) )
+					{
+						THROW_INVALID_ARGUMENT( "Invalid amplifier corner [ %u ].", static_cast< std::uint32_t >( tAmp.eCorner ) );
+					}
+
+					vTileUsed[ ( tAmp.uiTileRow * tGeometry.uiGridCols ) + tAmp.uiTileCol ] = true;
+				}
+
+				if ( tGeometry.uiFrames == 0 || ( uiRows % tGeometry.uiFrames ) != 0 || ( ( uiRows / tGeometry.uiFrames ) % tGeometry.uiGridRows ) != 0 )
+				{
+					THROW_INVALID_ARGUMENT( "Image rows [ %u ] do not divide into %u frame(s) of %u tile row(s).", uiRows, tGeometry.uiFrames, tGeometry.uiGridRows );
+				}
+
+				//
+				// Raw line length per amplifier and the data pixels left after the prescan and overscan
+				//
+				std::uint64_t u64Line = ( uiCols / tGeometry.uiGridCols );
+
+				if ( u64Line <= ( static_cast< std::uint64_t >( tGeometry.uiPrescan ) + tGeometry.uiOverscan ) )
+				{
+					THROW_INVALID_ARGUMENT( "Image cols [ %u ] leave no data pixels after the prescan and overscan.", uiCols );
+				}
+
+				std::uint64_t u64Width = ( u64Line - tGeometry.uiPrescan - tGeometry.uiOverscan );
+
+				std::uint64_t u64FrameRows = ( uiRows / tGeometry.uiFrames );
+
+				std::uint64_t u64TileRows = ( u64FrameRows / tGeometry.uiGridRows );
+
+				std::uint64_t u64OutCols = tGeometry.outputCols( uiCols );
+
+				Plan tPlan;
+
+				tPlan.tGeometry = tGeometry;
+				tPlan.uiCols = uiCols;
+				tPlan.uiRows = uiRows;
+				tPlan.u64Pixels = ( u64OutCols * uiRows );
+				tPlan.u64Reverse = 0;
+
+				for ( std::uint32_t k = 0; k < uiAmps; k++ )
+				{
+					auto eCorner = tGeometry.vAmps[ k ].eCorner;
+
+					if ( eCorner == e_Corner::BOTTOM_RIGHT || eCorner == e_Corner::TOP_RIGHT )
+					{
+						tPlan.u64Reverse |= ( 1ULL << k );
+					}
+				}
+
+				std::vector<std::uint64_t> vDst( uiAmps );
+
+				for ( std::uint64_t f = 0; f < tGeometry.uiFrames; f++ )
+				{
+					for ( std::uint64_t l = 0; l < u64TileRows; l++ )
+					{
+						std::uint64_t u64Src = ( ( ( ( f * u64TileRows ) + l ) * uiAmps * u64Line ) + ( static_cast< std::uint64_t >( tGeometry.uiPrescan ) * uiAmps ) );
+
+						for ( std::uint32_t k = 0; k < uiAmps; k++ )
+						{
+							const Amplifier& tAmp = tGeometry.vAmps[ k ];
+
+							bool bBottom = ( tAmp.eCorner == e_Corner::BOTTOM_LEFT || tAmp.eCorner == e_Corner::BOTTOM_RIGHT );
+
+							std::uint64_t u64Row = ( ( f * u64FrameRows ) + ( tAmp.uiTileRow * u64TileRows ) + ( bBottom ? l : ( u64TileRows - l - 1 ) ) );
+
+							std::uint64_t u64Col = ( ( tAmp.uiTileCol * u64Width ) + ( ( tPlan.u64Reverse & ( 1ULL << k ) ) ? ( u64Width - 1 ) : 0 ) );
+
+							vDst[ k ] = ( ( u64Row * u64OutCols ) + u64Col );
+						}
+
+						//
+						// Merge with the previous step if the raw groups and all output runs carry straight on
+						//
+						bool bMerge = false;
+
+						if ( !tPlan.vSrc.empty() )
+						{
+							std::uint64_t u64Groups = tPlan.vGroups.back();
+
+							const std::uint64_t* pPrev = &tPlan.vDst[ tPlan.vDst.size() - uiAmps ];
+
+							bMerge = ( ( u64Groups + u64Width ) <= MAX_STEP_GROUPS && ( tPlan.vSrc.back() + ( u64Groups * uiAmps ) ) == u64Src );
+
+							for ( std::uint32_t k = 0; k < uiAmps && bMerge; k++ )
+							{
+								bMerge = ( ( tPlan.u64Reverse & ( 1ULL << k ) ) ? ( pPrev[ k ] == ( vDst[ k ] + u64Groups ) ) : ( ( pPrev[ k ] + u64Groups ) == vDst[ k ] ) );
+							}
+						}
+
+						if ( bMerge )
+						{
+							tPlan.vGroups.back() += u64Width;
+						}
+
+						else
+						{
+							tPlan.vSrc.push_back( u64Src );
+							tPlan.vDst.insert( tPlan.vDst.end(), vDst.begin(), vDst.end() );
+							tPlan.vGroups.push_back( u64Width );
+						}
+					}
+				}
+
+				return tPlan;
+			}
+
+
+			// +----------------------------------------------------------------------------------------------------------+
+			// |  geometry                                                                                                |
+			// +----------------------------------------------------------------------------------------------------------+
+			// |  Returns the predefined geometry for a built-in algorithm. See the diagrams in CArcDeinterlace::run().   |
+			// |                                                                                                          |
+			// |  <IN>  -> eAlg  - The algorithm.                                                                         |
+			// |  <IN>  -> uiArg - The channel count, for HAWAII_RG.                                                      |
+			// |                                                                                                          |
+			// |  Throws std::invalid_argument                                                                            |
+			// +----------------------------------------------------------------------------------------------------------+
+			Geometry geometry( arc::gen3::dlace::e_Alg eAlg, std::uint32_t uiArg )
+			{
+				Geometry tGeometry;
+
+				switch ( eAlg )
+				{
+					case e_Alg::NONE:
+					{
+						tGeometry.vAmps = { { 0, 0, e_Corner::BOTTOM_LEFT } };
+					}
+					break;
+
+					case e_Alg::PARALLEL:
+					{
+						tGeometry.uiGridRows = 2;
+						tGeometry.vAmps = { { 0, 0, e_Corner::BOTTOM_LEFT }, { 0, 1, e_Corner::TOP_RIGHT } };
+					}
+					break;
+
+					case e_Alg::SERIAL:
+					{
+						tGeometry.uiGridCols = 2;
+						tGeometry.vAmps = { { 0, 0, e_Corner::BOTTOM_LEFT }, { 1, 0, e_Corner::BOTTOM_RIGHT } };
+					}
+					break;
+
+					case e_Alg::QUAD_CCD:
+					{
+						tGeometry.uiGridCols = 2;
+						tGeometry.uiGridRows = 2;
+						tGeometry.vAmps = { { 0, 0, e_Corner::BOTTOM_LEFT }, { 1, 0, e_Corner::BOTTOM_RIGHT },
+											{ 1, 1, e_Corner::TOP_RIGHT }, { 0, 1, e_Corner::TOP_LEFT } };
+					}
+					break;
+
+					case e_Alg::QUAD_IR:
+					case e_Alg::QUAD_IR_CDS:
+					{
+						tGeometry.uiGridCols = 2;
+						tGeometry.uiGridRows = 2;
+						tGeometry.uiFrames = ( eAlg == e_Alg::QUAD_IR_CDS ? 2 : 1 );
+						tGeometry.vAmps = { { 0, 1, e_Corner::TOP_LEFT }, { 1, 1, e_Corner::TOP_LEFT },
+											{ 1, 0, e_Corner::TOP_LEFT }, { 0, 0, e_Corner::TOP_LEFT } };
+					}
+					break;
+
+					case e_Alg::HAWAII_RG:
+					{
+						if ( uiArg == 0 || uiArg > MAX_AMPLIFIERS )
+						{
+							THROW_INVALID_ARGUMENT( "Invalid HAWAII RG channel count [ %u ], must be 1 - %u.", uiArg, MAX_AMPLIFIERS );
+						}
+
+						if ( uiArg > 1 && ( uiArg % 2 ) != 0 )
+						{
+							THROW_INVALID_ARGUMENT( "Invalid HAWAII RG channel count [ %u ], must be 1 or EVEN.", uiArg );
+						}
+
+						tGeometry.uiGridCols = uiArg;
+
+						for ( std::uint32_t i = 0; i < uiArg; i++ )
+						{
+							tGeometry.vAmps.push_back( { i, 0, e_Corner::BOTTOM_LEFT } );
+						}
+					}
+					break;
+
+					case e_Alg::STA1600:
+					{
+						//
+						// Each group holds the 8 bottom channels, then the 8 top channels, right to left
+						//
+						tGeometry.uiGridCols = 8;
+						tGeometry.uiGridRows = 2;
+
+						for ( std::uint32_t i = 0; i < 8; i++ )
+						{
+							tGeometry.vAmps.push_back( { ( 7 - i ), 0, e_Corner::BOTTOM_LEFT } );
+						}
+
+						for ( std::uint32_t i = 0; i < 8; i++ )
+						{
+							tGeometry.vAmps.push_back( { ( 7 - i ), 1, e_Corner::TOP_LEFT } );
+						}
+					}
+					break;
+
+					default:
+					{
+						THROW_INVALID_ARGUMENT( "Algorithm [ %u ] has no predefined geometry.", static_cast< std::uint32_t >( eAlg ) );
+					}
+				}
+
+				return tGeometry;
+			}
+
+		}	// end dlace namespace
+
+	}		// end gen3 namespace
+}			// end arc namespace
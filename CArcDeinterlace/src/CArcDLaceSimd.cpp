@@ -0,0 +1,435 @@
+// +------------------------------------------------------------------------------------------------------------------+
+// |  FILE:  CArcDLaceSimd.cpp  ( Gen3 )                                                                              |
+// +------------------------------------------------------------------------------------------------------------------+
+// |  PURPOSE: This file implements the de-interleave kernels used by the built-in deinterlace algorithms. The SSE2,  |
+// |           AVX2 and AVX-512 kernels are compiled with per-function target options, so the library still runs on   |
+// |           CPUs without them; simdSupported() picks the best one at run time.                                     |
+// +------------------------------------------------------------------------------------------------------------------+
+
+#include <algorithm>
+#include <cstdint>
+
+#include <CArcDLaceSimd.h>
+
+
+#if defined( __x86_64__ ) || defined( _M_X64 )
+	#define ARC_DLACE_X86		1
+
+	#include <immintrin.h>
+
+	#ifdef _MSC_VER
+		#include <intrin.h>
+	#endif
+#else
+	#define ARC_DLACE_X86		0
+#endif
+
+
+
+namespace arc
+{
+	namespace gen3
+	{
+
+		namespace dlace
+		{
+
+			// +----------------------------------------------------------------------------------------------------------+
+			// |  Scalar kernel                                                                                           |
+			// +----------------------------------------------------------------------------------------------------------+
+			namespace scalar
+			{
+				template <typename T, std::uint32_t N>
+				void deinterleave( const T* pSrc, T* const* ppDst, std::uint64_t u64Reverse, std::uint64_t u64Groups )
+				{
+					for ( std::uint64_t g = 0; g < u64Groups; g++ )
+					{
+						for ( std::uint32_t k = 0; k < N; k++ )
+						{
+							*( ( u64Reverse & ( 1ULL << k ) ) ? ( ppDst[ k ] - g ) : ( ppDst[ k ] + g ) ) = pSrc[ ( g * N ) + k ];
+						}
+					}
+				}
+			}
+
+
+#if ARC_DLACE_X86
+
+			// +----------------------------------------------------------------------------------------------------------+
+			// |  SSE2 kernels                                                                                            |
+			// +----------------------------------------------------------------------------------------------------------+
+			#ifdef __GNUC__
+				#pragma GCC push_options
+				#pragma GCC target( "sse2" )
+			#endif
+
+			namespace sse2
+			{
+				template <typename T> struct Vec;
+
+				template <> struct Vec<BPP_16>
+				{
+					using R = __m128i;
+
+					static const std::uint32_t W = 8;
+
+					static inline R load( const BPP_16* p ) { return _mm_loadu_si128( reinterpret_cast< const __m128i* >( p ) ); }
+
+					static inline void store( BPP_16* p, R v ) { _mm_storeu_si128( reinterpret_cast< __m128i* >( p ), v ); }
+
+					static inline R reverse( R v )
+					{
+						return _mm_shuffle_epi32( _mm_shufflehi_epi16( _mm_shufflelo_epi16( v, 0x1B ), 0x1B ), 0x4E );
+					}
+
+					// Sign extending each 16-bit half keeps it in int16 range, so the signed pack is exact
+					static inline void split( R a, R b, R& e, R& o )
+					{
+						e = _mm_packs_epi32( _mm_srai_epi32( _mm_slli_epi32( a, 16 ), 16 ), _mm_srai_epi32( _mm_slli_epi32( b, 16 ), 16 ) );
+						o = _mm_packs_epi32( _mm_srai_epi32( a, 16 ), _mm_srai_epi32( b, 16 ) );
+					}
+				};
+
+				template <> struct Vec<BPP_32>
+				{
+					using R = __m128i;
+
+					static const std::uint32_t W = 4;
+
+					static inline R load( const BPP_32* p ) { return _mm_loadu_si128( reinterpret_cast< const __m128i* >( p ) ); }
+
+					static inline void store( BPP_32* p, R v ) { _mm_storeu_si128( reinterpret_cast< __m128i* >( p ), v ); }
+
+					static inline R reverse( R v ) { return _mm_shuffle_epi32( v, 0x1B ); }
+
+					// Float shuffles only move bits, so any pixel value is preserved
+					static inline void split( R a, R b, R& e, R& o )
+					{
+						e = _mm_castps_si128( _mm_shuffle_ps( _mm_castsi128_ps( a ), _mm_castsi128_ps( b ), _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+						o = _mm_castps_si128( _mm_shuffle_ps( _mm_castsi128_ps( a ), _mm_castsi128_ps( b ), _MM_SHUFFLE( 3, 1, 3, 1 ) ) );
+					}
+				};
+
+				#include "CArcDLaceSimd.inl"
+			}
+
+			#ifdef __GNUC__
+				#pragma GCC pop_options
+			#endif
+
+
+			// +----------------------------------------------------------------------------------------------------------+
+			// |  AVX2 kernels                                                                                            |
+			// +----------------------------------------------------------------------------------------------------------+
+			#ifdef __GNUC__
+				#pragma GCC push_options
+				#pragma GCC target( "avx2" )
+			#endif
+
+			namespace avx2
+			{
+				template <typename T> struct Vec;
+
+				template <> struct Vec<BPP_16>
+				{
+					using R = __m256i;
+
+					static const std::uint32_t W = 16;
+
+					// lddqu rather than loadu: GCC turns a loop of plain unaligned loads into a 128-bit block copy,
+					// which then stalls on store forwarding
+					static inline R load( const BPP_16* p ) { return _mm256_lddqu_si256( reinterpret_cast< const __m256i* >( p ) ); }
+
+					static inline void store( BPP_16* p, R v ) { _mm256_storeu_si256( reinterpret_cast< __m256i* >( p ), v ); }
+
+					static inline R reverse( R v )
+					{
+						const R tMask = _mm256_setr_epi8( 14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1,
+														  14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1 );
+
+						return _mm256_permute4x64_epi64( _mm256_shuffle_epi8( v, tMask ), 0x4E );
+					}
+
+					// The pack works within 128-bit lanes, so the 64-bit halves come out as a0 b0 a1 b1 and are regrouped
+					static inline void split( R a, R b, R& e, R& o )
+					{
+						const R tMask = _mm256_set1_epi32( 0xFFFF );
+
+						e = _mm256_permute4x64_epi64( _mm256_packus_epi32( _mm256_and_si256( a, tMask ), _mm256_and_si256( b, tMask ) ), 0xD8 );
+						o = _mm256_permute4x64_epi64( _mm256_packus_epi32( _mm256_srli_epi32( a, 16 ), _mm256_srli_epi32( b, 16 ) ), 0xD8 );
+					}
+				};
+
+				template <> struct Vec<BPP_32>
+				{
+					using R = __m256i;
+
+					static const std::uint32_t W = 8;
+
+					static inline R load( const BPP_32* p ) { return _mm256_lddqu_si256( reinterpret_cast< const __m256i* >( p ) ); }
+
+					static inline void store( BPP_32* p, R v ) { _mm256_storeu_si256( reinterpret_cast< __m256i* >( p ), v ); }
+
+					static inline R reverse( R v ) { return _mm256_permutevar8x32_epi32( v, _mm256_setr_epi32( 7, 6, 5, 4, 3, 2, 1, 0 ) ); }
+
+					static inline void split( R a, R b, R& e, R& o )
+					{
+						e = _mm256_permute4x64_epi64( _mm256_castps_si256( _mm256_shuffle_ps( _mm256_castsi256_ps( a ), _mm256_castsi256_ps( b ), _MM_SHUFFLE( 2, 0, 2, 0 ) ) ), 0xD8 );
+						o = _mm256_permute4x64_epi64( _mm256_castps_si256( _mm256_shuffle_ps( _mm256_castsi256_ps( a ), _mm256_castsi256_ps( b ), _MM_SHUFFLE( 3, 1, 3, 1 ) ) ), 0xD8 );
+					}
+				};
+
+				#include "CArcDLaceSimd.inl"
+			}
+
+			#ifdef __GNUC__
+				#pragma GCC pop_options
+			#endif
+
+
+			// +----------------------------------------------------------------------------------------------------------+
+			// |  AVX-512 kernels ( AVX512F + AVX512BW )                                                                  |
+			// +----------------------------------------------------------------------------------------------------------+
+			#ifdef __GNUC__
+				#pragma GCC push_options
+				#pragma GCC target( "avx512f,avx512bw" )
+			#endif
+
+			namespace avx512
+			{
+				// Permute indices: even pixels, odd pixels, reversed
+				alignas( 64 ) static const std::uint16_t g_uiEven16[] = { 0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30, 32, 34, 36, 38, 40, 42, 44, 46, 48, 50, 52, 54, 56, 58, 60, 62 };
+				alignas( 64 ) static const std::uint16_t g_uiOdd16[]  = { 1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31, 33, 35, 37, 39, 41, 43, 45, 47, 49, 51, 53, 55, 57, 59, 61, 63 };
+				alignas( 64 ) static const std::uint16_t g_uiRev16[]  = { 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 };
+
+				alignas( 64 ) static const std::uint32_t g_uiEven32[] = { 0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30 };
+				alignas( 64 ) static const std::uint32_t g_uiOdd32[]  = { 1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31 };
+				alignas( 64 ) static const std::uint32_t g_uiRev32[]  = { 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 };
+
+				template <typename T> struct Vec;
+
+				template <> struct Vec<BPP_16>
+				{
+					using R = __m512i;
+
+					static const std::uint32_t W = 32;
+
+					static inline R load( const BPP_16* p ) { return _mm512_loadu_si512( p ); }
+
+					static inline void store( BPP_16* p, R v ) { _mm512_storeu_si512( p, v ); }
+
+					static inline R reverse( R v ) { return _mm512_permutexvar_epi16( _mm512_load_si512( g_uiRev16 ), v ); }
+
+					static inline void split( R a, R b, R& e, R& o )
+					{
+						e = _mm512_permutex2var_epi16( a, _mm512_load_si512( g_uiEven16 ), b );
+						o = _mm512_permutex2var_epi16( a, _mm512_load_si512( g_uiOdd16 ), b );
+					}
+				};
+
+				template <> struct Vec<BPP_32>
+				{
+					using R = __m512i;
+
+					static const std::uint32_t W = 16;
+
+					static inline R load( const BPP_32* p ) { return _mm512_loadu_si512( p ); }
+
+					static inline void store( BPP_32* p, R v ) { _mm512_storeu_si512( p, v ); }
+
+					// Full zero-mask form; the unmasked intrinsic trips -Wmaybe-uninitialized in GCC 12 headers
+					static inline R reverse( R v ) { return _mm512_maskz_permutexvar_epi32( 0xFFFF, _mm512_load_si512( g_uiRev32 ), v ); }
+
+					static inline void split( R a, R b, R& e, R& o )
+					{
+						e = _mm512_permutex2var_epi32( a, _mm512_load_si512( g_uiEven32 ), b );
+						o = _mm512_permutex2var_epi32( a, _mm512_load_si512( g_uiOdd32 ), b );
+					}
+				};
+
+				#include "CArcDLaceSimd.inl"
+			}
+
+			#ifdef __GNUC__
+				#pragma GCC pop_options
+			#endif
+
+#endif	// ARC_DLACE_X86
+
+
+			// +----------------------------------------------------------------------------------------------------------+
+			// |  simdKernels                                                                                             |
+			// +----------------------------------------------------------------------------------------------------------+
+			// |  Returns the kernels for an instruction set. Instruction sets this build has no kernels for fall back    |
+			// |  to the scalar kernels.                                                                                  |
+			// |                                                                                                          |
+			// |  <IN>  -> eSimd - The instruction set.                                                                   |
+			// +----------------------------------------------------------------------------------------------------------+
+			template <typename T> const SimdKernels<T>& simdKernels( arc::gen3::dlace::e_Simd eSimd )
+			{
+				static const SimdKernels<T> tScalar = { scalar::deinterleave<T, 1>, scalar::deinterleave<T, 2>, scalar::deinterleave<T, 4>,
+														scalar::deinterleave<T, 8>, scalar::deinterleave<T, 16>, scalar::deinterleave<T, 32>,
+														scalar::deinterleave<T, 64> };
+
+			#if ARC_DLACE_X86
+
+				static const SimdKernels<T> tSse2 = { sse2::deinterleave<T, 1>, sse2::deinterleave<T, 2>, sse2::deinterleave<T, 4>,
+													  sse2::deinterleaveTwoPass<T, 2, 4>, sse2::deinterleaveTwoPass<T, 4, 4>,
+													  sse2::deinterleaveTwoPass<T, 4, 8>, sse2::deinterleaveTwoPass<T, 4, 16> };
+
+				static const SimdKernels<T> tAvx2 = { avx2::deinterleave<T, 1>, avx2::deinterleave<T, 2>, avx2::deinterleave<T, 4>,
+													  avx2::deinterleaveTwoPass<T, 2, 4>, avx2::deinterleaveTwoPass<T, 4, 4>,
+													  avx2::deinterleaveTwoPass<T, 4, 8>, avx2::deinterleaveTwoPass<T, 4, 16> };
+
+				static const SimdKernels<T> tAvx512 = { avx512::deinterleave<T, 1>, avx512::deinterleave<T, 2>, avx512::deinterleave<T, 4>,
+														avx512::deinterleaveTwoPass<T, 2, 4>, avx512::deinterleaveTwoPass<T, 4, 4>,
+														avx512::deinterleaveTwoPass<T, 4, 8>, avx512::deinterleaveTwoPass<T, 4, 16> };
+
+				switch ( eSimd )
+				{
+					case arc::gen3::dlace::e_Simd::SSE2:	return tSse2;
+					case arc::gen3::dlace::e_Simd::AVX2:	return tAvx2;
+					case arc::gen3::dlace::e_Simd::AVX512:	return tAvx512;
+					default:								break;
+				}
+
+			#endif
+
+				return tScalar;
+			}
+
+
+			// +----------------------------------------------------------------------------------------------------------+
+			// |  simdKernel                                                                                              |
+			// +----------------------------------------------------------------------------------------------------------+
+			// |  Returns the kernel for a stream count, or nullptr if there is no kernel for that count.                 |
+			// |                                                                                                          |
+			// |  <IN>  -> eSimd     - The instruction set.                                                               |
+			// |  <IN>  -> uiStreams - The number of streams.                                                             |
+			// +----------------------------------------------------------------------------------------------------------+
+			template <typename T> DLaceKernel_t<T> simdKernel( arc::gen3::dlace::e_Simd eSimd, std::uint32_t uiStreams )
+			{
+				const SimdKernels<T>& tKernels = simdKernels<T>( eSimd );
+
+				switch ( uiStreams )
+				{
+					case 1:		return tKernels.split1;
+					case 2:		return tKernels.split2;
+					case 4:		return tKernels.split4;
+					case 8:		return tKernels.split8;
+					case 16:	return tKernels.split16;
+					case 32:	return tKernels.split32;
+					case 64:	return tKernels.split64;
+					default:	break;
+				}
+
+				return nullptr;
+			}
+
+
+			// +----------------------------------------------------------------------------------------------------------+
+			// |  deinterleave                                                                                            |
+			// +----------------------------------------------------------------------------------------------------------+
+			// |  Scalar de-interleave for stream counts that have no kernel. See DLaceKernel_t.                          |
+			// |                                                                                                          |
+			// |  <IN>  -> pSrc       - The raw pixels ( uiStreams x u64Groups ).                                         |
+			// |  <OUT> -> ppDst      - The uiStreams output stream pointers.                                             |
+			// |  <IN>  -> uiStreams  - The number of streams ( 1 - MAX_AMPLIFIERS ).                                     |
+			// |  <IN>  -> u64Reverse - Bit k set writes stream k backwards.                                              |
+			// |  <IN>  -> u64Groups  - The number of groups.                                                             |
+			// +----------------------------------------------------------------------------------------------------------+
+			template <typename T>
+			void deinterleave( const T* pSrc, T* const* ppDst, std::uint32_t uiStreams, std::uint64_t u64Reverse, std::uint64_t u64Groups )
+			{
+				for ( std::uint64_t g = 0; g < u64Groups; g++ )
+				{
+					for ( std::uint32_t k = 0; k < uiStreams; k++ )
+					{
+						*( ( u64Reverse & ( 1ULL << k ) ) ? ( ppDst[ k ] - g ) : ( ppDst[ k ] + g ) ) = pSrc[ ( g * uiStreams ) + k ];
+					}
+				}
+			}
+
+
+			// +----------------------------------------------------------------------------------------------------------+
+			// |  simdSupported                                                                                           |
+			// +----------------------------------------------------------------------------------------------------------+
+			// |  Returns the best instruction set supported by both the CPU and the operating system. The result is      |
+			// |  determined once, from CPUID and the saved register state ( XCR0 ).                                      |
+			// +----------------------------------------------------------------------------------------------------------+
+			arc::gen3::dlace::e_Simd simdSupported( void )
+			{
+				static const arc::gen3::dlace::e_Simd eSupported = []()
+				{
+				#if ARC_DLACE_X86 && defined( _MSC_VER )
+
+					int a_iRegs[ 4 ];
+
+					__cpuid( a_iRegs, 0 );
+
+					if ( a_iRegs[ 0 ] < 7 )
+					{
+						return arc::gen3::dlace::e_Simd::SSE2;
+					}
+
+					__cpuid( a_iRegs, 1 );
+
+					bool bAvxOs = ( ( a_iRegs[ 2 ] & ( 1 << 27 ) ) != 0 && ( a_iRegs[ 2 ] & ( 1 << 28 ) ) != 0 );
+
+					auto u64Xcr0 = ( bAvxOs ? _xgetbv( 0 ) : 0 );
+
+					__cpuidex( a_iRegs, 7, 0 );
+
+					if ( ( u64Xcr0 & 0xE6 ) == 0xE6 && ( a_iRegs[ 1 ] & ( 1 << 16 ) ) != 0 && ( a_iRegs[ 1 ] & ( 1 << 30 ) ) != 0 )
+					{
+						return arc::gen3::dlace::e_Simd::AVX512;
+					}
+
+					if ( ( u64Xcr0 & 0x6 ) == 0x6 && ( a_iRegs[ 1 ] & ( 1 << 5 ) ) != 0 )
+					{
+						return arc::gen3::dlace::e_Simd::AVX2;
+					}
+
+					return arc::gen3::dlace::e_Simd::SSE2;
+
+				#elif ARC_DLACE_X86
+
+					__builtin_cpu_init();
+
+					if ( __builtin_cpu_supports( "avx512f" ) && __builtin_cpu_supports( "avx512bw" ) )
+					{
+						return arc::gen3::dlace::e_Simd::AVX512;
+					}
+
+					if ( __builtin_cpu_supports( "avx2" ) )
+					{
+						return arc::gen3::dlace::e_Simd::AVX2;
+					}
+
+					return arc::gen3::dlace::e_Simd::SSE2;
+
+				#else
+
+					return arc::gen3::dlace::e_Simd::SCALAR;
+
+				#endif
+				}();
+
+				return eSupported;
+			}
+
+
+			/** Explicit instantiations */
+			template const SimdKernels<BPP_16>& simdKernels<BPP_16>( arc::gen3::dlace::e_Simd eSimd );
+			template const SimdKernels<BPP_32>& simdKernels<BPP_32>( arc::gen3::dlace::e_Simd eSimd );
+
+			template DLaceKernel_t<BPP_16> simdKernel<BPP_16>( arc::gen3::dlace::e_Simd eSimd, std::uint32_t uiStreams );
+			template DLaceKernel_t<BPP_32> simdKernel<BPP_32>( arc::gen3::dlace::e_Simd eSimd, std::uint32_t uiStreams );
+
+			template void deinterleave<BPP_16>( const BPP_16* pSrc, BPP_16* const* ppDst, std::uint32_t uiStreams, std::uint64_t u64Reverse, std::uint64_t u64Groups );
+			template void deinterleave<BPP_32>( const BPP_32* pSrc, BPP_32* const* ppDst, std::uint32_t uiStreams, std::uint64_t u64Reverse, std::uint64_t u64Groups );
+
+		}	// end dlace namespace
+
+	}		// end gen3 namespace
+}			// end arc namespace
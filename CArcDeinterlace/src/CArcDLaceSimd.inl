@@ -0,0 +1,203 @@
+// +------------------------------------------------------------------------------------------------------------------+
+// |  FILE:  CArcDLaceSimd.inl  ( Gen3 )                                                                              |
+// +------------------------------------------------------------------------------------------------------------------+
+// |  PURPOSE: Generic vector de-interleave kernels. Included by CArcDLaceSimd.cpp once per instruction set, inside   |
+// |           a namespace that defines the vector traits Vec<T> and under the matching target options, so every      |
+// |           instantiation is compiled for that instruction set only. Do not include anywhere else.                 |
+// |                                                                                                                  |
+// |           Vec<T> provides:  R - the register type,  W - pixels per register,  load(),  store(),  reverse()       |
+// |                             and split( a, b, e, o ), which writes the even pixels of [ a b ] to e and the odd    |
+// |                             pixels to o.                                                                         |
+// +------------------------------------------------------------------------------------------------------------------+
+
+
+// +----------------------------------------------------------------------------------------------------------+
+// |  Tree                                                                                                    |
+// +----------------------------------------------------------------------------------------------------------+
+// |  De-interleaves N registers holding W groups of N pixels into N registers, one per stream. Each level    |
+// |  splits register pairs into even and odd pixels, halving the group size, until one pixel is left.        |
+// +----------------------------------------------------------------------------------------------------------+
+template <typename V, std::uint32_t N> struct Tree
+{
+	static inline void run( const typename V::R* pIn, typename V::R* pOut )
+	{
+		typename V::R aEven[ N / 2 ], aOdd[ N / 2 ], aEvenOut[ N / 2 ], aOddOut[ N / 2 ];
+
+		for ( std::uint32_t i = 0; i < ( N / 2 ); i++ )
+		{
+			V::split( pIn[ 2 * i ], pIn[ 2 * i + 1 ], aEven[ i ], aOdd[ i ] );
+		}
+
+		Tree<V, ( N / 2 )>::run( aEven, aEvenOut );
+		Tree<V, ( N / 2 )>::run( aOdd, aOddOut );
+
+		for ( std::uint32_t m = 0; m < ( N / 2 ); m++ )
+		{
+			pOut[ 2 * m ] = aEvenOut[ m ];
+			pOut[ 2 * m + 1 ] = aOddOut[ m ];
+		}
+	}
+};
+
+template <typename V> struct Tree<V, 1>
+{
+	static inline void run( const typename V::R* pIn, typename V::R* pOut )
+	{
+		pOut[ 0 ] = pIn[ 0 ];
+	}
+};
+
+
+// +----------------------------------------------------------------------------------------------------------+
+// |  deinterleave                                                                                            |
+// +----------------------------------------------------------------------------------------------------------+
+// |  N-way de-interleave kernel. See arc::gen3::dlace::DLaceKernel_t. Groups that do not fill a register are |
+// |  copied one pixel at a time.                                                                             |
+// +----------------------------------------------------------------------------------------------------------+
+template <typename T, std::uint32_t N>
+void deinterleave( const T* pSrc, T* const* ppDst, std::uint64_t u64Reverse, std::uint64_t u64Groups )
+{
+	using V = Vec<T>;
+
+	std::uint64_t g = 0;
+
+	for ( ; ( g + V::W ) <= u64Groups; g += V::W )
+	{
+		typename V::R aIn[ N ], aOut[ N ];
+
+		for ( std::uint32_t k = 0; k < N; k++ )
+		{
+			aIn[ k ] = V::load( pSrc + ( g * N ) + ( k * V::W ) );
+		}
+
+		Tree<V, N>::run( aIn, aOut );
+
+		for ( std::uint32_t k = 0; k < N; k++ )
+		{
+			if ( u64Reverse & ( 1ULL << k ) )
+			{
+				V::store( ppDst[ k ] - g - ( V::W - 1 ), V::reverse( aOut[ k ] ) );
+			}
+
+			else
+			{
+				V::store( ppDst[ k ] + g, aOut[ k ] );
+			}
+		}
+	}
+
+	for ( ; g < u64Groups; g++ )
+	{
+		for ( std::uint32_t k = 0; k < N; k++ )
+		{
+			*( ( u64Reverse & ( 1ULL << k ) ) ? ( ppDst[ k ] - g ) : ( ppDst[ k ] + g ) ) = pSrc[ ( g * N ) + k ];
+		}
+	}
+}
+
+
+template <typename T, std::uint32_t N1, std::uint32_t N2>
+void deinterleaveTwoPass( const T* pSrc, T* const* ppDst, std::uint64_t u64Reverse, std::uint64_t u64Groups );
+
+
+// +----------------------------------------------------------------------------------------------------------+
+// |  Split                                                                                                   |
+// +----------------------------------------------------------------------------------------------------------+
+// |  Picks the N-way kernel at compile time. Up to 4 streams fit a register tree; wider splits are built     |
+// |  from two narrower ones, so e.g. 64 streams are split 4-way, then 16-way ( 4 x 4 ) per sub-stream.       |
+// +----------------------------------------------------------------------------------------------------------+
+template <typename T, std::uint32_t N> struct Split
+{
+	static inline void run( const T* pSrc, T* const* ppDst, std::uint64_t u64Reverse, std::uint64_t u64Groups )
+	{
+		deinterleave<T, N>( pSrc, ppDst, u64Reverse, u64Groups );
+	}
+};
+
+template <typename T> struct Split<T, 8>
+{
+	static inline void run( const T* pSrc, T* const* ppDst, std::uint64_t u64Reverse, std::uint64_t u64Groups )
+	{
+		deinterleaveTwoPass<T, 2, 4>( pSrc, ppDst, u64Reverse, u64Groups );
+	}
+};
+
+template <typename T> struct Split<T, 16>
+{
+	static inline void run( const T* pSrc, T* const* ppDst, std::uint64_t u64Reverse, std::uint64_t u64Groups )
+	{
+		deinterleaveTwoPass<T, 4, 4>( pSrc, ppDst, u64Reverse, u64Groups );
+	}
+};
+
+template <typename T> struct Split<T, 32>
+{
+	static inline void run( const T* pSrc, T* const* ppDst, std::uint64_t u64Reverse, std::uint64_t u64Groups )
+	{
+		deinterleaveTwoPass<T, 4, 8>( pSrc, ppDst, u64Reverse, u64Groups );
+	}
+};
+
+template <typename T> struct Split<T, 64>
+{
+	static inline void run( const T* pSrc, T* const* ppDst, std::uint64_t u64Reverse, std::uint64_t u64Groups )
+	{
+		deinterleaveTwoPass<T, 4, 16>( pSrc, ppDst, u64Reverse, u64Groups );
+	}
+};
+
+
+// +----------------------------------------------------------------------------------------------------------+
+// |  deinterleaveTwoPass                                                                                     |
+// +----------------------------------------------------------------------------------------------------------+
+// |  ( N1 x N2 )-way de-interleave kernel. A register tree that wide needs more registers than the CPU has,  |
+// |  so each chunk of groups is split N1-way into a small buffer ( stream m holds pixels m, m + N1, ... of   |
+// |  each group ), which stays in L1 and is then split N2-way again into the output streams.                 |
+// +----------------------------------------------------------------------------------------------------------+
+template <typename T, std::uint32_t N1, std::uint32_t N2>
+void deinterleaveTwoPass( const T* pSrc, T* const* ppDst, std::uint64_t u64Reverse, std::uint64_t u64Groups )
+{
+	const std::uint64_t u64Chunk = 64;
+
+	T aTmp[ N1 ][ u64Chunk * N2 ];
+
+	T* a_pTmp[ N1 ];
+
+	for ( std::uint32_t m = 0; m < N1; m++ )
+	{
+		a_pTmp[ m ] = aTmp[ m ];
+	}
+
+	for ( std::uint64_t g = 0; g < u64Groups; g += u64Chunk )
+	{
+		std::uint64_t u64Count = std::min( u64Chunk, ( u64Groups - g ) );
+
+		Split<T, N1>::run( ( pSrc + ( g * N1 * N2 ) ), a_pTmp, 0, ( u64Count * N2 ) );
+
+		for ( std::uint32_t m = 0; m < N1; m++ )
+		{
+			T* a_pDst[ N2 ];
+
+			std::uint64_t u64SubReverse = 0;
+
+			for ( std::uint32_t q = 0; q < N2; q++ )
+			{
+				std::uint32_t k = ( m + ( N1 * q ) );
+
+				if ( u64Reverse & ( 1ULL << k ) )
+				{
+					a_pDst[ q ] = ( ppDst[ k ] - g );
+
+					u64SubReverse |= ( 1ULL << q );
+				}
+
+				else
+				{
+					a_pDst[ q ] = ( ppDst[ k ] + g );
+				}
+			}
+
+			Split<T, N2>::run( aTmp[ m ], a_pDst, u64SubReverse, u64Count );
+		}
+	}
+}
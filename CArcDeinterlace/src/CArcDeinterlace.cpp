@@ -15,13 +15,19 @@
 #include <iostream>
 #include <iomanip>
 
+#include <algorithm>
 #include <vector>
 #include <string>
+#include <thread>
+#include <mutex>
+#include <exception>
 #include <cstring>
 #include <cmath>
 
 #include <CArcDeinterlace.h>
+#include <CArcDLaceSimd.h>
 #include <IArcPlugin.h>
+#include <CArcTrace.h>
 
 
 
@@ -48,6 +54,13 @@ namespace arc
 		#endif
 
 
+		// +----------------------------------------------------------------------------------------------------------+
+		// | Set on the threads running a partition() range, so a kernel that calls partition() again, such as a      |
+		// | frame of a stack, runs on its own thread instead of starting more.                                       |
+		// +----------------------------------------------------------------------------------------------------------+
+		static thread_local bool g_bInPartition = false;
+
+
 // +----------------------------------------------------------------------------------------------------------+
 // | Library build and version info                                                                           |
 // +----------------------------------------------------------------------------------------------------------+
@@ -65,10 +78,14 @@ namespace arc
 		// +----------------------------------------------------------------------------------------------------------+
 		template <typename T> CArcDeinterlace<T>::CArcDeinterlace( void ) : CArcBase()
 		{
-			m_pPluginManager.reset( new CArcPluginManager() );
+			getPluginManager();
 
 			m_uiNewCols = 0;
 			m_uiNewRows = 0;
+
+			m_uiThreadCount = 1;
+
+			m_eSimd = arc::gen3::dlace::simdSupported();
 		}
 
 
@@ -170,6 +187,9 @@ namespace arc
 		// |                  |       |       |             |                                                         |
 		// |                <-+     <-+     <-+           <-+                                                         |
 		// |                                                                                                          |
+		// |  The image is deinterlaced into an intermediate buffer, which is then copied back over pBuf. Use the     |
+		// |  run( pSrc, pDst, ... ) overload to write directly to another buffer and avoid the copy.                 |
+		// |                                                                                                          |
 		// |  <IN>  -> pBuf		- Pointer to the image pBuf to deinterlace                                            |
 		// |  <IN>  -> uiCols	- Number of uiCols in image to deinterlace                                            |
 		// |  <IN>  -> uiRows	- Number of rows in image to deinterlace                                              |
@@ -180,26 +200,79 @@ namespace arc
 		void CArcDeinterlace<T>::run( T* pBuf, std::uint32_t uiCols, std::uint32_t uiRows, arc::gen3::dlace::e_Alg eAlg,
 									  const std::initializer_list<std::uint32_t>& tArgList )
 		{
-			T* pOldBuf = pBuf;	// Old image buffer pointer
+			ARC_TRACE_SPAN( "CArcDeinterlace::run", "deinterlace" );
 
-			// NOTE ****** Instead of memcpy pOldBuf to m_pNewData, maybe just return the
-			// buffer pointer.
+			if ( pBuf == nullptr )
+			{
+				THROW_INVALID_ARGUMENT( "Invalid image buffer, cannot be nullptr" );
+			}
 
-			// Allocate a new buffer to hold the deinterlaced image
-			// -------------------------------------------------------------------
-			if ( uiCols > m_uiNewCols || uiRows > m_uiNewRows )
+			if ( eAlg == arc::gen3::dlace::e_Alg::NONE )
 			{
-				m_pNewData.reset( new T[ static_cast< std::uint64_t >( uiCols ) * static_cast< std::uint64_t >( uiRows ) ] );
+				return;
+			}
 
-				m_uiNewCols = uiCols;
-				m_uiNewRows = uiRows;
+			reserveNewData( uiCols, uiRows );
+
+			deinterlace( pBuf, m_pNewData.get(), uiCols, uiRows, eAlg, tArgList );
+
+			copyMemory( pBuf, m_pNewData.get(), ( uiCols * uiRows * sizeof( T ) ) );
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// | run                                                                                                      |
+		// +----------------------------------------------------------------------------------------------------------+
+		// | Deinterlaces an image from one buffer into another. The algorithms write straight into pDst, so unlike   |
+		// | the in-place run() there is no intermediate buffer and no full-frame copy back. pDst may be a FITS       |
+		// | write buffer, a pooled frame, etc. If pSrc and pDst are the same buffer the in-place run() is used;      |
+		// | otherwise they must not overlap.                                                                         |
+		// |                                                                                                          |
+		// |  <IN>  -> pSrc		- Pointer to the image to deinterlace                                                 |
+		// |  <OUT> -> pDst		- Pointer to the buffer to receive the deinterlaced image ( uiCols x uiRows pixels )  |
+		// |  <IN>  -> uiCols	- Number of columns in image to deinterlace                                           |
+		// |  <IN>  -> uiRows	- Number of rows in image to deinterlace                                              |
+		// |  <IN>  -> eAlg		- Algorithm number that corresponds to deinterlacing method                           |
+		// |  <IN>  -> tArgList - An optional argument list ( default = {}, empty list }.                             |
+		// +----------------------------------------------------------------------------------------------------------+
+		template <typename T>
+		void CArcDeinterlace<T>::run( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows, arc::gen3::dlace::e_Alg eAlg,
+									  const std::initializer_list<std::uint32_t>& tArgList )
+		{
+			if ( pSrc == nullptr || pDst == nullptr )
+			{
+				THROW_INVALID_ARGUMENT( "Invalid image buffer, cannot be nullptr" );
 			}
 
-			if ( m_pNewData == nullptr || pOldBuf == nullptr )
+			if ( pSrc == pDst )
 			{
-				THROW( "Error in allocating temporary image buffer for deinterlacing." );
+				run( pDst, uiCols, uiRows, eAlg, tArgList );
+
+				return;
 			}
 
+			ARC_TRACE_SPAN( "CArcDeinterlace::run", "deinterlace" );
+
+			deinterlace( pSrc, pDst, uiCols, uiRows, eAlg, tArgList );
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// | deinterlace                                                                                              |
+		// +----------------------------------------------------------------------------------------------------------+
+		// | Runs the specified algorithm from pSrc into pDst. The buffers must not overlap.                          |
+		// |                                                                                                          |
+		// |  <IN>  -> pSrc		- Pointer to the image to deinterlace                                                 |
+		// |  <OUT> -> pDst		- Pointer to the buffer to receive the deinterlaced image                             |
+		// |  <IN>  -> uiCols	- Number of columns in image to deinterlace                                           |
+		// |  <IN>  -> uiRows	- Number of rows in image to deinterlace                                              |
+		// |  <IN>  -> eAlg		- Algorithm number that corresponds to deinterlacing method                           |
+		// |  <IN>  -> tArgList - The algorithm argument list.                                                        |
+		// +----------------------------------------------------------------------------------------------------------+
+		template <typename T>
+		void CArcDeinterlace<T>::deinterlace( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows, arc::gen3::dlace::e_Alg eAlg,
+											  const std::initializer_list<std::uint32_t>& tArgList )
+		{
 			switch ( eAlg )
 			{
 				// +-------------------------------------------------------------------+
@@ -207,8 +280,7 @@ namespace arc
 				// +-------------------------------------------------------------------+
 				case arc::gen3::dlace::e_Alg::NONE:
 				{
-					// Do nothing
-					;
+					std::memcpy( pDst, pSrc, ( static_cast< std::uint64_t >( uiCols ) * static_cast< std::uint64_t >( uiRows ) * sizeof( T ) ) );
 				}
 				break;
 
@@ -217,7 +289,7 @@ namespace arc
 				// +-------------------------------------------------------------------+
 				case arc::gen3::dlace::e_Alg::PARALLEL:
 				{
-					parallel( pOldBuf, uiCols, uiRows );
+					parallel( pSrc, pDst, uiCols, uiRows );
 				}
 				break;
 
@@ -226,7 +298,7 @@ namespace arc
 				// +-------------------------------------------------------------------+
 				case arc::gen3::dlace::e_Alg::SERIAL:
 				{
-					serial( pOldBuf, uiCols, uiRows );
+					serial( pSrc, pDst, uiCols, uiRows );
 				}
 				break;
 
@@ -235,7 +307,7 @@ namespace arc
 				// +-------------------------------------------------------------------+
 				case arc::gen3::dlace::e_Alg::QUAD_CCD:
 				{
-					quadCCD( pOldBuf, uiCols, uiRows );
+					quadCCD( pSrc, pDst, uiCols, uiRows );
 				}
 				break;
 
@@ -244,7 +316,7 @@ namespace arc
 				// +-------------------------------------------------------------------+
 				case arc::gen3::dlace::e_Alg::QUAD_IR:
 				{
-					quadIR( pOldBuf, uiCols, uiRows );
+					quadIR( pSrc, pDst, uiCols, uiRows );
 				}
 				break;
 
@@ -253,7 +325,7 @@ namespace arc
 				// +-------------------------------------------------------------------+
 				case arc::gen3::dlace::e_Alg::QUAD_IR_CDS:
 				{
-					quadIRCDS( pOldBuf, uiCols, uiRows );
+					quadIRCDS( pSrc, pDst, uiCols, uiRows );
 				}
 				break;
 
@@ -267,7 +339,7 @@ namespace arc
 						THROW( "Invalid number of arguments. Expected 1, found: %d", tArgList.size() );
 					}
 
-					hawaiiRG( pOldBuf, uiCols, uiRows, *tArgList.begin() );
+					hawaiiRG( pSrc, pDst, uiCols, uiRows, *tArgList.begin() );
 				}
 				break;
 
@@ -276,7 +348,7 @@ namespace arc
 				// +-------------------------------------------------------------------+
 				case arc::gen3::dlace::e_Alg::STA1600:
 				{
-					sta1600( pOldBuf, uiCols, uiRows );
+					sta1600( pSrc, pDst, uiCols, uiRows );
 				}
 				break;
 
@@ -292,10 +364,187 @@ namespace arc
 		}
 
 
+		// +----------------------------------------------------------------------------------------------------------+
+		// | deinterlace                                                                                              |
+		// +----------------------------------------------------------------------------------------------------------+
+		// | Runs a geometry copy plan. Plan steps write disjoint output runs, so they are split across the threads.  |
+		// | Amplifier counts without a SIMD kernel use the scalar de-interleave.                                     |
+		// |                                                                                                          |
+		// |  <IN>  -> pSrc		- Pointer to the image to deinterlace                                                 |
+		// |  <OUT> -> pDst		- Pointer to the buffer to receive the deinterlaced image                             |
+		// |  <IN>  -> tPlan	- The copy plan                                                                       |
+		// +----------------------------------------------------------------------------------------------------------+
+		template <typename T>
+		void CArcDeinterlace<T>::deinterlace( const T* pSrc, T* pDst, const arc::gen3::dlace::Plan& tPlan )
+		{
+			std::uint32_t uiStreams = static_cast< std::uint32_t >( tPlan.tGeometry.vAmps.size() );
+
+			auto fnSplit = arc::gen3::dlace::simdKernel<T>( m_eSimd, uiStreams );
+
+			partition( tPlan.u64Pixels, static_cast< std::uint32_t >( tPlan.vSrc.size() ), [ & ]( std::uint32_t uiFirst, std::uint32_t uiLast )
+			{
+				T* a_pDst[ arc::gen3::dlace::MAX_AMPLIFIERS ];
+
+				for ( std::uint64_t s = uiFirst; s < uiLast; s++ )
+				{
+					for ( std::uint32_t k = 0; k < uiStreams; k++ )
+					{
+						a_pDst[ k ] = ( pDst + tPlan.vDst[ ( s * uiStreams ) + k ] );
+					}
+
+					if ( fnSplit != nullptr )
+					{
+						fnSplit( ( pSrc + tPlan.vSrc[ s ] ), a_pDst, tPlan.u64Reverse, tPlan.vGroups[ s ] );
+					}
+
+					else
+					{
+						arc::gen3::dlace::deinterleave<T>( ( pSrc + tPlan.vSrc[ s ] ), a_pDst, uiStreams, tPlan.u64Reverse, tPlan.vGroups[ s ] );
+					}
+				}
+			} );
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// | plan                                                                                                     |
+		// +----------------------------------------------------------------------------------------------------------+
+		// | Returns the copy plan for a geometry and image size. The last PLAN_CACHE_SIZE plans are kept, most       |
+		// | recently used first; a miss builds the plan and drops the least recently used one.                       |
+		// |                                                                                                          |
+		// |  <IN>  -> tGeometry - The readout geometry                                                               |
+		// |  <IN>  -> uiCols	 - Number of columns in image to deinterlace                                          |
+		// |  <IN>  -> uiRows	 - Number of rows in image to deinterlace                                             |
+		// |                                                                                                          |
+		// |  Throws std::invalid_argument                                                                            |
+		// +----------------------------------------------------------------------------------------------------------+
+		template <typename T>
+		const arc::gen3::dlace::Plan& CArcDeinterlace<T>::plan( const arc::gen3::dlace::Geometry& tGeometry, std::uint32_t uiCols, std::uint32_t uiRows )
+		{
+			auto it = std::find_if( m_vPlans.begin(), m_vPlans.end(), [ & ]( const std::unique_ptr<arc::gen3::dlace::Plan>& pPlan )
+			{
+				return ( pPlan->uiCols == uiCols && pPlan->uiRows == uiRows && pPlan->tGeometry == tGeometry );
+			} );
+
+			if ( it != m_vPlans.end() )
+			{
+				std::rotate( m_vPlans.begin(), it, ( it + 1 ) );
+			}
+
+			else
+			{
+				std::unique_ptr<arc::gen3::dlace::Plan> pPlan( new arc::gen3::dlace::Plan( arc::gen3::dlace::makePlan( tGeometry, uiCols, uiRows ) ) );
+
+				if ( m_vPlans.size() >= PLAN_CACHE_SIZE )
+				{
+					m_vPlans.pop_back();
+				}
+
+				m_vPlans.insert( m_vPlans.begin(), std::move( pPlan ) );
+			}
+
+			return *m_vPlans.front();
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// | reserveNewData                                                                                           |
+		// +----------------------------------------------------------------------------------------------------------+
+		// | Allocates the intermediate buffer if it is smaller than the image.                                       |
+		// |                                                                                                          |
+		// |  <IN>  -> uiCols	- Number of columns in image to deinterlace                                           |
+		// |  <IN>  -> uiRows	- Number of rows in image to deinterlace                                              |
+		// +----------------------------------------------------------------------------------------------------------+
+		template <typename T> void CArcDeinterlace<T>::reserveNewData( std::uint32_t uiCols, std::uint32_t uiRows )
+		{
+			// Allocate a new buffer to hold the deinterlaced image
+			// -------------------------------------------------------------------
+			if ( uiCols > m_uiNewCols || uiRows > m_uiNewRows )
+			{
+				m_pNewData.reset( new T[ static_cast< std::uint64_t >( uiCols ) * static_cast< std::uint64_t >( uiRows ) ] );
+
+				m_uiNewCols = uiCols;
+				m_uiNewRows = uiRows;
+			}
+
+			if ( m_pNewData == nullptr )
+			{
+				THROW( "Error in allocating temporary image buffer for deinterlacing." );
+			}
+		}
+
+
 		// +----------------------------------------------------------------------------------------------------------+
 		// | run                                                                                                      |
 		// +----------------------------------------------------------------------------------------------------------+
-		// | Calls a custom deinterlace routine that has been loaded through the deinterlace plugin manager.    	  |
+		// | Deinterlaces an image in place using a readout geometry. The image is deinterlaced into the              |
+		// | intermediate buffer, which is then copied back over pBuf. The output is geometry.outputCols( uiCols )    |
+		// | wide, narrower than the raw image if the geometry has prescan or overscan.                               |
+		// |                                                                                                          |
+		// |  <IN>  -> pBuf		 - Pointer to the image to deinterlace                                                |
+		// |  <IN>  -> uiCols	 - Number of columns in image to deinterlace                                          |
+		// |  <IN>  -> uiRows	 - Number of rows in image to deinterlace                                             |
+		// |  <IN>  -> tGeometry - The readout geometry                                                               |
+		// +----------------------------------------------------------------------------------------------------------+
+		template <typename T>
+		void CArcDeinterlace<T>::run( T* pBuf, std::uint32_t uiCols, std::uint32_t uiRows, const arc::gen3::dlace::Geometry& tGeometry )
+		{
+			ARC_TRACE_SPAN( "CArcDeinterlace::run", "deinterlace" );
+
+			if ( pBuf == nullptr )
+			{
+				THROW_INVALID_ARGUMENT( "Invalid image buffer, cannot be nullptr" );
+			}
+
+			const arc::gen3::dlace::Plan& tPlan = plan( tGeometry, uiCols, uiRows );
+
+			reserveNewData( uiCols, uiRows );
+
+			deinterlace( pBuf, m_pNewData.get(), tPlan );
+
+			std::memcpy( pBuf, m_pNewData.get(), ( tPlan.u64Pixels * sizeof( T ) ) );
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// | run                                                                                                      |
+		// +----------------------------------------------------------------------------------------------------------+
+		// | Deinterlaces an image from one buffer into another using a readout geometry. If pSrc and pDst are the    |
+		// | same buffer the in-place run() is used; otherwise they must not overlap.                                 |
+		// |                                                                                                          |
+		// |  <IN>  -> pSrc		 - Pointer to the image to deinterlace                                                |
+		// |  <OUT> -> pDst		 - Pointer to the buffer to receive the deinterlaced image                            |
+		// |  <IN>  -> uiCols	 - Number of columns in image to deinterlace                                          |
+		// |  <IN>  -> uiRows	 - Number of rows in image to deinterlace                                             |
+		// |  <IN>  -> tGeometry - The readout geometry                                                               |
+		// +----------------------------------------------------------------------------------------------------------+
+		template <typename T>
+		void CArcDeinterlace<T>::run( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows, const arc::gen3::dlace::Geometry& tGeometry )
+		{
+			if ( pSrc == nullptr || pDst == nullptr )
+			{
+				THROW_INVALID_ARGUMENT( "Invalid image buffer, cannot be nullptr" );
+			}
+
+			if ( pSrc == pDst )
+			{
+				run( pDst, uiCols, uiRows, tGeometry );
+
+				return;
+			}
+
+			ARC_TRACE_SPAN( "CArcDeinterlace::run", "deinterlace" );
+
+			deinterlace( pSrc, pDst, plan( tGeometry, uiCols, uiRows ) );
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// | run                                                                                                      |
+		// +----------------------------------------------------------------------------------------------------------+
+		// | Calls a custom deinterlace routine that has been loaded through the deinterlace plugin manager. The name |
+		// | is resolved with findAlgorithm() on every call; resolve it once and use the PluginAlg_t run() instead    |
+		// | when deinterlacing many frames.                                                                          |
 		// |                                                                                                          |
 		// |  <IN>  -> pBuf		- Pointer to the image pBuf to deinterlace                                            |
 		// |  <IN>  -> uiCols	- Number of uiCols in image to deinterlace                                            |
@@ -307,36 +556,254 @@ namespace arc
 		void CArcDeinterlace<T>::run( T* pBuf, std::uint32_t uiCols, std::uint32_t uiRows, const std::string& sAlg,
 			const std::initializer_list<std::uint32_t>& tArgList )
 		{
-			if ( m_pPluginManager->pluginLoaded() )
+			run( pBuf, uiCols, uiRows, findAlgorithm( sAlg ), tArgList );
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// | run                                                                                                      |
+		// +----------------------------------------------------------------------------------------------------------+
+		// | Calls a plugin algorithm resolved by findAlgorithm(). Algorithms that cannot run in place deinterlace    |
+		// | into the intermediate buffer, which is then copied back over pBuf.                                       |
+		// |                                                                                                          |
+		// |  <IN>  -> pBuf		- Pointer to the image to deinterlace                                                 |
+		// |  <IN>  -> uiCols	- Number of columns in image to deinterlace                                           |
+		// |  <IN>  -> uiRows	- Number of rows in image to deinterlace                                              |
+		// |  <IN>  -> tAlg		- The plugin algorithm                                                                |
+		// |  <IN>  -> tArgList - An optional argument list ( default = {}, empty list }.                             |
+		// +----------------------------------------------------------------------------------------------------------+
+		template <typename T>
+		void CArcDeinterlace<T>::run( T* pBuf, std::uint32_t uiCols, std::uint32_t uiRows, const arc::gen3::PluginAlg_t& tAlg,
+			const std::initializer_list<std::uint32_t>& tArgList )
+		{
+			ARC_TRACE_SPAN( "CArcDeinterlace::run", "deinterlace" );
+
+			if ( pBuf == nullptr )
 			{
-				bool bSuccess = false;
+				THROW_INVALID_ARGUMENT( "Invalid image buffer, cannot be nullptr" );
+			}
 
-				for ( std::uint32_t j = 0; j < m_pPluginManager->pluginCount(); j++ )
-				{
-					arc::gen3::IArcPlugin* pPlugin = m_pPluginManager->getPluginObject( j );
+			arc::gen3::dlace::PluginJob tJob;
 
-					if ( ( bSuccess = pPlugin->getNameList()->find( sAlg ) ) )
-					{
-						pPlugin->run( pBuf,
-							uiCols,
-							uiRows,
-							( 8 * sizeof( T ) ),
-							sAlg,
-							( tArgList.begin() != tArgList.end() ? *tArgList.begin() : 0 ) );
-
-						break;
-					}
-				}
+			tJob.uiCols		= uiCols;
+			tJob.uiRows		= uiRows;
+			tJob.pArgs		= tArgList.begin();
+			tJob.uiArgCount = static_cast< std::uint32_t >( tArgList.size() );
+
+			if ( ( tAlg.uiCaps & arc::gen3::dlace::PLUGIN_IN_PLACE ) != 0 )
+			{
+				tAlg.pPlugin->run( tAlg.uiAlg, pBuf, pBuf, tJob );
+			}
+
+			else
+			{
+				reserveNewData( uiCols, uiRows );
+
+				tAlg.pPlugin->run( tAlg.uiAlg, pBuf, m_pNewData.get(), tJob );
+
+				std::memcpy( pBuf, m_pNewData.get(), ( static_cast< std::uint64_t >( uiCols ) * uiRows * sizeof( T ) ) );
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// | run                                                                                                      |
+		// +----------------------------------------------------------------------------------------------------------+
+		// | Calls a plugin algorithm resolved by findAlgorithm(), from one buffer into another. If pSrc and pDst are |
+		// | the same buffer the in-place run() is used; otherwise they must not overlap.                             |
+		// |                                                                                                          |
+		// |  <IN>  -> pSrc		- Pointer to the image to deinterlace                                                 |
+		// |  <OUT> -> pDst		- Pointer to the buffer to receive the deinterlaced image                             |
+		// |  <IN>  -> uiCols	- Number of columns in image to deinterlace                                           |
+		// |  <IN>  -> uiRows	- Number of rows in image to deinterlace                                              |
+		// |  <IN>  -> tAlg		- The plugin algorithm                                                                |
+		// |  <IN>  -> tArgList - An optional argument list ( default = {}, empty list }.                             |
+		// +----------------------------------------------------------------------------------------------------------+
+		template <typename T>
+		void CArcDeinterlace<T>::run( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows, const arc::gen3::PluginAlg_t& tAlg,
+			const std::initializer_list<std::uint32_t>& tArgList )
+		{
+			if ( pSrc == nullptr || pDst == nullptr )
+			{
+				THROW_INVALID_ARGUMENT( "Invalid image buffer, cannot be nullptr" );
+			}
+
+			if ( pSrc == pDst )
+			{
+				run( pDst, uiCols, uiRows, tAlg, tArgList );
+
+				return;
+			}
+
+			ARC_TRACE_SPAN( "CArcDeinterlace::run", "deinterlace" );
+
+			arc::gen3::dlace::PluginJob tJob;
+
+			tJob.uiCols		= uiCols;
+			tJob.uiRows		= uiRows;
+			tJob.pArgs		= tArgList.begin();
+			tJob.uiArgCount = static_cast< std::uint32_t >( tArgList.size() );
+
+			tAlg.pPlugin->run( tAlg.uiAlg, pSrc, pDst, tJob );
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// | run                                                                                                      |
+		// +----------------------------------------------------------------------------------------------------------+
+		// | Deinterlaces a stack of frames, e.g. a continuous readout buffer or a FITS cube, using the specified     |
+		// | algorithm. See runFrames() for how the frames are split across the threads.                              |
+		// |                                                                                                          |
+		// |  <IN>  -> pSrc		- Pointer to the frames to deinterlace                                                |
+		// |  <OUT> -> pDst		- Pointer to the buffer to receive the deinterlaced frames, or pSrc                   |
+		// |  <IN>  -> uiCols	- Number of columns in each frame                                                     |
+		// |  <IN>  -> uiRows	- Number of rows in each frame                                                        |
+		// |  <IN>  -> tStack	- The frame count and strides                                                         |
+		// |  <IN>  -> eAlg		- Algorithm number that corresponds to deinterlacing method                           |
+		// |  <IN>  -> tArgList - An optional argument list ( default = {}, empty list }.                             |
+		// +----------------------------------------------------------------------------------------------------------+
+		template <typename T>
+		void CArcDeinterlace<T>::run( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows, const arc::gen3::dlace::FrameStack& tStack,
+									  arc::gen3::dlace::e_Alg eAlg, const std::initializer_list<std::uint32_t>& tArgList )
+		{
+			ARC_TRACE_SPAN( "CArcDeinterlace::run", "deinterlace" );
+
+			if ( pSrc == nullptr || pDst == nullptr )
+			{
+				THROW_INVALID_ARGUMENT( "Invalid image buffer, cannot be nullptr" );
+			}
+
+			if ( eAlg == arc::gen3::dlace::e_Alg::NONE && pSrc == pDst )
+			{
+				return;
+			}
+
+			std::uint64_t u64Pixels = ( static_cast< std::uint64_t >( uiCols ) * static_cast< std::uint64_t >( uiRows ) );
+
+			runFrames( pSrc, pDst, uiCols, uiRows, tStack, u64Pixels, arc::gen3::dlace::PLUGIN_THREAD_SAFE, [ & ]( const T* pFrameSrc, T* pFrameDst )
+			{
+				deinterlace( pFrameSrc, pFrameDst, uiCols, uiRows, eAlg, tArgList );
+			} );
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// | run                                                                                                      |
+		// +----------------------------------------------------------------------------------------------------------+
+		// | Deinterlaces a stack of frames using a readout geometry. The plan is looked up once for all the frames.  |
+		// |                                                                                                          |
+		// |  <IN>  -> pSrc		 - Pointer to the frames to deinterlace                                               |
+		// |  <OUT> -> pDst		 - Pointer to the buffer to receive the deinterlaced frames, or pSrc                  |
+		// |  <IN>  -> uiCols	 - Number of columns in each frame                                                    |
+		// |  <IN>  -> uiRows	 - Number of rows in each frame                                                       |
+		// |  <IN>  -> tStack	 - The frame count and strides                                                        |
+		// |  <IN>  -> tGeometry - The readout geometry                                                               |
+		// +----------------------------------------------------------------------------------------------------------+
+		template <typename T>
+		void CArcDeinterlace<T>::run( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows, const arc::gen3::dlace::FrameStack& tStack,
+									  const arc::gen3::dlace::Geometry& tGeometry )
+		{
+			ARC_TRACE_SPAN( "CArcDeinterlace::run", "deinterlace" );
+
+			if ( pSrc == nullptr || pDst == nullptr )
+			{
+				THROW_INVALID_ARGUMENT( "Invalid image buffer, cannot be nullptr" );
+			}
+
+			const arc::gen3::dlace::Plan& tPlan = plan( tGeometry, uiCols, uiRows );
+
+			runFrames( pSrc, pDst, uiCols, uiRows, tStack, tPlan.u64Pixels, arc::gen3::dlace::PLUGIN_THREAD_SAFE, [ & ]( const T* pFrameSrc, T* pFrameDst )
+			{
+				deinterlace( pFrameSrc, pFrameDst, tPlan );
+			} );
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// | run                                                                                                      |
+		// +----------------------------------------------------------------------------------------------------------+
+		// | Deinterlaces a stack of frames using a plugin algorithm resolved by findAlgorithm(). Contiguous frames   |
+		// | are passed to the plugin in a single call, which may deinterlace them however it likes, unless the       |
+		// | algorithm is thread safe and there are enough frames to split them across the threads. Otherwise the     |
+		// | plugin is called once per frame.                                                                         |
+		// |                                                                                                          |
+		// |  <IN>  -> pSrc		- Pointer to the frames to deinterlace                                                |
+		// |  <OUT> -> pDst		- Pointer to the buffer to receive the deinterlaced frames, or pSrc                   |
+		// |  <IN>  -> uiCols	- Number of columns in each frame                                                     |
+		// |  <IN>  -> uiRows	- Number of rows in each frame                                                        |
+		// |  <IN>  -> tStack	- The frame count and strides                                                         |
+		// |  <IN>  -> tAlg		- The plugin algorithm                                                                |
+		// |  <IN>  -> tArgList - An optional argument list ( default = {}, empty list }.                             |
+		// +----------------------------------------------------------------------------------------------------------+
+		template <typename T>
+		void CArcDeinterlace<T>::run( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows, const arc::gen3::dlace::FrameStack& tStack,
+									  const arc::gen3::PluginAlg_t& tAlg, const std::initializer_list<std::uint32_t>& tArgList )
+		{
+			ARC_TRACE_SPAN( "CArcDeinterlace::run", "deinterlace" );
+
+			if ( pSrc == nullptr || pDst == nullptr )
+			{
+				THROW_INVALID_ARGUMENT( "Invalid image buffer, cannot be nullptr" );
+			}
+
+			std::uint64_t u64Pixels = ( static_cast< std::uint64_t >( uiCols ) * static_cast< std::uint64_t >( uiRows ) );
+
+			arc::gen3::dlace::PluginJob tJob;
 
-				if ( !bSuccess )
+			tJob.uiCols		= uiCols;
+			tJob.uiRows		= uiRows;
+			tJob.pArgs		= tArgList.begin();
+			tJob.uiArgCount = static_cast< std::uint32_t >( tArgList.size() );
+
+			bool bContiguous = ( ( tStack.u64SrcStride == 0 || tStack.u64SrcStride == u64Pixels ) &&
+								 ( tStack.u64DstStride == 0 || tStack.u64DstStride == u64Pixels ) );
+
+			bool bThreaded = ( ( tAlg.uiCaps & arc::gen3::dlace::PLUGIN_THREAD_SAFE ) != 0 && tStack.uiFrames >= std::max( 2U, m_uiThreadCount ) );
+
+			if ( bContiguous && !bThreaded && ( pSrc != pDst || ( tAlg.uiCaps & arc::gen3::dlace::PLUGIN_IN_PLACE ) != 0 ) )
+			{
+				tJob.uiFrames = tStack.uiFrames;
+
+				if ( tJob.uiFrames > 0 )
 				{
-					THROW( "Algorithm [ \'%s\' ] not found!", sAlg.c_str() );
+					tAlg.pPlugin->run( tAlg.uiAlg, pSrc, pDst, tJob );
 				}
+
+				return;
 			}
-			else
+
+			runFrames( pSrc, pDst, uiCols, uiRows, tStack, u64Pixels, tAlg.uiCaps, [ & ]( const T* pFrameSrc, T* pFrameDst )
+			{
+				tAlg.pPlugin->run( tAlg.uiAlg, pFrameSrc, pFrameDst, tJob );
+			} );
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// | findAlgorithm                                                                                            |
+		// +----------------------------------------------------------------------------------------------------------+
+		// | Resolves a plugin algorithm name to the plugin and algorithm index, for the PluginAlg_t run().           |
+		// |                                                                                                          |
+		// |  <IN>  -> sAlg - Algorithm name that corresponds to deinterlacing method                                 |
+		// |                                                                                                          |
+		// |  Throws std::runtime_error                                                                               |
+		// +----------------------------------------------------------------------------------------------------------+
+		template <typename T>
+		const arc::gen3::PluginAlg_t& CArcDeinterlace<T>::findAlgorithm( const std::string& sAlg )
+		{
+			if ( !getPluginManager()->pluginLoaded() )
 			{
 				THROW( "No deinterlace plugins loaded!" );
 			}
+
+			const arc::gen3::PluginAlg_t* pAlg = getPluginManager()->findAlgorithm( sAlg );
+
+			if ( pAlg == nullptr )
+			{
+				THROW( "Algorithm [ \'%s\' ] not found!", sAlg.c_str() );
+			}
+
+			return *pAlg;
 		}
 
 
@@ -364,6 +831,262 @@ namespace arc
 		}
 
 
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  setThreadCount                                                                                          |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Sets the number of threads the built-in algorithms may use. Each algorithm splits its output into       |
+		// |  independent rows, row pairs or quadrant row pairs, so the result is identical for any thread count.     |
+		// |                                                                                                          |
+		// |  <IN>  -> uiCount - The thread count; 0 uses one thread per hardware thread. Default = 1.                |
+		// +----------------------------------------------------------------------------------------------------------+
+		template <typename T> void CArcDeinterlace<T>::setThreadCount( std::uint32_t uiCount )
+		{
+			if ( uiCount == 0 )
+			{
+				uiCount = std::max( 1U, std::thread::hardware_concurrency() );
+			}
+
+			m_uiThreadCount = uiCount;
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  getThreadCount                                                                                          |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Returns the number of threads the built-in algorithms may use.                                          |
+		// +----------------------------------------------------------------------------------------------------------+
+		template <typename T> std::uint32_t CArcDeinterlace<T>::getThreadCount( void )
+		{
+			return m_uiThreadCount;
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  setSimd                                                                                                 |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Sets the instruction set used by the built-in algorithms. Mainly useful for testing and benchmarks;     |
+		// |  the default is the best instruction set the CPU supports.                                               |
+		// |                                                                                                          |
+		// |  <IN>  -> eSimd - The instruction set.                                                                   |
+		// |                                                                                                          |
+		// |  Throws std::invalid_argument                                                                            |
+		// +----------------------------------------------------------------------------------------------------------+
+		template <typename T> void CArcDeinterlace<T>::setSimd( arc::gen3::dlace::e_Simd eSimd )
+		{
+			if ( static_cast< std::uint32_t >( eSimd ) > static_cast< std::uint32_t >( supportedSimd() ) )
+			{
+				THROW_INVALID_ARGUMENT( "Instruction set [ %u ] is not supported by this CPU. Best supported: %u", static_cast< std::uint32_t >( eSimd ), static_cast< std::uint32_t >( supportedSimd() ) );
+			}
+
+			m_eSimd = eSimd;
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  getSimd                                                                                                 |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Returns the instruction set used by the built-in algorithms.                                            |
+		// +----------------------------------------------------------------------------------------------------------+
+		template <typename T> arc::gen3::dlace::e_Simd CArcDeinterlace<T>::getSimd( void )
+		{
+			return m_eSimd;
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  supportedSimd                                                                                           |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Returns the best instruction set supported by the CPU.                                                  |
+		// +----------------------------------------------------------------------------------------------------------+
+		template <typename T> arc::gen3::dlace::e_Simd CArcDeinterlace<T>::supportedSimd( void )
+		{
+			return arc::gen3::dlace::simdSupported();
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  partition                                                                                               |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Runs an algorithm kernel over the blocks [ 0, uiBlocks ), split into contiguous ranges, one per thread. |
+		// |  The calling thread runs the first range. Blocks must write disjoint parts of the output. Fewer threads  |
+		// |  are used for small images, so each thread has at least MIN_THREAD_PIXELS pixels to move. If a thread    |
+		// |  cannot be started, its range is run on the calling thread. A kernel running inside another partition()  |
+		// |  range, e.g. one frame of a stack, runs serially so the thread count is not multiplied. An exception     |
+		// |  thrown by the kernel on any thread is rethrown once all the threads have finished.                      |
+		// |                                                                                                          |
+		// |  <IN>  -> u64Pixels - The number of pixels the kernel moves in total.                                    |
+		// |  <IN>  -> uiBlocks  - The number of independent blocks.                                                  |
+		// |  <IN>  -> fnKernel  - The kernel; called as fnKernel( uiFirstBlock, uiLastBlock ), last exclusive.       |
+		// +----------------------------------------------------------------------------------------------------------+
+		template <typename T> template <typename F>
+		void CArcDeinterlace<T>::partition( std::uint64_t u64Pixels, std::uint32_t uiBlocks, F fnKernel )
+		{
+			std::uint32_t uiThreads = static_cast< std::uint32_t >( std::min< std::uint64_t >( { m_uiThreadCount, uiBlocks, ( u64Pixels / MIN_THREAD_PIXELS ) } ) );
+
+			if ( uiThreads <= 1 || g_bInPartition )
+			{
+				fnKernel( 0, uiBlocks );
+
+				return;
+			}
+
+			std::exception_ptr pError;
+
+			std::mutex tErrorMutex;
+
+			auto fnRange = [ & ]( std::uint32_t uiFirst, std::uint32_t uiLast )
+			{
+				g_bInPartition = true;
+
+				try
+				{
+					fnKernel( uiFirst, uiLast );
+				}
+				catch ( ... )
+				{
+					std::lock_guard<std::mutex> tLock( tErrorMutex );
+
+					if ( pError == nullptr )
+					{
+						pError = std::current_exception();
+					}
+				}
+
+				g_bInPartition = false;
+			};
+
+			auto blockOf = [ & ]( std::uint32_t uiThread )
+			{
+				return static_cast< std::uint32_t >( ( static_cast< std::uint64_t >( uiBlocks ) * uiThread ) / uiThreads );
+			};
+
+			std::vector<std::thread> vThreads;
+
+			vThreads.reserve( uiThreads - 1 );
+
+			for ( std::uint32_t t = 1; t < uiThreads; t++ )
+			{
+				try
+				{
+					vThreads.emplace_back( fnRange, blockOf( t ), blockOf( t + 1 ) );
+				}
+				catch ( const std::system_error& )
+				{
+					fnRange( blockOf( t ), blockOf( t + 1 ) );
+				}
+			}
+
+			fnRange( 0, blockOf( 1 ) );
+
+			for ( auto& tThread : vThreads )
+			{
+				tThread.join();
+			}
+
+			if ( pError != nullptr )
+			{
+				std::rethrow_exception( pError );
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  runFrames                                                                                               |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Runs a single frame kernel over each frame of a stack. The strides are checked once. If the kernel is   |
+		// |  thread safe and there are at least as many frames as threads, whole frames are split across the         |
+		// |  threads with partition() and each frame runs serially, which keeps every thread busy on small frames.   |
+		// |  Otherwise the frames run in turn on the calling thread and each may be split across the threads.        |
+		// |                                                                                                          |
+		// |  In place, a kernel without PLUGIN_IN_PLACE deinterlaces each frame into a scratch frame, which is then  |
+		// |  copied back. Serial runs use the intermediate buffer; each thread allocates its own scratch frame once. |
+		// |                                                                                                          |
+		// |  <IN>  -> pSrc			- Pointer to the frames to deinterlace                                            |
+		// |  <OUT> -> pDst			- Pointer to the buffer to receive the deinterlaced frames, or pSrc               |
+		// |  <IN>  -> uiCols		- Number of columns in each frame                                                 |
+		// |  <IN>  -> uiRows		- Number of rows in each frame                                                    |
+		// |  <IN>  -> tStack		- The frame count and strides                                                     |
+		// |  <IN>  -> u64DstPixels	- Number of pixels in each deinterlaced frame                                     |
+		// |  <IN>  -> uiCaps		- The kernel capabilities, dlace::PLUGIN_THREAD_SAFE and dlace::PLUGIN_IN_PLACE   |
+		// |  <IN>  -> fnFrame		- The kernel; called as fnFrame( pFrameSrc, pFrameDst ).                          |
+		// |                                                                                                          |
+		// |  Throws std::invalid_argument                                                                            |
+		// +----------------------------------------------------------------------------------------------------------+
+		template <typename T> template <typename F>
+		void CArcDeinterlace<T>::runFrames( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows, const arc::gen3::dlace::FrameStack& tStack,
+											std::uint64_t u64DstPixels, std::uint32_t uiCaps, F fnFrame )
+		{
+			std::uint64_t u64SrcPixels = ( static_cast< std::uint64_t >( uiCols ) * static_cast< std::uint64_t >( uiRows ) );
+
+			bool bInPlace = ( pSrc == pDst );
+
+			std::uint64_t u64SrcStride = ( tStack.u64SrcStride != 0 ? tStack.u64SrcStride : u64SrcPixels );
+
+			std::uint64_t u64DstStride = ( tStack.u64DstStride != 0 ? tStack.u64DstStride : ( bInPlace ? u64SrcStride : u64DstPixels ) );
+
+			if ( u64SrcStride < u64SrcPixels )
+			{
+				THROW_INVALID_ARGUMENT( "Invalid source frame stride [ %J ], must be at least %J pixels", static_cast<unsigned long long>( u64SrcStride ), static_cast<unsigned long long>( u64SrcPixels ) );
+			}
+
+			if ( u64DstStride < u64DstPixels )
+			{
+				THROW_INVALID_ARGUMENT( "Invalid destination frame stride [ %J ], must be at least %J pixels", static_cast<unsigned long long>( u64DstStride ), static_cast<unsigned long long>( u64DstPixels ) );
+			}
+
+			if ( bInPlace && u64DstStride != u64SrcStride )
+			{
+				THROW_INVALID_ARGUMENT( "Invalid destination frame stride [ %J ], must equal the source stride [ %J ] in place", static_cast<unsigned long long>( u64DstStride ), static_cast<unsigned long long>( u64SrcStride ) );
+			}
+
+			bool bDirect = ( !bInPlace || ( uiCaps & arc::gen3::dlace::PLUGIN_IN_PLACE ) != 0 );
+
+			auto fnRun = [ & ]( std::uint32_t uiFrame, T* pScratch )
+			{
+				const T* pFrameSrc = ( pSrc + ( uiFrame * u64SrcStride ) );
+
+				T* pFrameDst = ( pDst + ( uiFrame * u64DstStride ) );
+
+				if ( bDirect )
+				{
+					fnFrame( pFrameSrc, pFrameDst );
+				}
+
+				else
+				{
+					fnFrame( pFrameSrc, pScratch );
+
+					std::memcpy( pFrameDst, pScratch, ( u64DstPixels * sizeof( T ) ) );
+				}
+			};
+
+			if ( ( uiCaps & arc::gen3::dlace::PLUGIN_THREAD_SAFE ) == 0 || tStack.uiFrames < std::max( 2U, m_uiThreadCount ) )
+			{
+				if ( !bDirect )
+				{
+					reserveNewData( uiCols, uiRows );
+				}
+
+				for ( std::uint32_t f = 0; f < tStack.uiFrames; f++ )
+				{
+					fnRun( f, m_pNewData.get() );
+				}
+
+				return;
+			}
+
+			partition( ( u64SrcPixels * tStack.uiFrames ), tStack.uiFrames, [ & ]( std::uint32_t uiFirst, std::uint32_t uiLast )
+			{
+				std::unique_ptr<T[]> pScratch( bDirect ? nullptr : new T[ u64DstPixels ] );
+
+				for ( std::uint32_t f = uiFirst; f < uiLast; f++ )
+				{
+					fnRun( f, pScratch.get() );
+				}
+			} );
+		}
+
+
 		// +----------------------------------------------------------------------------------------------------------+
 		// | parallel                                                                                                 |
 		// +----------------------------------------------------------------------------------------------------------+
@@ -384,20 +1107,28 @@ namespace arc
 		// |  <IN>  -> uiCols - Number of columns in image to deinterlace                                             |
 		// |  <IN>  -> uiRows - Number of rows in image to deinterlace                                                |
 		// +----------------------------------------------------------------------------------------------------------+
-		template <typename T> void CArcDeinterlace<T>::parallel( T* pBuf, std::uint32_t uiCols, std::uint32_t uiRows )
+		template <typename T> void CArcDeinterlace<T>::parallel( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows )
 		{
 			if ( ( uiRows % 2 ) != 0 )
 			{
 				THROW( "Number of ROWS must be EVEN for PARALLEL deinterlace." );
 			}
 
-			for ( std::uint64_t i = 0; i < ( ( uiCols * uiRows ) / 2 ); i++ )
+			std::uint64_t u64Pixels = ( static_cast< std::uint64_t >( uiCols ) * static_cast< std::uint64_t >( uiRows ) );
+
+			auto fnSplit = arc::gen3::dlace::simdKernels<T>( m_eSimd ).split2;
+
+			//
+			// Each block fills one row from the bottom, and one row backwards from the top
+			//
+			partition( u64Pixels, ( uiRows / 2 ), [ & ]( std::uint32_t uiFirst, std::uint32_t uiLast )
 			{
-				*( m_pNewData.get() + i ) = *( pBuf + ( 2 * i ) );
-				*( m_pNewData.get() + ( static_cast< std::uint64_t >( uiCols ) * static_cast< std::uint64_t >( uiRows ) ) - i - 1 ) = *( pBuf + ( 2 * i ) + 1 );
-			}
+				std::uint64_t i = ( static_cast< std::uint64_t >( uiFirst ) * uiCols );
 
-			copyMemory( pBuf, m_pNewData.get(), ( uiCols * uiRows * sizeof( T ) ) );
+				T* a_pDst[] = { ( pDst + i ), ( pDst + u64Pixels - i - 1 ) };
+
+				fnSplit( ( pSrc + ( 2 * i ) ), a_pDst, 0x2, ( static_cast< std::uint64_t >( uiLast - uiFirst ) * uiCols ) );
+			} );
 		}
 
 
@@ -417,44 +1148,31 @@ namespace arc
 		// |                |<-------- | -------->|                                                                   |
 		// |                +----------+----------+                                                                   |   	
 		// |                                                                                                          |
-		// |  <IN>  -> pBuf   - Pointer to the image pixels to deinterlace                                            |
+		// |  <IN>  -> pSrc   - Pointer to the image pixels to deinterlace                                            |
 		// |  <IN>  -> uiCols - Number of columns in image to deinterlace                                             |
 		// |  <IN>  -> uiRows - Number of rows in image to deinterlace                                                |
 		// +----------------------------------------------------------------------------------------------------------+
-		template <typename T> void CArcDeinterlace<T>::serial( T* pBuf, std::uint32_t uiCols, std::uint32_t uiRows )
+		template <typename T> void CArcDeinterlace<T>::serial( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows )
 		{
-			std::uint32_t p1 = 0;
-			std::uint32_t p2 = 0;
-			std::uint32_t begin = 0;
-			std::uint32_t end = 0;
-
 			if ( ( uiCols % 2 ) != 0 )
 			{
 				THROW( "Number of COLS must be EVEN for SERIAL deinterlace." );
 			}
 
-			for ( decltype( uiRows ) i = 0; i < uiRows; i++ )
-			{
-				// Leave in +0 for clarity
-				p1 = i * uiCols + 0;	// Position in raw image
-				p2 = i * uiCols + 1;
-				begin = i * uiCols + 0;	// Position in deinterlaced image
-				end = i * uiCols + uiCols - 1;
+			auto fnSplit = arc::gen3::dlace::simdKernels<T>( m_eSimd ).split2;
 
-				for ( decltype( uiCols ) j = 0; j < uiCols; j += 2 )
+			//
+			// Even pixels fill the row forwards, odd pixels fill it backwards from the end
+			//
+			partition( ( static_cast< std::uint64_t >( uiCols ) * static_cast< std::uint64_t >( uiRows ) ), uiRows, [ & ]( std::uint32_t uiFirst, std::uint32_t uiLast )
+			{
+				for ( std::uint64_t i = uiFirst; i < uiLast; i++ )
 				{
-					*( m_pNewData.get() + begin ) = *( pBuf + p1 );
-					*( m_pNewData.get() + end ) = *( pBuf + p2 );
+					T* a_pDst[] = { ( pDst + i * uiCols ), ( pDst + i * uiCols + uiCols - 1 ) };
 
-					++begin;
-					--end;
-
-					p1 += 2;
-					p2 += 2;
+					fnSplit( ( pSrc + i * uiCols ), a_pDst, 0x2, ( uiCols / 2 ) );
 				}
-			}
-
-			copyMemory( pBuf, m_pNewData.get(), ( uiCols * uiRows * sizeof( T ) ) );
+			} );
 		}
 
 
@@ -474,44 +1192,43 @@ namespace arc
 		// |                | <--------|--------> |                                                                   |  	
 		// |                +----------+----------+                                                                   |   	
 		// |                                                                                                          |
-		// |  <IN>  -> pBuf   - Pointer to the image pixels to deinterlace                                            |
+		// |  Each block reads two raw rows and writes two output rows, so only five sequential streams are live      |
+		// |  at a time and the working set is already a strip of rows. On 8k-wide frames, staging strips through a   |
+		// |  cache-resident buffer, streaming stores and software prefetch measured no faster than direct writes.    |
+		// |                                                                                                          |
+		// |  <IN>  -> pSrc   - Pointer to the image pixels to deinterlace                                            |
 		// |  <IN>  -> uiCols - Number of columns in image to deinterlace                                             |
 		// |  <IN>  -> uiRows - Number of rows in image to deinterlace                                                |
 		// +----------------------------------------------------------------------------------------------------------+
-		template <typename T> void CArcDeinterlace<T>::quadCCD( T* pBuf, std::uint32_t uiCols, std::uint32_t uiRows )
+		template <typename T> void CArcDeinterlace<T>::quadCCD( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows )
 		{
-			std::uint32_t i = 0;
-			std::uint32_t j = 0;
-			std::uint32_t counter = 0;
-			std::uint32_t end = 0;
-			std::uint32_t begin = 0;
-
 			if ( ( uiCols % 2 ) != 0 || ( uiRows % 2 ) != 0 )
 			{
 				THROW( "Number of COLS and ROWS must be EVEN for QUAD CCD deinterlace." );
 			}
 
-			while ( i < ( uiCols * uiRows ) )
+			std::uint64_t u64Pixels = ( static_cast< std::uint64_t >( uiCols ) * static_cast< std::uint64_t >( uiRows ) );
+
+			auto fnSplit = arc::gen3::dlace::simdKernels<T>( m_eSimd ).split4;
+
+			//
+			// Block j reads 2 x uiCols raw pixels into row j and row ( uiRows - j - 1 )
+			//
+			partition( u64Pixels, ( uiRows / 2 ), [ & ]( std::uint32_t uiFirst, std::uint32_t uiLast )
 			{
-				if ( counter % ( uiCols / 2 ) == 0 )
+				for ( std::uint64_t j = uiFirst; j < uiLast; j++ )
 				{
-					end = ( uiCols * uiRows ) - ( uiCols * j ) - 1;
-					begin = ( uiCols * j ) + 0;	// Left in 0 for clarity
+					std::uint64_t begin = ( uiCols * j ) + 0;	// Left in 0 for clarity
+					std::uint64_t end = u64Pixels - ( uiCols * j ) - 1;
 
-					j++;							// Number of completed rows
+					T* a_pDst[] = { ( pDst + begin ),					// front_row--->
+									( pDst + begin + uiCols - 1 ),		// front_row<--
+									( pDst + end ),						// end_row<----
+									( pDst + end - uiCols + 1 ) };		// end_row---->
 
-					counter = 0;					// Reset for next convergece
+					fnSplit( ( pSrc + ( 2 * j * uiCols ) ), a_pDst, 0x6, ( uiCols / 2 ) );
 				}
-
-				*( m_pNewData.get() + begin + counter ) = *( pBuf + i++ );		// front_row--->
-				*( m_pNewData.get() + begin + uiCols - 1 - counter ) = *( pBuf + i++ );		// front_row<--
-				*( m_pNewData.get() + end - counter ) = *( pBuf + i++ );		// end_row<----
-				*( m_pNewData.get() + end - uiCols + 1 + counter ) = *( pBuf + i++ );		// end_row---->
-
-				counter++;
-			}
-
-			copyMemory( pBuf, m_pNewData.get(), ( uiCols * uiRows * sizeof( T ) ) );
+			} );
 		}
 
 
@@ -531,44 +1248,39 @@ namespace arc
 		// |                | -------> |--------> |                                                                   |  	
 		// |                +----------+----------+                                                                   |   	
 		// |                                                                                                          |
-		// |  <IN>  -> pBuf   - Pointer to the image pixels to deinterlace                                            |
+		// |  Same access pattern as quadCCD; see the note there.                                                     |
+		// |                                                                                                          |
+		// |  <IN>  -> pSrc   - Pointer to the image pixels to deinterlace                                            |
 		// |  <IN>  -> uiCols - Number of columns in image to deinterlace                                             |
 		// |  <IN>  -> uiRows - Number of rows in image to deinterlace                                                |
 		// +----------------------------------------------------------------------------------------------------------+
-		template <typename T> void CArcDeinterlace<T>::quadIR( T* pBuf, std::uint32_t uiCols, std::uint32_t uiRows )
+		template <typename T> void CArcDeinterlace<T>::quadIR( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows )
 		{
-			std::uint32_t i = 0;
-			std::uint32_t j = uiRows - 1;
-			std::uint32_t counter = 0;
-			std::uint32_t end = 0;
-			std::uint32_t begin = 0;
-
 			if ( ( uiCols % 2 ) != 0 || ( uiRows % 2 ) != 0 )
 			{
 				THROW( "Number of COLS and ROWS must be EVEN for QUAD IR deinterlace." );
 			}
 
-			while ( i < ( uiCols * uiRows ) )
+			auto fnSplit = arc::gen3::dlace::simdKernels<T>( m_eSimd ).split4;
+
+			//
+			// Block k reads 2 x uiCols raw pixels into row ( uiRows - k - 1 ) and row ( uiRows / 2 - k - 1 )
+			//
+			partition( ( static_cast< std::uint64_t >( uiCols ) * static_cast< std::uint64_t >( uiRows ) ), ( uiRows / 2 ), [ & ]( std::uint32_t uiFirst, std::uint32_t uiLast )
 			{
-				if ( counter % ( uiCols / 2 ) == 0 )
+				for ( std::uint64_t k = uiFirst; k < uiLast; k++ )
 				{
-					end = ( j - ( uiRows / 2 ) ) * uiCols;
-					begin = j * uiCols;
+					std::uint64_t begin = ( uiRows - k - 1 ) * uiCols;
+					std::uint64_t end = ( ( uiRows / 2 ) - k - 1 ) * uiCols;
 
-					j--; 						// Nnumber of completed rows
+					T* a_pDst[] = { ( pDst + begin ),						// front_row--->
+									( pDst + begin + ( uiCols / 2 ) ),		// front_row<--
+									( pDst + end + ( uiCols / 2 ) ),		// end_row<----
+									( pDst + end ) };						// end_row---->
 
-					counter = 0; 				// Reset for next convergece
+					fnSplit( ( pSrc + ( 2 * k * uiCols ) ), a_pDst, 0, ( uiCols / 2 ) );
 				}
-
-				*( m_pNewData.get() + begin + counter ) = *( pBuf + i++ );	// front_row--->
-				*( m_pNewData.get() + begin + ( uiCols / 2 ) + counter ) = *( pBuf + i++ );	// front_row<--
-				*( m_pNewData.get() + end + ( uiCols / 2 ) + counter ) = *( pBuf + i++ );	// end_row<----
-				*( m_pNewData.get() + end + counter ) = *( pBuf + i++ );	// end_row---->
-
-				counter++;
-			}
-
-			copyMemory( pBuf, m_pNewData.get(), ( uiCols * uiRows * sizeof( T ) ) );
+			} );
 		}
 
 
@@ -597,65 +1309,56 @@ namespace arc
 		// |                | -------> |--------> |                                                                   |  	
 		// |                +----------+----------+                                                                   |   	
 		// |                                                                                                          |
-		// |  <IN>  -> pBuf   - Pointer to the image pixels to deinterlace                                            |
+		// |  Same access pattern as quadCCD within each half; see the note there.                                    |
+		// |                                                                                                          |
+		// |  Each half is deinterlaced as a quad IR image, which needs an even number of rows, so the row count      |
+		// |  must be a multiple of four. Otherwise part of the first row of each half is never written.              |
+		// |                                                                                                          |
+		// |  <IN>  -> pSrc   - Pointer to the image pixels to deinterlace                                            |
 		// |  <IN>  -> uiCols - Number of columns in image to deinterlace                                             |
 		// |  <IN>  -> uiRows - Number of rows in image to deinterlace                                                |
 		// +----------------------------------------------------------------------------------------------------------+
-		template <typename T> void CArcDeinterlace<T>::quadIRCDS( T* pBuf, std::uint32_t uiCols, std::uint32_t uiRows )
+		template <typename T> void CArcDeinterlace<T>::quadIRCDS( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows )
 		{
-			std::uint32_t i = 0;
-			std::uint32_t j = 0;
-			std::uint32_t counter = 0;
-			std::uint32_t end = 0;
-			std::uint32_t begin = 0;
-			std::uint32_t oldRows = 0;
-
-			T* pOldStart = pBuf;
-			T* pNewStart = m_pNewData.get();
-
-			if ( ( uiCols % 2 ) != 0 || ( uiRows % 2 ) != 0 )
+			if ( ( uiCols % 2 ) != 0 || ( uiRows % 4 ) != 0 )
 			{
-				THROW( "Number of COLS and ROWS must be EVEN for QUAD IR CDS deinterlace." );
+				THROW( "Number of COLS must be EVEN and ROWS a MULTIPLE of 4 for QUAD IR CDS deinterlace." );
 			}
 
 			// Set the the number of rows to half the image size.
-			oldRows = uiRows;
 			uiRows = ( uiRows / 2 );
 
-			// Deinterlace the two image halves separately.
-			for ( int imageSection = 0; imageSection < 2; imageSection++ )
-			{
-				i = 0;
-				j = uiRows - 1;
-				counter = 0;
-				end = 0;
-				begin = 0;
+			std::uint64_t u64Section = ( static_cast< std::uint64_t >( uiRows ) * static_cast< std::uint64_t >( uiCols ) );
 
-				while ( i < ( uiCols * uiRows ) )
-				{
-					if ( ( counter % ( uiCols / 2 ) ) == 0 )
-					{
-						end = ( j - ( uiRows / 2 ) ) * uiCols;
-						begin = j * uiCols;
+			//
+			// Deinterlace the two image halves separately, each as a quad IR image
+			//
+			std::uint32_t uiSectionBlocks = ( uiRows / 2 );
 
-						j--; 			// Number of completed rows
+			auto fnSplit = arc::gen3::dlace::simdKernels<T>( m_eSimd ).split4;
 
-						counter = 0; 	// Reset for next convergece
-					}
+			partition( ( 2 * u64Section ), ( 2 * uiSectionBlocks ), [ & ]( std::uint32_t uiFirst, std::uint32_t uiLast )
+			{
+				for ( std::uint32_t uiBlock = uiFirst; uiBlock < uiLast; uiBlock++ )
+				{
+					std::uint64_t k = ( uiBlock % uiSectionBlocks );
 
-					*( pNewStart + begin + counter ) = *( pOldStart + i++ );		// front_row--->
-					*( pNewStart + begin + ( uiCols / 2 ) + counter ) = *( pOldStart + i++ );		// front_row<--
-					*( pNewStart + end + ( uiCols / 2 ) + counter ) = *( pOldStart + i++ );		// end_row<----
-					*( pNewStart + end + counter ) = *( pOldStart + i++ );		// end_row---->
+					const T* pOldStart = pSrc + ( ( uiBlock / uiSectionBlocks ) * u64Section );
+					T* pNewStart = pDst + ( ( uiBlock / uiSectionBlocks ) * u64Section );
 
-					counter++;
-				}
+					std::uint64_t i = ( 2 * k * uiCols );
+					std::uint64_t j = ( uiRows - k - 1 );
+					std::uint64_t begin = j * uiCols;
+					std::uint64_t end = ( j - ( uiRows / 2 ) ) * uiCols;
 
-				pOldStart += ( static_cast< std::uint64_t >( uiRows ) * static_cast< std::uint64_t >( uiCols ) );
-				pNewStart += ( static_cast< std::uint64_t >( uiRows ) * static_cast< std::uint64_t >( uiCols ) );
-			}
+					T* a_pDst[] = { ( pNewStart + begin ),						// front_row--->
+									( pNewStart + begin + ( uiCols / 2 ) ),		// front_row<--
+									( pNewStart + end + ( uiCols / 2 ) ),		// end_row<----
+									( pNewStart + end ) };						// end_row---->
 
-			copyMemory( pBuf, m_pNewData.get(), ( uiCols * oldRows * sizeof( T ) ) );
+					fnSplit( ( pOldStart + i ), a_pDst, 0, ( uiCols / 2 ) );
+				}
+			} );
 		}
 
 
@@ -675,13 +1378,13 @@ namespace arc
 		// |              | ----> | ----> | ----> | ----> |                                                           |
 		// |              +-------+-------+-------+-------+                                                           |
 		// |                                                                                                          |
-		// |  <IN>  -> pBuf      - Pointer to the image pixels to deinterlace                                         |
+		// |  <IN>  -> pSrc      - Pointer to the image pixels to deinterlace                                         |
 		// |  <IN>  -> uiCols    - Number of columns in image to deinterlace                                          |
 		// |  <IN>  -> uiRows    - Number of rows in image to deinterlace                                             |
 		// |  <IN>  -> uChannels - The number of channels in the image (16, 32, ..)                                   |
 		// +----------------------------------------------------------------------------------------------------------+
 		template <typename T>
-		void CArcDeinterlace<T>::hawaiiRG( T* pBuf, std::uint32_t uiCols, std::uint32_t uiRows, std::uint32_t uChannels )
+		void CArcDeinterlace<T>::hawaiiRG( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows, std::uint32_t uChannels )
 		{
 			const std::uint32_t ERR = 0x00455252;
 
@@ -694,6 +1397,7 @@ namespace arc
 			{
 				// Ignore and don't de-interlace. Bob requested this
 				// action on March 30, 2012.
+				std::memcpy( pDst, pSrc, ( static_cast< std::uint64_t >( uiCols ) * static_cast< std::uint64_t >( uiRows ) * sizeof( T ) ) );
 			}
 
 			else if ( uChannels == ERR )
@@ -708,25 +1412,60 @@ namespace arc
 
 			else
 			{
-				T* pRow = m_pNewData.get();
-
 				std::uint32_t offset = uiCols / uChannels;
-				std::uint32_t dataIndex = 0;
 
-				for ( std::uint64_t r = 0; r < uiRows; r++ )
-				{
-					pRow = m_pNewData.get() + ( uiCols * r );
+				//
+				// Common channel counts ( 2, 4, 8, 16, 32, 64 ) have a kernel built for that count, with the channel
+				// loop unrolled at compile time. Each row is one kernel call, into a line buffer that stays in cache
+				// ( channel i fills columns i x offset on ), which is then copied out in one sequential write; that
+				// is 1.5 - 2x faster than writing 32 or 64 output runs at once straight to the image.
+				//
+				auto fnSplit = arc::gen3::dlace::simdKernel<T>( m_eSimd, uChannels );
 
-					for ( decltype( uiCols ) c = 0; c < ( uiCols / uChannels ); c++ )
+				if ( fnSplit != nullptr )
+				{
+					partition( ( static_cast< std::uint64_t >( uiCols ) * static_cast< std::uint64_t >( uiRows ) ), uiRows, [ & ]( std::uint32_t uiFirst, std::uint32_t uiLast )
 					{
+						T* a_pDst[ 64 ];
+
+						std::unique_ptr<T[]> pLine( new T[ uiCols ] );
+
 						for ( decltype( uChannels ) i = 0; i < uChannels; i++ )
 						{
-							pRow[ c + i * offset ] = pBuf[ dataIndex++ ];
+							a_pDst[ i ] = pLine.get() + ( i * offset );
 						}
-					}
+
+						for ( std::uint64_t r = uiFirst; r < uiLast; r++ )
+						{
+							fnSplit( ( pSrc + ( r * offset * uChannels ) ), a_pDst, 0, offset );
+
+							std::memcpy( ( pDst + ( uiCols * r ) ), pLine.get(), ( static_cast< std::uint64_t >( offset ) * uChannels * sizeof( T ) ) );
+						}
+					} );
+
+					return;
 				}
 
-				copyMemory( pBuf, m_pNewData.get(), ( uiCols * uiRows * sizeof( T ) ) );
+				partition( ( static_cast< std::uint64_t >( uiCols ) * static_cast< std::uint64_t >( uiRows ) ), uiRows, [ & ]( std::uint32_t uiFirst, std::uint32_t uiLast )
+				{
+					//
+					// Each row consumes ( offset x uChannels ) raw pixels
+					//
+					std::uint64_t dataIndex = ( static_cast< std::uint64_t >( uiFirst ) * offset * uChannels );
+
+					for ( std::uint64_t r = uiFirst; r < uiLast; r++ )
+					{
+						T* pRow = pDst + ( uiCols * r );
+
+						for ( decltype( uiCols ) c = 0; c < offset; c++ )
+						{
+							for ( decltype( uChannels ) i = 0; i < uChannels; i++ )
+							{
+								pRow[ c + i * offset ] = pSrc[ dataIndex++ ];
+							}
+						}
+					}
+				} );
 			}
 		}
 
@@ -752,11 +1491,11 @@ namespace arc
 		// |                  |       |       |             |                                                         |
 		// |                <-+     <-+     <-+           <-+                                                         |
 		// |                                                                                                          |
-		// |  <IN>  -> pBuf   - Pointer to the image pixels to deinterlace                                            |
+		// |  <IN>  -> pSrc   - Pointer to the image pixels to deinterlace                                            |
 		// |  <IN>  -> uiCols - Number of columns in image to deinterlace                                             |
 		// |  <IN>  -> uiRows - Number of rows in image to deinterlace                                                |
 		// +----------------------------------------------------------------------------------------------------------+
-		template <typename T> void CArcDeinterlace<T>::sta1600( T* pBuf, std::uint32_t uiCols, std::uint32_t uiRows )
+		template <typename T> void CArcDeinterlace<T>::sta1600( const T* pSrc, T* pDst, std::uint32_t uiCols, std::uint32_t uiRows )
 		{
 			if ( ( uiCols % 16 ) != 0 )
 			{
@@ -768,40 +1507,33 @@ namespace arc
 				THROW( "Number of ROWS must be a multiple of 2 for STA1600 deinterlace." );
 			}
 
-			T* botPtr = m_pNewData.get();
-			T* topPtr = m_pNewData.get() + ( static_cast< std::uint64_t >( uiCols ) * static_cast< std::uint64_t >( uiRows - 1 ) );
-
 			std::uint32_t offset = uiCols / 8;
-			std::uint32_t dataIndex = 0;
 
-			for ( std::uint64_t r = 0; r < ( uiRows / 2 ); r++ )
-			{
-				topPtr = m_pNewData.get() + ( uiCols * ( uiRows - r - 1 ) );
-				botPtr = m_pNewData.get() + ( uiCols * r );
+			auto fnSplit = arc::gen3::dlace::simdKernels<T>( m_eSimd ).split16;
 
-				for ( decltype( uiCols ) c = 0; c < ( uiCols / 8 ); c++ )
+			//
+			// Block r reads 2 x uiCols raw pixels into row r and row ( uiRows - r - 1 ). Each group of 16 pixels
+			// holds one pixel for each of the 8 channels of the bottom row, then of the top row, in reverse
+			// channel order.
+			//
+			partition( ( static_cast< std::uint64_t >( uiCols ) * static_cast< std::uint64_t >( uiRows ) ), ( uiRows / 2 ), [ & ]( std::uint32_t uiFirst, std::uint32_t uiLast )
+			{
+				for ( std::uint64_t r = uiFirst; r < uiLast; r++ )
 				{
-					botPtr[ c + 7 * offset ] = pBuf[ dataIndex++ ];
-					botPtr[ c + 6 * offset ] = pBuf[ dataIndex++ ];
-					botPtr[ c + 5 * offset ] = pBuf[ dataIndex++ ];
-					botPtr[ c + 4 * offset ] = pBuf[ dataIndex++ ];
-					botPtr[ c + 3 * offset ] = pBuf[ dataIndex++ ];
-					botPtr[ c + 2 * offset ] = pBuf[ dataIndex++ ];
-					botPtr[ c + 1 * offset ] = pBuf[ dataIndex++ ];
-					botPtr[ c + 0 * offset ] = pBuf[ dataIndex++ ];
-
-					topPtr[ c + 7 * offset ] = pBuf[ dataIndex++ ];
-					topPtr[ c + 6 * offset ] = pBuf[ dataIndex++ ];
-					topPtr[ c + 5 * offset ] = pBuf[ dataIndex++ ];
-					topPtr[ c + 4 * offset ] = pBuf[ dataIndex++ ];
-					topPtr[ c + 3 * offset ] = pBuf[ dataIndex++ ];
-					topPtr[ c + 2 * offset ] = pBuf[ dataIndex++ ];
-					topPtr[ c + 1 * offset ] = pBuf[ dataIndex++ ];
-					topPtr[ c + 0 * offset ] = pBuf[ dataIndex++ ];
-				}
-			}
+					T* topPtr = pDst + ( uiCols * ( uiRows - r - 1 ) );
+					T* botPtr = pDst + ( uiCols * r );
 
-			copyMemory( pBuf, m_pNewData.get(), ( uiCols * uiRows * sizeof( T ) ) );
+					T* a_pDst[ 16 ];
+
+					for ( std::uint32_t k = 0; k < 8; k++ )
+					{
+						a_pDst[ k ] = botPtr + ( 7 - k ) * offset;
+						a_pDst[ k + 8 ] = topPtr + ( 7 - k ) * offset;
+					}
+
+					fnSplit( ( pSrc + ( 2 * r * uiCols ) ), a_pDst, 0, ( uiCols / 8 ) );
+				}
+			} );
 		}
 
 
@@ -813,16 +1545,24 @@ namespace arc
 // +----------------------------------------------------------------------------------------------------------+
 // | getPluginManager                                                                                         |
 // +----------------------------------------------------------------------------------------------------------+
-// | Returns the deinterlace plugin manager instance.                                                         |
+// | Returns the deinterlace plugin manager instance. The manager is created once, on first use, and shared   |
+// | by all instances, so the algorithms it has resolved stay valid for the life of the process.              |
 // +----------------------------------------------------------------------------------------------------------+
 template <typename T> arc::gen3::CArcPluginManager* arc::gen3::CArcDeinterlace<T>::getPluginManager( void )
 {
+	static std::once_flag tOnce;
+
+	std::call_once( tOnce, []() { m_pPluginManager.reset( new CArcPluginManager() ); } );
+
 	return m_pPluginManager.get();
 }
 
 template <typename T>
 std::unique_ptr<arc::gen3::CArcPluginManager> arc::gen3::CArcDeinterlace<T>::m_pPluginManager;
 
+template <typename T>
+const std::uint32_t arc::gen3::CArcDeinterlace<T>::MIN_THREAD_PIXELS;
+
 
 /*template <> arc::gen3::CArcPluginManager* arc::gen3::CArcDeinterlace<arc::gen3::dlace::BPP_16>::getPluginManager( void )
 {
@@ -15,6 +15,9 @@
 
 #endif
 
+#include <algorithm>
+#include <memory>
+
 #include <CArcPluginManager.h>
 
 
@@ -54,14 +57,31 @@ namespace arc
 		// +----------------------------------------------------------------------------------------------------------+
 		CArcPluginManager::~CArcPluginManager( void )
 		{
+			m_algMap.clear();
+
 			for ( Plugin_t* pPlugin : m_pluginMap )
 			{
-				if ( pPlugin->hlib != nullptr && pPlugin->dtor != nullptr && pPlugin->pObj != nullptr )
+				if ( pPlugin->dtorV2 != nullptr && pPlugin->pObjV2 != nullptr )
 				{
-					( *pPlugin->dtor ) ( pPlugin->pObj );
+					( *pPlugin->dtorV2 ) ( pPlugin->pObjV2 );
+				}
+
+				else
+				{
+					delete pPlugin->pObjV2;
+
+					if ( pPlugin->dtor != nullptr && pPlugin->pObj != nullptr )
+					{
+						( *pPlugin->dtor ) ( pPlugin->pObj );
+					}
+				}
 
+				if ( pPlugin->hlib != nullptr )
+				{
 					ArcFreeLibrary( pPlugin->hlib );
 				}
+
+				delete pPlugin;
 			}
 
 			m_pluginMap.clear();
@@ -100,6 +120,43 @@ namespace arc
 		}
 
 
+		// +----------------------------------------------------------------------------------------------------------+
+		// | getPlugin                                                                                                |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Returns a loaded plugin through the version 2 interface. May return nullptr.                            |
+		// |                                                                                                          |
+		// |  <IN> -> uiIndex - The index of the plugin to return ( default = 0 ).                                    |
+		// |                                                                                                          |
+		// | Throws a std::out_of_range                                                                               |
+		// +----------------------------------------------------------------------------------------------------------+
+		arc::gen3::IArcPluginV2* CArcPluginManager::getPlugin( std::uint32_t uiIndex )
+		{
+			if ( pluginLoaded() )
+			{
+				return m_pluginMap.at( uiIndex )->pObjV2;
+			}
+
+			return nullptr;
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// | findAlgorithm                                                                                            |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Finds an algorithm by name in all loaded plugins. The names are indexed as each plugin is loaded, so    |
+		// |  this is one hash lookup rather than a search of every plugin's name list. Returns nullptr if no plugin  |
+		// |  has the algorithm.                                                                                      |
+		// |                                                                                                          |
+		// |  <IN> -> sAlg - The algorithm name.                                                                      |
+		// +----------------------------------------------------------------------------------------------------------+
+		const arc::gen3::PluginAlg_t* CArcPluginManager::findAlgorithm( const std::string& sAlg )
+		{
+			auto it = m_algMap.find( sAlg );
+
+			return ( it != m_algMap.end() ? &it->second : nullptr );
+		}
+
+
 		// +----------------------------------------------------------------------------------------------------------+
 		// | findPluginLibrary                                                                                        |
 		// +----------------------------------------------------------------------------------------------------------+
@@ -119,7 +176,13 @@ namespace arc
 			#elif defined( __APPLE__ )
 				// Place holder
 			#else
-				getDirList( sLibPath + "/*.so", vDirs );
+				// opendir() takes no wildcard, so list the directory and keep the .so files
+				getDirList( sLibPath, vDirs );
+
+				vDirs.erase( std::remove_if( vDirs.begin(), vDirs.end(), []( const std::string& sFile )
+				{
+					return ( sFile.size() < 3 || sFile.compare( ( sFile.size() - 3 ), 3, ".so" ) != 0 );
+				} ), vDirs.end() );
 			#endif
 
 			if ( vDirs.size() > 0 )
@@ -256,28 +319,45 @@ namespace arc
 						ArcSysErrorCode() );
 			}
 
-			Plugin_t* tPlugin = createInstance( hPluginLib );
+			//  A library that is already loaded returns the same handle; drop the extra reference
+			// +--------------------------------------------------------+
+			for ( auto &rPlugin : m_pluginMap )
+			{
+				if ( rPlugin->hlib == hPluginLib )
+				{
+					ArcFreeLibrary( hPluginLib );
 
-			if ( tPlugin == nullptr )
+					return;
+				}
+			}
+
+			Plugin_t* tPlugin = nullptr;
+
+			try
 			{
-				ArcFreeLibrary( hPluginLib );
+				tPlugin = createInstance( hPluginLib );
 			}
+			catch ( ... )
+			{
+				ArcFreeLibrary( hPluginLib );
 
-			bool bExists = false;
+				throw;
+			}
 
-			for ( auto &rPlugin : m_pluginMap )
+			if ( tPlugin == nullptr )
 			{
-				if ( rPlugin->hlib == hPluginLib )
-				{
-					bExists = true;
+				ArcFreeLibrary( hPluginLib );
 
-					break;
-				}
+				return;
 			}
 
-			if ( !bExists )
+			m_pluginMap.push_back( tPlugin );
+
+			//  Index the algorithm names; emplace keeps the first plugin to load a name
+			// +--------------------------------------------------------+
+			for ( std::uint32_t i = 0; i < tPlugin->pObjV2->algorithmCount(); i++ )
 			{
-				m_pluginMap.push_back( tPlugin );
+				m_algMap.emplace( tPlugin->pObjV2->algorithmName( i ), arc::gen3::PluginAlg_t { tPlugin->pObjV2, i, tPlugin->pObjV2->capabilities( i ) } );
 			}
 		}
 
@@ -285,8 +365,11 @@ namespace arc
 		// +----------------------------------------------------------------------------------------------------------+
 		// | isCustomLibrary                                                                                          |
 		// +----------------------------------------------------------------------------------------------------------+
-		// | Verifies that the specified library handle points to a custom deinterlace library. Returns 'true' if     |
-		// | the "IS_CUSTOM_ALGORITHM" system returns 1; 'false' otherwise ( i.e. the symbol is not found ).          |
+		// | Creates the plugin object if the specified library handle points to a custom deinterlace library, i.e.   |
+		// | it exports createPluginV2() and releasePluginV2(), or the version 1 createPlugin() and releasePlugin().  |
+		// | A version 1 plugin is wrapped in a CArcPluginV1Adapter. Returns nullptr if the symbols are not found.    |
+		// | If creating the adapter throws, the plugin object is released before the exception is passed on; the     |
+		// | caller still owns the library handle.                                                                    |
 		// |                                                                                                          |
 		// | <IN> -> hPlugin - A custom library handle.                                                               |
 		// +----------------------------------------------------------------------------------------------------------+
@@ -298,19 +381,38 @@ namespace arc
 			// +--------------------------------------------------------+
 			if ( hPluginLib != nullptr )
 			{
+				PluginCreateV2  pCtorV2 = ( PluginCreateV2 )ArcFindLibrarySymbol( hPluginLib, "createPluginV2" );
+				PluginReleaseV2 pDtorV2 = ( PluginReleaseV2 )ArcFindLibrarySymbol( hPluginLib, "releasePluginV2" );
+
 				PluginCreate  pCtor = ( PluginCreate )ArcFindLibrarySymbol( hPluginLib, "createPlugin" );
 				PluginRelease pDtor = ( PluginRelease )ArcFindLibrarySymbol( hPluginLib, "releasePlugin" );
 
-				if ( pCtor != nullptr && pDtor != nullptr )
+				if ( pCtorV2 != nullptr && pDtorV2 != nullptr )
 				{
-					pPlugin = new Plugin_t;
+					std::unique_ptr<IArcPluginV2, PluginReleaseV2> pObjV2( ( *pCtorV2 ) ( ), pDtorV2 );
 
-					if ( pPlugin != nullptr )
+					if ( pObjV2 != nullptr )
 					{
-						pPlugin->hlib = hPluginLib;
-						pPlugin->ctor = pCtor;
-						pPlugin->dtor = pDtor;
-						pPlugin->pObj = ( *pCtor ) ( );
+						pPlugin = new Plugin_t { hPluginLib, nullptr, nullptr, nullptr, pCtorV2, pDtorV2, pObjV2.get() };
+
+						pObjV2.release();
+					}
+				}
+
+				else if ( pCtor != nullptr && pDtor != nullptr )
+				{
+					//  Held until the plugin entry owns it; the adapter constructor calls into the plugin and may throw
+					// +--------------------------------------------------------+
+					std::unique_ptr<IArcPlugin, PluginRelease> pObj( ( *pCtor ) ( ), pDtor );
+
+					if ( pObj != nullptr )
+					{
+						std::unique_ptr<IArcPluginV2> pAdapter( new CArcPluginV1Adapter( pObj.get() ) );
+
+						pPlugin = new Plugin_t { hPluginLib, pCtor, pDtor, pObj.get(), nullptr, nullptr, pAdapter.get() };
+
+						pAdapter.release();
+						pObj.release();
 					}
 				}
 			}
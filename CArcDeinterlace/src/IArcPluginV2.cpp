@@ -0,0 +1,169 @@
+// +------------------------------------------------------------------------------------------------------------------+
+// |  FILE:  IArcPluginV2.cpp  ( Gen3 )                                                                               |
+// +------------------------------------------------------------------------------------------------------------------+
+// |  PURPOSE: This file implements the version 2 ARC deinterlace plugin interface and the version 1 adapter.         |
+// +------------------------------------------------------------------------------------------------------------------+
+
+#include <cstring>
+
+#include <IArcPluginV2.h>
+
+
+namespace arc
+{
+	namespace gen3
+	{
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// | Constructor                                                                                              |
+		// +----------------------------------------------------------------------------------------------------------+
+		IArcPluginV2::IArcPluginV2( void )
+		{
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// | Destructor                                                                                               |
+		// +----------------------------------------------------------------------------------------------------------+
+		IArcPluginV2::~IArcPluginV2( void )
+		{
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// | CArcPluginV1Adapter Constructor                                                                          |
+		// +----------------------------------------------------------------------------------------------------------+
+		// | The algorithm names are copied once, so the version 1 name list is not searched again on each run.       |
+		// |                                                                                                          |
+		// |  <IN> -> pPlugin - The version 1 plugin.                                                                 |
+		// |                                                                                                          |
+		// |  Throws std::invalid_argument                                                                            |
+		// +----------------------------------------------------------------------------------------------------------+
+		CArcPluginV1Adapter::CArcPluginV1Adapter( arc::gen3::IArcPlugin* pPlugin ) : m_pPlugin( pPlugin )
+		{
+			if ( pPlugin == nullptr )
+			{
+				THROW_INVALID_ARGUMENT( "Invalid plugin, cannot be nullptr" );
+			}
+
+			auto pList = pPlugin->getNameList();
+
+			for ( std::uint32_t i = 0; i < pList->length(); i++ )
+			{
+				m_vNames.push_back( pList->at( i ) );
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// | CArcPluginV1Adapter Destructor                                                                           |
+		// +----------------------------------------------------------------------------------------------------------+
+		CArcPluginV1Adapter::~CArcPluginV1Adapter( void )
+		{
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// | algorithmCount                                                                                           |
+		// +----------------------------------------------------------------------------------------------------------+
+		// | Returns the number of algorithms supported by the version 1 plugin.                                      |
+		// +----------------------------------------------------------------------------------------------------------+
+		std::uint32_t CArcPluginV1Adapter::algorithmCount( void )
+		{
+			return static_cast< std::uint32_t >( m_vNames.size() );
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// | algorithmName                                                                                            |
+		// +----------------------------------------------------------------------------------------------------------+
+		// | Returns the name of an algorithm.                                                                        |
+		// |                                                                                                          |
+		// |  <IN> -> uiAlg - The algorithm index.                                                                    |
+		// |                                                                                                          |
+		// |  Throws std::invalid_argument                                                                            |
+		// +----------------------------------------------------------------------------------------------------------+
+		const std::string& CArcPluginV1Adapter::algorithmName( std::uint32_t uiAlg )
+		{
+			if ( uiAlg >= m_vNames.size() )
+			{
+				THROW_INVALID_ARGUMENT( "Invalid algorithm index [ %u ], expected range: 0 to %u", uiAlg, algorithmCount() );
+			}
+
+			return m_vNames[ uiAlg ];
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// | capabilities                                                                                             |
+		// +----------------------------------------------------------------------------------------------------------+
+		// | Version 1 plugins only deinterlace in place and declare nothing else, so they are not assumed to be      |
+		// | thread safe.                                                                                             |
+		// |                                                                                                          |
+		// |  <IN> -> uiAlg - The algorithm index.                                                                    |
+		// +----------------------------------------------------------------------------------------------------------+
+		std::uint32_t CArcPluginV1Adapter::capabilities( std::uint32_t )
+		{
+			return arc::gen3::dlace::PLUGIN_IN_PLACE;
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// | run                                                                                                      |
+		// +----------------------------------------------------------------------------------------------------------+
+		// | Executes an algorithm on 16 bits-per-pixel frames. See runFrames().                                      |
+		// +----------------------------------------------------------------------------------------------------------+
+		void CArcPluginV1Adapter::run( std::uint32_t uiAlg, const std::uint16_t* pSrc, std::uint16_t* pDst, const arc::gen3::dlace::PluginJob& tJob )
+		{
+			runFrames( uiAlg, pSrc, pDst, tJob );
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// | run                                                                                                      |
+		// +----------------------------------------------------------------------------------------------------------+
+		// | Executes an algorithm on 32 bits-per-pixel frames. See runFrames().                                      |
+		// +----------------------------------------------------------------------------------------------------------+
+		void CArcPluginV1Adapter::run( std::uint32_t uiAlg, const std::uint32_t* pSrc, std::uint32_t* pDst, const arc::gen3::dlace::PluginJob& tJob )
+		{
+			runFrames( uiAlg, pSrc, pDst, tJob );
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// | runFrames                                                                                                |
+		// +----------------------------------------------------------------------------------------------------------+
+		// | Copies each frame to the destination, unless it is the source, and runs the version 1 plugin on it in    |
+		// | place. Version 1 plugins take a single argument, so only the first one is passed ( default = 0 ).        |
+		// |                                                                                                          |
+		// |  <IN>  -> uiAlg - The algorithm index.                                                                   |
+		// |  <IN>  -> pSrc	 - The frames to deinterlace.                                                             |
+		// |  <OUT> -> pDst	 - The buffer to receive the deinterlaced frames.                                         |
+		// |  <IN>  -> tJob	 - The frame size, frame count and arguments.                                             |
+		// |                                                                                                          |
+		// |  Throws std::exception                                                                                   |
+		// +----------------------------------------------------------------------------------------------------------+
+		template <typename T>
+		void CArcPluginV1Adapter::runFrames( std::uint32_t uiAlg, const T* pSrc, T* pDst, const arc::gen3::dlace::PluginJob& tJob )
+		{
+			const std::string& sAlg = algorithmName( uiAlg );
+
+			std::uint64_t u64Pixels = ( static_cast< std::uint64_t >( tJob.uiCols ) * static_cast< std::uint64_t >( tJob.uiRows ) );
+
+			std::uint32_t uiArg = ( tJob.uiArgCount > 0 ? tJob.pArgs[ 0 ] : 0 );
+
+			for ( std::uint32_t f = 0; f < tJob.uiFrames; f++ )
+			{
+				T* pFrame = ( pDst + ( f * u64Pixels ) );
+
+				if ( pDst != pSrc )
+				{
+					std::memcpy( pFrame, ( pSrc + ( f * u64Pixels ) ), ( u64Pixels * sizeof( T ) ) );
+				}
+
+				m_pPlugin->run( pFrame, tJob.uiCols, tJob.uiRows, ( 8 * sizeof( T ) ), sAlg, uiArg );
+			}
+		}
+
+	}	// end gen3 namespace
+}		// end arc namespace
@@ -8,10 +8,15 @@ CPP_SRCS += \
 ../src/ArcOSDefs.cpp \
 ../src/CArcDevice.cpp \
 ../src/CArcDeviceDllMain.cpp \
+../src/CArcExecPolicy.cpp \
+../src/CArcFrameLease.cpp \
+../src/CArcFrameQueue.cpp \
+../src/CArcFrameWait.cpp \
 ../src/CArcLog.cpp \
 ../src/CArcPCI.cpp \
 ../src/CArcPCIBase.cpp \
 ../src/CArcPCIe.cpp \
+../src/CArcReadoutModel.cpp \
 ../src/TempCtrl.cpp 
 
 OBJS += \
@@ -19,10 +24,15 @@ OBJS += \
 ./src/ArcOSDefs.o \
 ./src/CArcDevice.o \
 ./src/CArcDeviceDllMain.o \
+./src/CArcExecPolicy.o \
+./src/CArcFrameLease.o \
+./src/CArcFrameQueue.o \
+./src/CArcFrameWait.o \
 ./src/CArcLog.o \
 ./src/CArcPCI.o \
 ./src/CArcPCIBase.o \
 ./src/CArcPCIe.o \
+./src/CArcReadoutModel.o \
 ./src/TempCtrl.o 
 
 CPP_DEPS += \
@@ -30,10 +40,15 @@ CPP_DEPS += \
 ./src/ArcOSDefs.d \
 ./src/CArcDevice.d \
 ./src/CArcDeviceDllMain.d \
+./src/CArcExecPolicy.d \
+./src/CArcFrameLease.d \
+./src/CArcFrameQueue.d \
+./src/CArcFrameWait.d \
 ./src/CArcLog.d \
 ./src/CArcPCI.d \
 ./src/CArcPCIBase.d \
 ./src/CArcPCIe.d \
+./src/CArcReadoutModel.d \
 ./src/TempCtrl.d 
 
 
@@ -7,9 +7,19 @@
 #include <CExpIFace.h>
 #include <CooExpIFace.h>
 #include <CConIFace.h>
+#include <CStreamIFace.h>
+#include <CRoiIFace.h>
+#include <CArcReadoutModel.h>
+#include <CArcFrameQueue.h>
+#include <CArcExecPolicy.h>
+#include <CArcFrameWait.h>
 #include <TempCtrl.h>
 #include <CArcLog.h>
 
+#include <atomic>
+#include <vector>
+#include <mutex>
+
 #if defined( linux ) || defined( __linux )
 	#include <sys/types.h>
 #endif
@@ -45,6 +55,124 @@ namespace arc
 				#endif
 			} ArcDev_t;
 
+
+			// +------------------------------------------------+
+			// | Frame-transfer acquisition state               |
+			// +------------------------------------------------+
+			typedef enum class FTState : std::uint32_t
+			{
+				IDLE = 0,			// Not running
+				INTEGRATING,		// First exposure integrating, nothing in storage yet
+				TRANSFER_READOUT,	// Exposure N+1 integrating while frame N is read from storage
+				DRAINING			// Last frame is being read from storage, no integration
+			} eFTState;
+
+
+			// +------------------------------------------------+
+			// | Frame-transfer timing telemetry ( seconds )    |
+			// +------------------------------------------------+
+			typedef struct ARC_FT_STATS
+			{
+				std::uint32_t	uiFrames;			// Frames read out
+				std::uint32_t	uiLost;				// Frames overwritten before they could be delivered
+				double			gExposureTime;		// Requested exposure time
+				double			gMeanExposureTime;	// Measured exposure start to storage transfer
+				double			gElapsedTime;		// Start exposure to last frame read
+				double			gMeanFramePeriod;	// Mean time between frame completions
+				double			gMinFramePeriod;
+				double			gMaxFramePeriod;
+				double			gMeanReadoutTime;	// Mean storage transfer to frame complete
+				double			gDutyCycle;			// Measured integration fraction of the elapsed time
+			} FTStats_t;
+
+
+			// +------------------------------------------------+
+			// | Sub-array loop timing telemetry ( seconds )    |
+			// +------------------------------------------------+
+			typedef struct ARC_ROI_STATS
+			{
+				std::uint32_t	uiFrames;			// Frames delivered
+				double			gElapsedTime;		// Loop start to last frame read
+				double			gCadence;			// Achieved frame rate ( Hz )
+				double			gMeanFramePeriod;	// Mean time between frame completions
+				double			gMinFramePeriod;
+				double			gMaxFramePeriod;
+				double			gJitter;			// Standard deviation of the frame period
+			} RoiStats_t;
+
+
+			// +------------------------------------------------+
+			// | Triggered acquisition timing ( seconds )       |
+			// +------------------------------------------------+
+			typedef struct ARC_TRIGGER_STATS
+			{
+				std::uint32_t	uiFrames;			// Frames read out
+				std::uint32_t	uiLost;				// Frames overwritten before they could be delivered
+				double			gArmLatency;		// Call to controller armed ( ready for trigger )
+				double			gMeanPeriod;		// Mean time between detected readout starts
+				double			gMinPeriod;
+				double			gMaxPeriod;
+				double			gJitter;			// Standard deviation of the readout start period
+				double			gMaxPollGap;		// Worst case readout start detection latency
+			} TriggerStats_t;
+
+
+			// +------------------------------------------------+
+			// | Continuous readout frame accounting            |
+			// +------------------------------------------------+
+			typedef struct ARC_CON_STATS
+			{
+				std::uint32_t	uiFramesPerBuffer;	// Common buffer slots
+				std::uint64_t	u64Frames;			// Frames completed by the device
+				std::uint64_t	u64Delivered;		// Frames passed to the callback ( or co-added )
+				std::uint64_t	u64Recovered;		// Delivered frames the poll loop did not see complete
+				std::uint64_t	u64Lost;			// Frames overwritten before they could be delivered
+				std::uint32_t	uiGaps;				// Runs of lost frames
+				std::uint32_t	uiMaxJump;			// Largest frame count change between two polls
+				eWaitStrategy	eWait;				// Wait strategy used between polls
+				double			gCpuBudget;			// HYBRID spin budget ( fraction of one core )
+				double			gPredictedPeriod;	// Final frame period prediction ( seconds )
+				std::uint64_t	u64Polls;			// Frame count reads
+				double			gMeanLatency;		// Mean frame detection latency estimate ( seconds )
+				double			gMaxLatency;		// Worst case frame detection latency bound ( seconds )
+				double			gPollCpu;			// Polling thread CPU use while waiting ( fraction of one core )
+				std::uint32_t	uiRuns;				// Controller runs ( SEX ), more than one for a stream
+			} ConStats_t;
+
+
+			// +------------------------------------------------+
+			// | Continuous readout ring depth auto-tuning      |
+			// +------------------------------------------------+
+			typedef struct ARC_AUTO_TUNE
+			{
+				std::uint32_t	uiWarmupFrames;		// Frames delivered during the warm-up
+				std::uint32_t	uiWorkers;			// Consumer threads ( 1 when synchronous )
+				double			gFramePeriod;		// Measured frame period ( seconds )
+				double			gMeanService;		// Mean consumer time per frame ( seconds )
+				double			gStdService;		// Standard deviation of the consumer time ( seconds )
+				double			gUtilization;		// Mean service / ( workers x frame period )
+				bool			bSustainable;		// 'false' if the consumer cannot keep up at any depth
+				double			gTargetOverrun;		// Requested probability that a frame is overwritten
+				double			gPredictedOverrun;	// Predicted probability at the chosen depth
+				std::uint32_t	uiFramesPerBuffer;	// Chosen ring depth
+				std::uint64_t	u64BufferSize;		// Common buffer size after tuning ( bytes )
+				bool			bRemapped;			// 'true' if the common buffer was re-mapped
+			} AutoTune_t;
+
+
+			// +------------------------------------------------+
+			// | Metadata collected during expose() integration |
+			// +------------------------------------------------+
+			typedef struct ARC_EXPOSE_METADATA
+			{
+				std::uint32_t	uiValid;			// Bit mask of collected fields ( CArcDevice::META_xxx )
+				double			gTemperature;		// Array temperature ( Celsius )
+				std::uint32_t	uiControllerId;		// Controller ID
+				std::uint32_t	uiExposureTime;		// Exposure time read back from the controller ( ms )
+				std::uint32_t	uiCCParams;			// Controller configuration word
+				double			gCollectTime;		// Time spent on the queries ( seconds )
+			} ExposeMetadata_t;
+
 		}	// end device namespace
 
 		// +------------------------------------------------+
@@ -145,10 +273,30 @@ namespace arc
 				// +-------------------------------------------------+
 				virtual void setOpenShutter( bool bShouldOpen );
 
-				virtual void expose( float fExpTime, std::uint32_t uiRows, std::uint32_t uiCols, const bool& bAbort = false, arc::gen3::CExpIFace* pExpIFace = nullptr, bool bOpenShutter = true );
-				virtual void expose( int devnum, const std::uint32_t &uiExpTime, std::uint32_t uiRows, std::uint32_t uiCols, const bool& bAbort = false, arc::gen3::CooExpIFace* pCooExpIFace = nullptr, bool bOpenShutter = true );
+				virtual void expose( float fExpTime, std::uint32_t uiRows, std::uint32_t uiCols, const bool& bAbort = false, arc::gen3::CExpIFace* pExpIFace = nullptr, bool bOpenShutter = true, arc::gen3::CStreamIFace* pStreamIFace = nullptr );
+				virtual void expose( int devnum, const std::uint32_t &uiExpTime, std::uint32_t uiRows, std::uint32_t uiCols, const bool& bAbort = false, arc::gen3::CooExpIFace* pCooExpIFace = nullptr, bool bOpenShutter = true, arc::gen3::CStreamIFace* pStreamIFace = nullptr );
 				virtual void readout( int devnum, std::uint32_t uiRows, std::uint32_t uiCols, arc::gen3::CooExpIFace* pCooExpIFace = nullptr );
 				virtual void frame_transfer( int devnum, std::uint32_t uiRows, std::uint32_t uiCols, arc::gen3::CooExpIFace* pCooExpIFace );
+				virtual void frame_transfer( int devnum, std::uint32_t uiRows, std::uint32_t uiCols, std::uint32_t uiNumOfFrames, std::uint32_t uiExpTime, const bool& bAbort = false, arc::gen3::CooExpIFace* pCooExpIFace = nullptr, bool bOpenShutter = true );
+
+				virtual void setExposeMetadata( std::uint32_t uiMask );
+
+				virtual arc::gen3::device::ExposeMetadata_t getExposeMetadata( void );
+
+				virtual arc::gen3::device::eFTState getFrameTransferState( void );
+
+				virtual arc::gen3::device::FTStats_t getFrameTransferStats( void );
+
+				virtual void subArrayLoop( std::uint32_t uiRow, std::uint32_t uiCol, std::uint32_t uiSubRows, std::uint32_t uiSubCols, std::uint32_t uiBiasOffset, std::uint32_t uiBiasCols,
+										   std::uint32_t uiNumOfFrames, float fExpTime, const bool& bAbort = false, arc::gen3::CRoiIFace* pRoiIFace = nullptr, bool bOpenShutter = true );
+
+				virtual arc::gen3::device::RoiStats_t getSubArrayLoopStats( void );
+
+				virtual void triggered( std::uint32_t uiRows, std::uint32_t uiCols, std::uint32_t uiNumOfFrames, float fExpTime, const bool& bAbort = false, arc::gen3::CConIFace* pConIFace = nullptr, bool bOpenShutter = true );
+
+				virtual arc::gen3::device::TriggerStats_t getTriggerStats( void );
+
+				virtual std::vector<double> getTriggerTimestamps( void );
 
 				virtual void stopExposure( void ) = 0;
 
@@ -156,6 +304,45 @@ namespace arc
 
 				virtual void stopContinuous( void );
 
+				virtual arc::gen3::device::ConStats_t getContinuousStats( void );
+
+				virtual void setContinuousFramesPerBuffer( std::uint32_t uiFrames );
+
+				virtual std::uint32_t getContinuousFramesPerBuffer( void );
+
+				virtual void setContinuousWaitStrategy( arc::gen3::device::eWaitStrategy eStrategy, double gCpuBudget = 0.1 );
+
+				virtual arc::gen3::device::eWaitStrategy getContinuousWaitStrategy( void );
+
+				virtual double getContinuousCpuBudget( void );
+
+				virtual arc::gen3::device::AutoTune_t autoTuneContinuous( std::uint32_t uiRows, std::uint32_t uiCols, float fExpTime, arc::gen3::CConIFace* pConIFace, std::uint32_t uiWarmupFrames = 50,
+																		  double gOverrunProbability = 1.0e-6, bool bAllowRemap = false, const bool& bAbort = false, bool bOpenShutter = true );
+
+				virtual arc::gen3::device::AutoTune_t getAutoTuneReport( void );
+
+				virtual void setExecPolicy( const arc::gen3::device::ExecPolicy_t& tPolicy );
+
+				virtual arc::gen3::device::ExecPolicy_t getExecPolicy( void );
+
+				virtual arc::gen3::device::ExecReport_t getExecReport( void );
+
+				virtual void setContinuousCoadd( std::uint32_t uiFrames );
+
+				virtual std::uint32_t getContinuousCoadd( void );
+
+				virtual void setContinuousWorkers( std::uint32_t uiWorkers, std::uint32_t uiQueueDepth = 0, arc::gen3::device::eQueuePolicy ePolicy = arc::gen3::device::eQueuePolicy::BLOCK );
+
+				virtual std::uint32_t getContinuousWorkers( void );
+
+				virtual arc::gen3::device::QueueStats_t getFrameQueueStats( void );
+
+				virtual arc::gen3::device::LeaseStats_t getFrameLeaseStats( void );
+
+				virtual arc::gen3::device::FrameStamp_t getLastFrameStamp( void );
+
+				static const std::string formatFrameStamp( const arc::gen3::device::FrameStamp_t& tStamp );
+
 				virtual bool isReadout( void ) = 0;
 
 				virtual std::uint32_t getPixelCount( void ) = 0;
@@ -165,6 +352,19 @@ namespace arc
 				virtual std::uint32_t getFrameCount( void ) = 0;
 
 
+				//  Readout time prediction
+				// +-------------------------------------------------+
+				virtual double predictReadoutTime( std::uint32_t uiRows, std::uint32_t uiCols, std::uint32_t uiRowFactor = 1, std::uint32_t uiColFactor = 1 );
+
+				virtual arc::gen3::device::ReadoutModel_t getReadoutModel( std::uint32_t uiRowFactor = 1, std::uint32_t uiColFactor = 1 );
+
+				virtual void clearReadoutModel( void );
+
+				virtual void loadReadoutModel( const std::string& sFilename );
+
+				virtual void saveReadoutModel( const std::string& sFilename );
+
+
 				//  Error & Degug message access
 				// +-------------------------------------------------+
 				virtual bool containsError( std::uint32_t uiWord );
@@ -210,6 +410,16 @@ namespace arc
 				// +------------------------------------------------------------------+
 				static const std::string NO_FILE;
 
+
+				//  Expose metadata selection ( bit mask for setExposeMetadata )
+				// +------------------------------------------------------------------+
+				static const std::uint32_t META_NONE          = 0x0;
+				static const std::uint32_t META_TEMPERATURE   = 0x1;
+				static const std::uint32_t META_CONTROLLER_ID = 0x2;
+				static const std::uint32_t META_EXPOSURE_TIME = 0x4;
+				static const std::uint32_t META_CC_PARAMS     = 0x8;
+				static const std::uint32_t META_ALL           = 0xF;
+
 			protected:
 
 				virtual bool getCommonBufferProperties( void ) = 0;
@@ -233,6 +443,32 @@ namespace arc
 
 				virtual const std::string formatDLoadString( std::uint32_t uiReply, std::uint32_t uiBoardId, std::vector<std::uint32_t>* pvData );
 
+				virtual void streamRows( arc::gen3::CStreamIFace* pStreamIFace, std::uint32_t uiPixelCount, std::uint32_t uiRows, std::uint32_t uiCols, std::uint32_t& uiRowsSent );
+
+				virtual void collectExposeMetadata( std::uint32_t& uiPending, bool bTimeLeft );
+
+				virtual std::shared_ptr<arc::gen3::CArcFrameRing> beginFrameLeases( std::uint32_t uiFramesPerBuffer );
+
+				virtual void retireFrameLeases( void );
+
+				virtual std::unique_ptr<arc::gen3::CArcExecScope> applyExecPolicy( void );
+
+				virtual void applyWorkerExecPolicy( void );
+
+				virtual std::uint32_t getContinuousRunLimit( void );
+
+				static std::uint64_t extendFrameCount( std::uint64_t u64Count, std::uint32_t uiFrameCount );
+
+				static std::uint32_t frameSlot( std::uint64_t u64Frame, std::uint32_t uiFramesPerBuffer );
+
+				static std::uint64_t oldestBufferedFrame( std::uint64_t u64FrameCount, std::uint32_t uiFramesPerBuffer );
+
+				static void coaddFrame( std::uint32_t* pAccum, const std::uint16_t* pFrame, std::uint64_t u64Pixels, bool bFirst );
+
+				virtual void stampFrame( arc::gen3::device::FrameStamp_t& tStamp, std::uint64_t u64PollTime, std::uint64_t u64LastPollTime );
+
+				static std::uint64_t monotonicTime( void );
+
 				//  Temperature control variables
 				// +-------------------------------------------------------------+
 				double								m_gTmpCtrl_DT670Coeff1;
@@ -255,7 +491,81 @@ namespace arc
 				std::unique_ptr<arc::gen3::CArcLog>	m_pCLog;
 				arc::gen3::device::ImgBuf_t			m_tImgBuffer;
 				std::uint32_t						m_uiCCParam;
+				std::uint32_t						m_uiBinRowFactor;
+				std::uint32_t						m_uiBinColFactor;
 				bool	 							m_bStoreCmds;	// 'true' stores cmd strings in queue
+
+				//  Frame-transfer state & telemetry
+				// +-------------------------------------------------------------+
+				std::atomic<arc::gen3::device::eFTState>	m_eFTState;
+				arc::gen3::device::FTStats_t				m_tFTStats;
+
+				//  Sub-array loop telemetry
+				// +-------------------------------------------------------------+
+				arc::gen3::device::RoiStats_t				m_tRoiStats;
+
+				//  Triggered acquisition telemetry
+				// +-------------------------------------------------------------+
+				arc::gen3::device::TriggerStats_t			m_tTrigStats;
+				std::vector<double>							m_vTrigTimestamps;
+
+				//  Host co-adding of continuous readout frames
+				// +-------------------------------------------------------------+
+				std::uint32_t								m_uiCoaddFrames;
+
+				//  Continuous readout frame accounting
+				// +-------------------------------------------------------------+
+				arc::gen3::device::ConStats_t				m_tConStats;
+
+				//  Continuous readout ring depth ( 0 = as many frames as fit )
+				// +-------------------------------------------------------------+
+				std::uint32_t								m_uiConFramesPerBuffer;
+				arc::gen3::device::AutoTune_t				m_tAutoTune;
+
+				//  Continuous readout frame wait strategy
+				// +-------------------------------------------------------------+
+				arc::gen3::device::eWaitStrategy			m_eConWait;
+				double										m_gConCpuBudget;
+
+				//  Continuous readout stop request ( see stopContinuous() )
+				// +-------------------------------------------------------------+
+				std::atomic<bool>							m_bConActive;
+				std::atomic<bool>							m_bConStop;
+
+				//  Acquisition and worker thread execution policy
+				// +-------------------------------------------------------------+
+				arc::gen3::device::ExecPolicy_t				m_tExecPolicy;
+				arc::gen3::device::ExecReport_t				m_tExecReport;
+				std::string									m_sLockError;
+				std::mutex									m_tExecMutex;
+
+				//  Continuous readout frame queue and worker pool
+				// +-------------------------------------------------------------+
+				std::uint32_t								m_uiConWorkers;
+				std::uint32_t								m_uiConQueueDepth;
+				arc::gen3::device::eQueuePolicy				m_eConQueuePolicy;
+				std::unique_ptr<arc::gen3::CArcFrameQueue>	m_pFrameQueue;
+				std::mutex									m_tQueueMutex;
+
+				//  Common buffer ring state for continuous readout frame leases
+				// +-------------------------------------------------------------+
+				std::shared_ptr<arc::gen3::CArcFrameRing>	m_pFrameRing;
+				std::mutex									m_tRingMutex;
+
+				//  Metadata collected during expose() integration
+				// +-------------------------------------------------------------+
+				std::uint32_t								m_uiMetaMask;
+				std::uint32_t								m_uiMetaTempMode;
+				arc::gen3::device::ExposeMetadata_t			m_tExposeMeta;
+
+				//  Timestamp of the last frame seen by continuous() / triggered()
+				// +-------------------------------------------------------------+
+				arc::gen3::device::FrameStamp_t				m_tLastStamp;
+				std::mutex									m_tStampMutex;
+
+				//  Learned readout time model
+				// +-------------------------------------------------------------+
+				std::unique_ptr<arc::gen3::CArcReadoutModel>	m_pReadoutModel;
 		};
 
 	}	// end gen3 namespace
@@ -0,0 +1,111 @@
+// +----------------------------------------------------------------------+
+// | CArcExecPolicy.h : Defines acquisition thread scheduling controls    |
+// +----------------------------------------------------------------------+
+
+#ifndef _ARC_CEXECPOLICY_H_
+#define _ARC_CEXECPOLICY_H_
+
+#ifdef _WINDOWS
+#pragma warning( disable: 4251 )
+#endif
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <CArcDeviceDllMain.h>
+
+
+namespace arc
+{
+	namespace gen3
+	{
+		namespace device
+		{
+
+			// +------------------------------------------------+
+			// | Execution policy for acquisition and worker    |
+			// | threads. Zero / -1 fields leave the setting    |
+			// | unchanged.                                     |
+			// +------------------------------------------------+
+			typedef struct ARC_EXEC_POLICY
+			{
+				std::uint64_t	u64PollCpuMask;		// CPUs for the acquisition ( polling ) thread, bit N = CPU N
+				std::int32_t	iPollPriority;		// SCHED_FIFO priority for the acquisition thread ( 1 - 99 )
+				std::uint64_t	u64WorkerCpuMask;	// CPUs for frame queue worker threads
+				std::int32_t	iWorkerPriority;	// SCHED_FIFO priority for worker threads ( 1 - 99 )
+				bool			bLockMemory;		// Lock all process memory into RAM ( mlockall )
+				std::int32_t	iNumaNode;			// Preferred NUMA node for host buffers, -1 = none
+			} ExecPolicy_t;
+
+
+			// +------------------------------------------------+
+			// | Settings applied by the last acquisition       |
+			// +------------------------------------------------+
+			typedef struct ARC_EXEC_REPORT
+			{
+				bool			bPollAffinity;		// CPU affinity applied to the acquisition thread
+				bool			bPollPriority;		// SCHED_FIFO applied to the acquisition thread
+				bool			bPollNumaNode;		// NUMA preference applied to the acquisition thread
+				std::uint32_t	uiWorkers;			// Worker threads started
+				std::uint32_t	uiWorkersApplied;	// Worker threads that accepted all their settings
+				bool			bMemoryLocked;		// Process memory is locked
+				std::uint32_t	uiFailures;			// Settings that could not be applied
+				std::string		sLastError;			// Most recent failure
+			} ExecReport_t;
+
+		}	// end device namespace
+
+
+		// +--------------------------------------------------------------------+
+		// | Applies CPU affinity, real-time priority and NUMA memory           |
+		// | preference to the calling thread and restores the previous         |
+		// | settings when destroyed. Failures are recorded, not thrown, since  |
+		// | most of these settings need privileges the caller may not have.    |
+		// +--------------------------------------------------------------------+
+		class GEN3_CARCDEVICE_API CArcExecScope
+		{
+			public:
+
+				CArcExecScope( std::uint64_t u64CpuMask, std::int32_t iPriority, std::int32_t iNumaNode, bool bRestore = true );
+
+				~CArcExecScope( void );
+
+				bool affinityApplied( void ) const;
+
+				bool priorityApplied( void ) const;
+
+				bool numaApplied( void ) const;
+
+				std::uint32_t failures( void ) const;
+
+				const std::string& lastError( void ) const;
+
+				static bool lockMemory( bool bOnOff, std::string& sError );
+
+			private:
+
+				void fail( const std::string& sWhat );
+
+				bool			m_bRestore;
+
+				bool			m_bAffinity;
+				bool			m_bPriority;
+				bool			m_bNuma;
+
+				std::uint64_t	m_u64OldMask;
+				int				m_iOldPolicy;
+				int				m_iOldPriority;
+
+				int							m_iOldNumaMode;
+				std::vector<unsigned long>	m_vOldNumaNodes;
+
+				std::uint32_t	m_uiFailures;
+				std::string		m_sLastError;
+		};
+
+	}	// end gen3 namespace
+}	// end arc namespace
+
+
+#endif
@@ -0,0 +1,128 @@
+// +----------------------------------------------------------------------+
+// | CArcFrameLease.h : Defines zero-copy continuous readout frame leases |
+// +----------------------------------------------------------------------+
+
+#ifndef _ARC_CFRAMELEASE_H_
+#define _ARC_CFRAMELEASE_H_
+
+#ifdef _WINDOWS
+#pragma warning( disable: 4251 )
+#endif
+
+#include <cstdint>
+#include <atomic>
+#include <memory>
+
+#include <CArcDeviceDllMain.h>
+
+
+namespace arc
+{
+	namespace gen3
+	{
+		namespace device
+		{
+
+			// +------------------------------------------------+
+			// | Frame lease telemetry                          |
+			// +------------------------------------------------+
+			typedef struct ARC_LEASE_STATS
+			{
+				std::uint32_t	uiFramesPerBuffer;	// Common buffer slots
+				std::uint64_t	u64Completed;		// Last frame count seen from the device
+				std::uint64_t	u64Leased;			// Leases issued
+				std::uint64_t	u64Outstanding;		// Leases still held
+				std::uint64_t	u64Lapped;			// Leases found overwritten while held
+			} LeaseStats_t;
+
+		}	// end device namespace
+
+
+		// +--------------------------------------------------------------------+
+		// | State of the common buffer ring for one acquisition. Shared by     |
+		// | the acquisition loop, which publishes the device frame count, and  |
+		// | the leases issued for its frames.                                  |
+		// +--------------------------------------------------------------------+
+		class GEN3_CARCDEVICE_API CArcFrameRing
+		{
+			public:
+
+				CArcFrameRing( std::uint32_t uiFramesPerBuffer );
+
+				void publish( std::uint64_t u64Completed );
+
+				void retire( void );
+
+				bool isRetired( void ) const;
+
+				std::uint64_t completed( void ) const;
+
+				std::uint32_t framesPerBuffer( void ) const;
+
+				arc::gen3::device::LeaseStats_t getStats( void ) const;
+
+			private:
+
+				friend class CArcFrameLease;
+
+				std::uint32_t					m_uiFramesPerBuffer;
+
+				std::atomic<std::uint64_t>		m_u64Completed;
+				std::atomic<bool>				m_bRetired;
+
+				std::atomic<std::uint64_t>		m_u64Leased;
+				std::atomic<std::uint64_t>		m_u64Released;
+				std::atomic<std::uint64_t>		m_u64Lapped;
+		};
+
+
+		// +--------------------------------------------------------------------+
+		// | Handle to one frame in the common buffer, valid until the          |
+		// | controller wraps around and starts writing a later frame into the  |
+		// | same slot. Copies share one lease; the lease is released when the  |
+		// | last copy is destroyed or released.                                |
+		// |                                                                    |
+		// | To use a frame without copying it, process data() in place and     |
+		// | then call isValid() ( or validate() ). If the lease is still valid |
+		// | the data read was not overwritten.                                 |
+		// +--------------------------------------------------------------------+
+		class GEN3_CARCDEVICE_API CArcFrameLease
+		{
+			public:
+
+				CArcFrameLease( void ) = default;
+
+				CArcFrameLease( std::shared_ptr<CArcFrameRing> pRing, std::uint64_t u64Frame, std::uint32_t uiSlot, std::uint32_t uiRows, std::uint32_t uiCols, void* pData );
+
+				void* data( void ) const;
+
+				std::uint64_t frame( void ) const;
+
+				std::uint32_t slot( void ) const;
+
+				std::uint32_t rows( void ) const;
+
+				std::uint32_t cols( void ) const;
+
+				std::uint64_t bytes( void ) const;
+
+				bool isValid( void ) const;
+
+				void validate( void ) const;
+
+				std::uint64_t headroom( void ) const;
+
+				void release( void );
+
+			private:
+
+				struct Lease_t;
+
+				std::shared_ptr<Lease_t>	m_pLease;
+		};
+
+	}	// end gen3 namespace
+}	// end arc namespace
+
+
+#endif
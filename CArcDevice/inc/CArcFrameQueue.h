@@ -0,0 +1,164 @@
+// +----------------------------------------------------------------------+
+// | CArcFrameQueue.h : Defines a lock-free continuous readout queue      |
+// +----------------------------------------------------------------------+
+
+#ifndef _ARC_CFRAMEQUEUE_H_
+#define _ARC_CFRAMEQUEUE_H_
+
+#ifdef _WINDOWS
+#pragma warning( disable: 4251 )
+#endif
+
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <functional>
+#include <exception>
+
+#include <CArcDeviceDllMain.h>
+#include <CConIFace.h>
+
+
+namespace arc
+{
+	namespace gen3
+	{
+		namespace device
+		{
+
+			// +------------------------------------------------+
+			// | Action taken when a frame arrives and the      |
+			// | queue is full                                  |
+			// +------------------------------------------------+
+			typedef enum class QueuePolicy : std::uint32_t
+			{
+				BLOCK = 0,			// Wait for a worker to free a slot
+				DROP_OLDEST,		// Discard the oldest queued frame
+				FAIL				// Stop the acquisition with an error
+			} eQueuePolicy;
+
+
+			// +------------------------------------------------+
+			// | Queued frame descriptor                        |
+			// +------------------------------------------------+
+			typedef struct ARC_FRAME_DESC
+			{
+				std::uint32_t	uiFPBCount;			// Frame index within the common buffer
+				std::uint32_t	uiPCIFrameCount;	// Frame count reported by the device
+				std::uint32_t	uiRows;				// Image rows
+				std::uint32_t	uiCols;				// Image columns
+				void*			pBuffer;			// Frame address within the common buffer
+				FrameStamp_t	tStamp;				// Frame detection timestamp
+				std::uint64_t	u64Queued;			// Monotonic time the frame was queued ( ns )
+				CArcFrameLease	tLease;				// Lease on the frame's buffer slot
+			} FrameDesc_t;
+
+
+			// +------------------------------------------------+
+			// | Frame queue telemetry                          |
+			// +------------------------------------------------+
+			typedef struct ARC_QUEUE_STATS
+			{
+				std::uint32_t	uiWorkers;			// Worker threads
+				std::uint32_t	uiCapacity;			// Queue slots
+				std::uint32_t	uiDepth;			// Frames currently queued
+				std::uint32_t	uiInFlight;			// Frames taken by a worker and not yet finished
+				std::uint32_t	uiHighWater;		// Maximum frames queued at once
+				std::uint64_t	u64Queued;			// Frames queued
+				std::uint64_t	u64Processed;		// Frames passed to the callback
+				std::uint64_t	u64Dropped;			// Frames discarded ( overrun or abort )
+				double			gMeanWait;			// Mean time queued before a worker took the frame ( seconds )
+				double			gMeanLatency;		// Mean detection to callback completion time ( seconds )
+				double			gMaxLatency;		// Maximum detection to callback completion time ( seconds )
+			} QueueStats_t;
+
+		}	// end device namespace
+
+
+		// +--------------------------------------------------------------------+
+		// | Bounded lock-free queue of frame descriptors with a single         |
+		// | producer ( the acquisition loop ) drained by a pool of worker      |
+		// | threads. The producer never takes a lock; workers that find the    |
+		// | queue empty back off by yielding and then sleeping. A frame holds  |
+		// | its slot until a worker finishes with it, so the capacity bounds   |
+		// | the queued plus in-flight frames.                                  |
+		// +--------------------------------------------------------------------+
+		class GEN3_CARCDEVICE_API CArcFrameQueue
+		{
+			public:
+
+				typedef std::function<void( const arc::gen3::device::FrameDesc_t& )> Handler_t;
+
+				CArcFrameQueue( std::uint32_t uiCapacity, arc::gen3::device::eQueuePolicy ePolicy );
+
+				~CArcFrameQueue( void );
+
+				void start( std::uint32_t uiWorkers, Handler_t fnHandler, std::function<void( void )> fnThreadInit = nullptr );
+
+				void push( arc::gen3::device::FrameDesc_t& tDesc, const bool& bAbort );
+
+				void stop( bool bDrain );
+
+				std::uint32_t depth( void ) const;
+
+				std::uint32_t inFlight( void ) const;
+
+				arc::gen3::device::QueueStats_t getStats( void );
+
+				static std::uint64_t now( void );
+
+			private:
+
+				typedef struct ARC_QUEUE_CELL
+				{
+					std::atomic<std::uint64_t>		u64Seq;
+					arc::gen3::device::FrameDesc_t	tDesc;
+				} Cell_t;
+
+				bool tryPush( const arc::gen3::device::FrameDesc_t& tDesc );
+
+				bool tryPop( arc::gen3::device::FrameDesc_t& tDesc );
+
+				void worker( std::function<void( void )> fnThreadInit );
+
+				void wait( std::uint32_t& uiBlocked, const bool& bAbort );
+
+				void rethrow( void );
+
+				std::unique_ptr<Cell_t[]>			m_pCells;
+				std::uint64_t						m_u64Capacity;
+				arc::gen3::device::eQueuePolicy		m_ePolicy;
+
+				alignas( 64 ) std::atomic<std::uint64_t>	m_u64Head;		// Next slot to fill ( producer )
+				alignas( 64 ) std::atomic<std::uint64_t>	m_u64Tail;		// Next slot to drain ( workers )
+				alignas( 64 ) std::atomic<std::uint64_t>	m_u64Done;		// Frames finished or dropped
+
+				std::atomic<bool>					m_bStop;
+				std::atomic<bool>					m_bDiscard;
+				std::atomic<bool>					m_bFailed;
+
+				std::atomic<std::uint64_t>			m_u64Queued;
+				std::atomic<std::uint64_t>			m_u64Dropped;
+				std::atomic<std::uint32_t>			m_uiHighWater;
+
+				std::vector<std::thread>			m_vWorkers;
+				std::uint32_t						m_uiWorkers;
+				Handler_t							m_fnHandler;
+
+				std::mutex							m_tStatsMutex;
+				std::uint64_t						m_u64Processed;
+				double								m_gWaitSum;
+				double								m_gLatencySum;
+				double								m_gLatencyMax;
+
+				std::exception_ptr					m_pError;
+		};
+
+	}	// end gen3 namespace
+}	// end arc namespace
+
+
+#endif
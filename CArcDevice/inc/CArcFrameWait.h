@@ -0,0 +1,104 @@
+// +----------------------------------------------------------------------+
+// | CArcFrameWait.h : Defines continuous readout frame wait strategies   |
+// +----------------------------------------------------------------------+
+
+#ifndef _ARC_CFRAMEWAIT_H_
+#define _ARC_CFRAMEWAIT_H_
+
+#ifdef _WINDOWS
+#pragma warning( disable: 4251 )
+#endif
+
+#include <cstdint>
+#include <atomic>
+
+#include <CArcDeviceDllMain.h>
+
+
+namespace arc
+{
+	namespace gen3
+	{
+		namespace device
+		{
+
+			// +------------------------------------------------+
+			// | How the continuous readout loop waits for the  |
+			// | next frame between frame count polls           |
+			// +------------------------------------------------+
+			typedef enum class WaitStrategy : std::uint32_t
+			{
+				SPIN = 0,			// Poll continuously. Lowest latency, uses a full core
+				HYBRID,				// Sleep until the predicted frame, then spin
+				SLEEP				// Sleep until the predicted frame, then poll at the park interval
+			} eWaitStrategy;
+
+		}	// end device namespace
+
+
+		// +--------------------------------------------------------------------+
+		// | Paces frame count polling for one continuous readout. The frame    |
+		// | period is predicted from the observed frame completions using an   |
+		// | exponentially weighted moving average. HYBRID sleeps until a spin  |
+		// | window before the predicted frame, the window being the CPU budget |
+		// | times the frame period, then spins. Frames later than the window   |
+		// | are polled at the park interval, which is also what SLEEP uses.    |
+		// |                                                                    |
+		// | Only frames seen by a poll shortly after the previous one time the |
+		// | frame period. A frame found on waking from a long sleep completed  |
+		// | at some unknown point during the sleep; it only bounds the period. |
+		// +--------------------------------------------------------------------+
+		class GEN3_CARCDEVICE_API CArcFrameWait
+		{
+			public:
+
+				CArcFrameWait( arc::gen3::device::eWaitStrategy eStrategy, double gCpuBudget, double gFirstFrame );
+
+				void start( std::uint64_t u64Now );
+
+				void wait( const bool& bAbort, const std::atomic<bool>* pStop = nullptr );
+
+				void polled( std::uint64_t u64PollTime, std::uint64_t u64LastPollTime, std::uint32_t uiFrames );
+
+				void resume( void );
+
+				double predictedPeriod( void ) const;
+
+				std::uint64_t polls( void ) const;
+
+				double cpuUsage( void ) const;
+
+				static std::uint64_t threadCpuTime( void );
+
+			private:
+
+				std::uint64_t nextFrame( void ) const;
+
+				std::uint64_t spinWindow( void ) const;
+
+				std::uint64_t parkInterval( void ) const;
+
+				arc::gen3::device::eWaitStrategy	m_eStrategy;
+				double								m_gCpuBudget;
+
+				double								m_gPeriod;			// Predicted frame period ( ns )
+				bool								m_bMeasured;		// 'true' once a period has been observed
+				std::uint64_t						m_u64Start;			// Acquisition start ( ns )
+				std::uint64_t						m_u64Frames;		// Frames seen
+				bool								m_bAnchored;		// 'true' once a frame completion has been estimated
+				bool								m_bAccurate;		// 'true' if the anchor was timed accurately
+				std::uint64_t						m_u64Anchor;		// Completion of the anchor frame ( ns )
+				std::uint64_t						m_u64AnchorFrame;	// Number of the anchor frame
+
+				std::uint64_t						m_u64Polls;
+				std::uint64_t						m_u64CpuMark;
+				std::uint64_t						m_u64WallMark;
+				std::uint64_t						m_u64CpuWaiting;
+				std::uint64_t						m_u64WallWaiting;
+		};
+
+	}	// end gen3 namespace
+}	// end arc namespace
+
+
+#endif
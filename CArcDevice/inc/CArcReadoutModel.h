@@ -0,0 +1,101 @@
+// +----------------------------------------------------------------------+
+// | CArcReadoutModel.h : Defines a learned image readout time model      |
+// +----------------------------------------------------------------------+
+
+#ifndef _ARC_CREADOUTMODEL_H_
+#define _ARC_CREADOUTMODEL_H_
+
+#ifdef _WINDOWS
+#pragma warning( disable: 4251 )
+#endif
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <mutex>
+#include <map>
+
+#include <CArcDeviceDllMain.h>
+
+
+namespace arc
+{
+	namespace gen3
+	{
+		namespace device
+		{
+
+			// +--------------------------------------------------------------------+
+			// | Readout time model for one controller configuration                |
+			// |                                                                    |
+			// |     readout time = gOverhead + pixels / gPixelRate                 |
+			// +--------------------------------------------------------------------+
+			typedef struct ARC_READOUT_MODEL
+			{
+				double			gOverhead;		// Fixed per-readout overhead ( seconds )
+				double			gPixelRate;		// Pixels per second
+				double			gRmsError;		// RMS fit residual ( seconds )
+				std::uint32_t	uiSamples;		// Number of readouts observed
+			} ReadoutModel_t;
+
+		}	// end device namespace
+
+
+		// +--------------------------------------------------------------------+
+		// | Learns readout time from observed readouts by least squares fit of |
+		// | readout time against pixel count. A separate model is kept for     |
+		// | each controller configuration word ( RCC ) and binning factor pair.|
+		// +--------------------------------------------------------------------+
+		class GEN3_CARCDEVICE_API CArcReadoutModel
+		{
+			public:
+
+				CArcReadoutModel( void );
+
+				~CArcReadoutModel( void ) = default;
+
+				void addSample( std::uint32_t uiConfig, std::uint32_t uiRowFactor, std::uint32_t uiColFactor, std::uint64_t u64Pixels, double gSeconds );
+
+				bool contains( std::uint32_t uiConfig, std::uint32_t uiRowFactor, std::uint32_t uiColFactor );
+
+				arc::gen3::device::ReadoutModel_t getModel( std::uint32_t uiConfig, std::uint32_t uiRowFactor, std::uint32_t uiColFactor );
+
+				double predict( std::uint32_t uiConfig, std::uint32_t uiRowFactor, std::uint32_t uiColFactor, std::uint64_t u64Pixels );
+
+				void clear( void );
+
+				void load( const std::string& sFilename );
+
+				void save( const std::string& sFilename );
+
+				//  Samples beyond this count are exponentially down-weighted so
+				//  the model follows slow changes in controller timing.
+				// +------------------------------------------------------------------+
+				static const std::uint32_t SAMPLE_WINDOW = 256;
+
+			private:
+
+				typedef std::tuple<std::uint32_t, std::uint32_t, std::uint32_t> Key_t;
+
+				typedef struct ARC_READOUT_SUMS
+				{
+					double			gWeight;
+					double			gSumX;
+					double			gSumY;
+					double			gSumXX;
+					double			gSumXY;
+					double			gSumYY;
+					std::uint32_t	uiSamples;
+				} Sums_t;
+
+				static arc::gen3::device::ReadoutModel_t fit( const Sums_t& tSums );
+
+				std::map<Key_t, Sums_t>		m_mSums;
+				std::mutex					m_tMutex;
+		};
+
+	}	// end gen3 namespace
+}	// end arc namespace
+
+
+#endif
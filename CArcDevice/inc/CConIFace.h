@@ -1,13 +1,32 @@
 #ifndef _CCONIFACE_H_
 #define _CCONIFACE_H_
 
+#include <cstdint>
+
 #include <CArcDeviceDllMain.h>
+#include <CArcFrameLease.h>
 
 
 namespace arc
 {
 	namespace gen3
 	{
+		namespace device
+		{
+
+			// +------------------------------------------------+
+			// | Host timestamp of a detected frame             |
+			// +------------------------------------------------+
+			typedef struct ARC_FRAME_STAMP
+			{
+				std::uint64_t	u64Monotonic;		// CLOCK_MONOTONIC ( ns ) when the frame count change was seen
+				std::int64_t	i64Realtime;		// CLOCK_REALTIME ( ns since the Unix epoch ), same instant
+				std::uint64_t	u64Latency;			// Estimated detection latency ( ns ), half the poll interval
+				std::uint64_t	u64LatencyMax;		// Upper bound on the detection latency ( ns ), the poll interval
+			} FrameStamp_t;
+
+		}	// end device namespace
+
 
 		class GEN3_CARCDEVICE_API CConIFace   // continuous Readout Interface Class
 		{
@@ -21,6 +40,63 @@ namespace arc
 											std::uint32_t   uiCols,				// # of cols in frame
 											void* pBuffer ) = 0;				// Pointer to frame start in buffer
 
+				//  Called by the acquisition loop with the host timestamp of the
+				//  frame. The default forwards to frameCallback(); override this
+				//  instead of frameCallback() to receive the timestamp.
+				virtual void timedFrameCallback( std::uint32_t   uiFramesPerBuffer,
+												 std::uint32_t   uiFrameCount,
+												 std::uint32_t   uiRows,
+												 std::uint32_t   uiCols,
+												 void* pBuffer,
+												 const arc::gen3::device::FrameStamp_t& tStamp )	// Frame detection timestamp
+				{
+					frameCallback( uiFramesPerBuffer, uiFrameCount, uiRows, uiCols, pBuffer );
+				}
+
+				//  Called by continuous() and triggered() with a lease on the
+				//  frame's common buffer slot. The lease may be copied and kept
+				//  past the callback to use the frame without copying it; check
+				//  CArcFrameLease::isValid() after reading the data. The default
+				//  forwards to timedFrameCallback().
+				virtual void leaseFrameCallback( const arc::gen3::CArcFrameLease& tLease,		// Frame lease
+												 const arc::gen3::device::FrameStamp_t& tStamp )	// Frame detection timestamp
+				{
+					timedFrameCallback( tLease.slot(), static_cast<std::uint32_t>( tLease.frame() ), tLease.rows(), tLease.cols(), tLease.data(), tStamp );
+				}
+
+				//  Called instead of frameCallback() when host co-adding is enabled
+				//  ( see CArcDevice::setContinuousCoadd() ). The accumulator is
+				//  re-used for the next co-add, so it must be consumed ( or copied )
+				//  before returning.
+				virtual void coaddCallback( std::uint32_t   uiCoaddCount,		// Co-added images delivered, starting at 1
+											std::uint32_t   uiFrameCount,		// PCI frame count of the last frame added
+											std::uint32_t   uiFrames,			// # of frames in this co-add
+											std::uint32_t   uiRows,				// # of rows in frame
+											std::uint32_t   uiCols,				// # of cols in frame
+											std::uint32_t* pBuffer ) {}			// 32-bit sum of the frames
+
+				//  Called by continuous() with the timestamp of the last frame
+				//  added to the co-add. The default forwards to coaddCallback();
+				//  override this instead of coaddCallback() to receive the
+				//  timestamp.
+				virtual void timedCoaddCallback( std::uint32_t   uiCoaddCount,
+												 std::uint32_t   uiFrameCount,
+												 std::uint32_t   uiFrames,
+												 std::uint32_t   uiRows,
+												 std::uint32_t   uiCols,
+												 std::uint32_t* pBuffer,
+												 const arc::gen3::device::FrameStamp_t& tStamp )	// Last frame detection timestamp
+				{
+					coaddCallback( uiCoaddCount, uiFrameCount, uiFrames, uiRows, uiCols, pBuffer );
+				}
+
+				//  Called by continuous() when the frame count advanced by more
+				//  frames than the common buffer holds between two polls, so some
+				//  frames were overwritten before they could be delivered. Runs on
+				//  the acquisition thread.
+				virtual void gapCallback( std::uint32_t   uiFirstFrame,			// PCI frame count of the first lost frame
+										  std::uint32_t   uiLostFrames ) {}		// # of consecutive frames lost
+
 			protected:
 
 				CConIFace( void ) = default;
@@ -0,0 +1,38 @@
+#ifndef _ARC_CROIIFACE_H_
+#define _ARC_CROIIFACE_H_
+
+#include <cstdint>
+
+#include <CArcDeviceDllMain.h>
+
+
+namespace arc
+{
+	namespace gen3
+	{
+
+		class GEN3_CARCDEVICE_API CRoiIFace   // Sub-Array ( ROI ) Loop Interface Class
+		{
+			public:
+
+				virtual ~CRoiIFace( void ) = default;
+
+				//  Called once per ROI frame from subArrayLoop(). The buffer is
+				//  re-used by the next frame, so it must be consumed ( or copied )
+				//  before returning.
+				virtual void roiFrameCallback( std::uint32_t   uiFrame,			// Frame number, starting at 1
+											   double          gTimestamp,		// Readout complete, seconds since loop start
+											   std::uint32_t   uiRows,			// # of rows in frame
+											   std::uint32_t   uiCols,			// # of cols in frame ( incl. bias )
+											   void* pBuffer ) = 0;				// Pointer to frame start in buffer
+
+			protected:
+
+				CRoiIFace( void ) = default;
+		};
+
+	}	// end gen3 namespace
+}	// end arc namespace
+
+
+#endif	// _ARC_CROIIFACE_H_
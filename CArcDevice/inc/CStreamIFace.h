@@ -0,0 +1,41 @@
+#ifndef _ARC_CSTREAMIFACE_H_
+#define _ARC_CSTREAMIFACE_H_
+
+#include <cstdint>
+
+#include <CArcDeviceDllMain.h>
+
+
+namespace arc
+{
+	namespace gen3
+	{
+
+		class GEN3_CARCDEVICE_API CStreamIFace   // Row Streaming Interface Class
+		{
+			public:
+
+				virtual ~CStreamIFace( void ) = default;
+
+				//  Called during readout each time more complete rows are in the
+				//  common buffer. Rows are in raw readout order ( not deinterlaced ).
+				virtual void rowsCallback( std::uint32_t   uiStartRow,		// First newly valid row
+										   std::uint32_t   uiEndRow,		// One past the last valid row
+										   std::uint32_t   uiRows,			// # of rows in frame
+										   std::uint32_t   uiCols,			// # of cols in frame
+										   void* pBuffer ) = 0;				// Pointer to frame start in buffer
+
+				//  Minimum number of new rows per callback. The final rows of
+				//  the frame are always delivered, even if fewer.
+				virtual std::uint32_t rowGranularity( void ) { return 1; }
+
+			protected:
+
+				CStreamIFace( void ) = default;
+		};
+
+	}	// end gen3 namespace
+}	// end arc namespace
+
+
+#endif	// _ARC_CSTREAMIFACE_H_
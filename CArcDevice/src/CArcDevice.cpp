@@ -12,13 +12,24 @@
 #include <memory>
 #include <fstream>
 #include <sstream>
+#include <iomanip>
 #include <stdexcept>
 #include <thread>
 #include <queue>
+#include <vector>
+#include <chrono>
+#include <algorithm>
 #include <cmath>
+#include <ctime>
 #include <iostream>     // for std::cerr
 
+#if defined( __SSE2__ ) || defined( _M_X64 )
+	#include <emmintrin.h>
+	#define ARC_COADD_SSE2
+#endif
+
 #include <CArcBase.h>
+#include <CArcTrace.h>
 #include <CArcDevice.h>
 #include <ArcOSDefs.h>
 #include <ArcDefs.h>
@@ -57,12 +68,44 @@ namespace arc
 		{
 			m_hDevice    = INVALID_HANDLE_VALUE;
 			m_uiCCParam   = 0;
+			m_uiBinRowFactor = 1;
+			m_uiBinColFactor = 1;
+			m_uiCoaddFrames = 1;
+			m_uiConWorkers = 0;
+			m_uiConFramesPerBuffer = 0;
+			m_eConWait = arc::gen3::device::eWaitStrategy::SPIN;
+			m_gConCpuBudget = 0.1;
+			m_bConActive = false;
+			m_bConStop = false;
+
+			m_tExecPolicy.u64PollCpuMask   = 0;
+			m_tExecPolicy.iPollPriority    = 0;
+			m_tExecPolicy.u64WorkerCpuMask = 0;
+			m_tExecPolicy.iWorkerPriority  = 0;
+			m_tExecPolicy.bLockMemory      = false;
+			m_tExecPolicy.iNumaNode        = -1;
+
+			m_tExecReport = arc::gen3::device::ExecReport_t();
+			m_uiConQueueDepth = 0;
+			m_eConQueuePolicy = arc::gen3::device::eQueuePolicy::BLOCK;
+			m_uiMetaMask = META_NONE;
+			m_uiMetaTempMode = 0;
 			m_bStoreCmds = false;
+			m_eFTState   = arc::gen3::device::eFTState::IDLE;
 
 			arc::gen3::CArcBase::zeroMemory( &m_tImgBuffer, sizeof( arc::gen3::device::ImgBuf_t ) );
+			arc::gen3::CArcBase::zeroMemory( &m_tFTStats, sizeof( arc::gen3::device::FTStats_t ) );
+			arc::gen3::CArcBase::zeroMemory( &m_tRoiStats, sizeof( arc::gen3::device::RoiStats_t ) );
+			arc::gen3::CArcBase::zeroMemory( &m_tTrigStats, sizeof( arc::gen3::device::TriggerStats_t ) );
+			arc::gen3::CArcBase::zeroMemory( &m_tLastStamp, sizeof( arc::gen3::device::FrameStamp_t ) );
+			arc::gen3::CArcBase::zeroMemory( &m_tExposeMeta, sizeof( arc::gen3::device::ExposeMetadata_t ) );
+			arc::gen3::CArcBase::zeroMemory( &m_tConStats, sizeof( arc::gen3::device::ConStats_t ) );
+			arc::gen3::CArcBase::zeroMemory( &m_tAutoTune, sizeof( arc::gen3::device::AutoTune_t ) );
 
 			m_pCLog.reset( new arc::gen3::CArcLog() );
 
+			m_pReadoutModel.reset( new arc::gen3::CArcReadoutModel() );
+
 			setDefaultTemperatureValues();
 		}
 
@@ -90,6 +133,8 @@ namespace arc
 		// +----------------------------------------------------------------------------+
 		void CArcDevice::reMapCommonBuffer( std::uint32_t uiBytes )
 		{
+			retireFrameLeases();
+
 			unMapCommonBuffer();
 
 			mapCommonBuffer( uiBytes );
@@ -605,6 +650,222 @@ namespace arc
 		}
 
 
+		// +----------------------------------------------------------------------------
+		// |  streamRows
+		// +----------------------------------------------------------------------------
+		// |  Converts a readout pixel count watermark into a "rows [ start, end ) are
+		// |  now valid in the common buffer" event. Only complete rows are reported,
+		// |  and rows are batched until at least rowGranularity() new rows exist,
+		// |  except for the last rows of the frame, which are always delivered.
+		// |
+		// |  <IN>     -> pStreamIFace - The row streaming callback interface.
+		// |  <IN>     -> uiPixelCount - The current readout pixel count.
+		// |  <IN>     -> uiRows       - The image row size ( in pixels ).
+		// |  <IN>     -> uiCols       - The image column size ( in pixels ).
+		// |  <IN/OUT> -> uiRowsSent   - The number of rows already delivered.
+		// +----------------------------------------------------------------------------
+		void CArcDevice::streamRows( arc::gen3::CStreamIFace* pStreamIFace, std::uint32_t uiPixelCount, std::uint32_t uiRows, std::uint32_t uiCols, std::uint32_t& uiRowsSent )
+		{
+			if ( pStreamIFace == nullptr || uiCols == 0 || containsError( uiPixelCount ) )
+			{
+				return;
+			}
+
+			std::uint32_t uiValidRows = std::min( uiRows, uiPixelCount / uiCols );
+
+			std::uint32_t uiGranularity = std::max( 1U, pStreamIFace->rowGranularity() );
+
+			if ( uiValidRows > uiRowsSent && ( ( uiValidRows - uiRowsSent ) >= uiGranularity || uiValidRows == uiRows ) )
+			{
+				ARC_TRACE_SPAN( "rowsCallback", "callback" );
+
+				pStreamIFace->rowsCallback( uiRowsSent, uiValidRows, uiRows, uiCols, commonBufferVA() );
+
+				uiRowsSent = uiValidRows;
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  collectExposeMetadata
+		// +----------------------------------------------------------------------------
+		// |  Runs the next pending metadata query. Called by expose() during
+		// |  integration only. A failed query ( including one skipped because the
+		// |  readout has started ) is not retried; its valid bit remains clear.
+		// |
+		// |  No query is sent while bTimeLeft is 'false', so that the commands do
+		// |  not race the controller going into readout. The temperature takes two
+		// |  polls: the first probes how the controller reports it ( SmallCam, RDT
+		// |  and high gain ), the second reads it once.
+		// |
+		// |  <IN/OUT> -> uiPending - Bit mask of the queries still to run. The bit
+		// |                          for a completed query is cleared.
+		// |  <IN>     -> bTimeLeft - 'true' if enough of the exposure remains to
+		// |                          send a query.
+		// +----------------------------------------------------------------------------
+		void CArcDevice::collectExposeMetadata( std::uint32_t& uiPending, bool bTimeLeft )
+		{
+			const std::uint32_t TEMP_PROBED    = 0x1;
+			const std::uint32_t TEMP_ARC12     = 0x2;
+			const std::uint32_t TEMP_RDT       = 0x4;
+			const std::uint32_t TEMP_HIGH_GAIN = 0x8;
+
+			if ( !bTimeLeft || uiPending == META_NONE )
+			{
+				return;
+			}
+
+			std::uint32_t uiQuery = ( uiPending & ( ~uiPending + 1 ) );	// Lowest pending bit
+
+			auto tStart = std::chrono::steady_clock::now();
+
+			try
+			{
+				switch ( uiQuery )
+				{
+					case META_TEMPERATURE:
+					{
+						if ( !( m_uiMetaTempMode & TEMP_PROBED ) )
+						{
+							std::uint32_t uiMode = TEMP_PROBED;
+
+							if ( IS_ARC12( getControllerId() ) )
+							{
+								uiMode |= TEMP_ARC12;
+							}
+
+							if ( command( { UTIL_ID, RDT } ) != ERR )
+							{
+								uiMode |= TEMP_RDT;
+							}
+
+							if ( command( { UTIL_ID, THG } ) == 1 )
+							{
+								uiMode |= TEMP_HIGH_GAIN;
+							}
+
+							m_uiMetaTempMode = uiMode;
+
+							m_tExposeMeta.gCollectTime += std::chrono::duration<double>( std::chrono::steady_clock::now() - tStart ).count();
+
+							return;		// Read on the next poll
+						}
+
+						bool bArc12 = ( ( m_uiMetaTempMode & TEMP_ARC12 ) != 0 );
+						bool bHasRDT = ( ( m_uiMetaTempMode & TEMP_RDT ) != 0 );
+
+						std::uint32_t uiAdu = 0;
+
+						if ( bArc12 )
+						{
+							uiAdu = command( { TIM_ID, RDT } );
+						}
+
+						else if ( bHasRDT )
+						{
+							uiAdu = command( { UTIL_ID, RDT } );
+						}
+
+						else
+						{
+							uiAdu = command( { UTIL_ID, RDM, ( Y_MEM | 0xC ) } );
+						}
+
+						if ( containsError( uiAdu ) )
+						{
+							THROW( "Failed to read array temperature. Reply: 0x%X", uiAdu );
+						}
+
+						m_tExposeMeta.gTemperature = calculateTemperature( ADUToVoltage( uiAdu, ( bHasRDT || bArc12 ), ( ( m_uiMetaTempMode & TEMP_HIGH_GAIN ) != 0 ) ) );
+					}
+					break;
+
+					case META_CONTROLLER_ID:
+					{
+						m_tExposeMeta.uiControllerId = getControllerId();
+					}
+					break;
+
+					case META_EXPOSURE_TIME:
+					{
+						auto uiRetVal = command( { TIM_ID, GET } );
+
+						if ( containsError( uiRetVal ) )
+						{
+							THROW( "Failed to read exposure time. Reply: 0x%X", uiRetVal );
+						}
+
+						m_tExposeMeta.uiExposureTime = uiRetVal;
+					}
+					break;
+
+					case META_CC_PARAMS:
+					{
+						m_tExposeMeta.uiCCParams = getCCParams();
+					}
+					break;
+
+					default:
+					{
+						THROW( "Unknown metadata query: 0x%X", uiQuery );
+					}
+				}
+
+				m_tExposeMeta.uiValid |= uiQuery;
+			}
+			catch ( ... ) {}
+
+			uiPending &= ~uiQuery;
+
+			m_tExposeMeta.gCollectTime += std::chrono::duration<double>( std::chrono::steady_clock::now() - tStart ).count();
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  coaddFrame
+		// +----------------------------------------------------------------------------
+		// |  Adds a 16-bit frame into a 32-bit accumulator. The first frame of a co-add
+		// |  is widened into the accumulator instead of added, which saves clearing it.
+		// |  Uses SSE2 ( eight pixels per step ) where available.
+		// |
+		// |  <IN/OUT> -> pAccum    - The 32-bit accumulator.
+		// |  <IN>     -> pFrame    - The frame to add.
+		// |  <IN>     -> u64Pixels - The number of pixels in the frame.
+		// |  <IN>     -> bFirst    - 'true' if this is the first frame of the co-add.
+		// +----------------------------------------------------------------------------
+		void CArcDevice::coaddFrame( std::uint32_t* pAccum, const std::uint16_t* pFrame, std::uint64_t u64Pixels, bool bFirst )
+		{
+			std::uint64_t i = 0;
+
+		#ifdef ARC_COADD_SSE2
+			const __m128i tZero = _mm_setzero_si128();
+
+			for ( ; i + 8 <= u64Pixels; i += 8 )
+			{
+				__m128i tPix = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pFrame + i ) );
+				__m128i tLo  = _mm_unpacklo_epi16( tPix, tZero );
+				__m128i tHi  = _mm_unpackhi_epi16( tPix, tZero );
+
+				__m128i* pDst = reinterpret_cast<__m128i*>( pAccum + i );
+
+				if ( !bFirst )
+				{
+					tLo = _mm_add_epi32( tLo, _mm_loadu_si128( pDst ) );
+					tHi = _mm_add_epi32( tHi, _mm_loadu_si128( pDst + 1 ) );
+				}
+
+				_mm_storeu_si128( pDst, tLo );
+				_mm_storeu_si128( pDst + 1, tHi );
+			}
+		#endif
+
+			for ( ; i < u64Pixels; i++ )
+			{
+				pAccum[ i ] = ( bFirst ? 0 : pAccum[ i ] ) + pFrame[ i ];
+			}
+		}
+
+
 		// +--------------------------------------------------------------------------------------------------------+
 		// | setImageSize                                                                                           |
 		// +--------------------------------------------------------------------------------------------------------+
@@ -954,6 +1215,9 @@ namespace arc
 			if ( pBinCols != nullptr ) { *pBinCols = uiBinnedCols; }
 
 			setImageSize( uiBinnedRows, uiBinnedCols );
+
+			m_uiBinRowFactor = uiRowFactor;
+			m_uiBinColFactor = uiColFactor;
 		}
 
 
@@ -1004,6 +1268,9 @@ namespace arc
 			// Update the image dimensions on the controller
 			// -------------------------------------------------------------
 			setImageSize( uiRows, uiCols );
+
+			m_uiBinRowFactor = 1;
+			m_uiBinColFactor = 1;
 		}
 
 
@@ -1279,8 +1546,10 @@ namespace arc
 		// |                   method to abort/stop either exposing or image readout.
 		// |                   NULL by default.
 		// |  <IN> -> pExpIFace - Function pointer to CExpIFace class. NULL by default.
+		// |  <IN> -> pStreamIFace - Pointer to CStreamIFace class that is notified as
+		// |                         rows become valid during readout. NULL by default.
 		// +----------------------------------------------------------------------------
-		void CArcDevice::expose( float fExpTime, std::uint32_t uiRows, std::uint32_t uiCols, const bool& bAbort, arc::gen3::CExpIFace* pExpIFace, bool bOpenShutter )
+		void CArcDevice::expose( float fExpTime, std::uint32_t uiRows, std::uint32_t uiCols, const bool& bAbort, arc::gen3::CExpIFace* pExpIFace, bool bOpenShutter, arc::gen3::CStreamIFace* pStreamIFace )
 		{
 			float			fElapsedTime		= fExpTime;
 			bool			bInReadout			= false;
@@ -1288,6 +1557,21 @@ namespace arc
 			std::uint32_t   uiLastPixelCount	= 0;
 			std::uint32_t   uiPixelCount		= 0;
 			std::uint32_t   uiExposeCounter		= 0;
+			std::uint32_t   uiRowsSent			= 0;
+
+			ARC_TRACE_SPAN( "expose", "device" );
+
+			auto pExecScope = applyExecPolicy();
+
+			arc::gen3::CArcTraceSpan tPhase;
+
+			std::chrono::steady_clock::time_point tReadoutStart;
+
+			std::uint32_t uiMetaPending = m_uiMetaMask;
+
+			arc::gen3::CArcBase::zeroMemory( &m_tExposeMeta, sizeof( arc::gen3::device::ExposeMetadata_t ) );
+
+			m_uiMetaTempMode = 0;
 
 			//
 			// Check for adequate buffer size
@@ -1300,8 +1584,12 @@ namespace arc
 			//
 			// Set the shutter position
 			//
+			tPhase.begin( "expose.shutter", "device" );
+
 			setOpenShutter( bOpenShutter );
 
+			tPhase.begin( "expose.setup", "device" );
+
 			//
 			// Set the exposure time
 			//
@@ -1315,6 +1603,8 @@ namespace arc
 			//
 			// Start the exposure
 			//
+			retireFrameLeases();
+
 			uiRetVal = command( { TIM_ID, SEX } );
 
 			if ( uiRetVal != DON )
@@ -1322,13 +1612,28 @@ namespace arc
 				THROW( "Start exposure command failed. Reply: 0x%X", uiRetVal );
 			}
 
+			tPhase.begin( "expose.integration", "device" );
+
 			while ( uiPixelCount < ( uiRows * uiCols ) )
 			{
-				if ( isReadout() )
+				if ( !bInReadout && isReadout() )
 				{
+					tPhase.begin( "expose.readout", "device" );
+
+					tReadoutStart = std::chrono::steady_clock::now();
+
 					bInReadout = true;
 				}
 
+				//
+				// Collect the requested metadata while integrating, one
+				// query per poll so readout detection is not delayed
+				//
+				if ( !bInReadout && uiMetaPending != META_NONE )
+				{
+					collectExposeMetadata( uiMetaPending, ( fElapsedTime > 1.1f ) );
+				}
+
 				// ----------------------------
 				// READ ELAPSED EXPOSURE TIME
 				// ----------------------------
@@ -1364,6 +1669,8 @@ namespace arc
 
 							if ( pExpIFace != nullptr )
 							{
+								ARC_TRACE_SPAN( "exposeCallback", "callback" );
+
 								pExpIFace->exposeCallback( fElapsedTime );
 							}
 						}
@@ -1403,9 +1710,16 @@ namespace arc
 
 				if ( bInReadout && pExpIFace != nullptr )
 				{
+					ARC_TRACE_SPAN( "readCallback", "callback" );
+
 					pExpIFace->readCallback( uiPixelCount );
 				}
 
+				if ( bInReadout && pStreamIFace != nullptr )
+				{
+					streamRows( pStreamIFace, uiPixelCount, uiRows, uiCols, uiRowsSent );
+				}
+
 				if ( bAbort )
 				{
 					stopExposure();
@@ -1441,6 +1755,26 @@ namespace arc
 
 				std::this_thread::sleep_for( std::chrono::milliseconds( 25 ) );
 			}
+
+			//
+			// Learn the readout time for this configuration
+			//
+			if ( bInReadout )
+			{
+				m_pReadoutModel->addSample( m_uiCCParam,
+											m_uiBinRowFactor,
+											m_uiBinColFactor,
+											static_cast<std::uint64_t>( uiRows ) * static_cast<std::uint64_t>( uiCols ),
+											std::chrono::duration<double>( std::chrono::steady_clock::now() - tReadoutStart ).count() );
+			}
+
+			//
+			// Deliver any rows that completed after the last poll
+			//
+			if ( pStreamIFace != nullptr )
+			{
+				streamRows( pStreamIFace, uiPixelCount, uiRows, uiCols, uiRowsSent );
+			}
 		}
 
 
@@ -1463,8 +1797,10 @@ namespace arc
 		// |                   method to abort/stop either exposing or image readout.
 		// |                   NULL by default.
 		// |  <IN> -> pExpIFace - Function pointer to CooExpIFace class. NULL by default.
+		// |  <IN> -> pStreamIFace - Pointer to CStreamIFace class that is notified as
+		// |                         rows become valid during readout. NULL by default.
 		// +----------------------------------------------------------------------------
-		void CArcDevice::expose( int devnum, const std::uint32_t &uiExpTime, std::uint32_t uiRows, std::uint32_t uiCols, const bool& bAbort, arc::gen3::CooExpIFace* pCooExpIFace, bool bOpenShutter )
+		void CArcDevice::expose( int devnum, const std::uint32_t &uiExpTime, std::uint32_t uiRows, std::uint32_t uiCols, const bool& bAbort, arc::gen3::CooExpIFace* pCooExpIFace, bool bOpenShutter, arc::gen3::CStreamIFace* pStreamIFace )
 		{
 			std::uint32_t	uiElapsedTime		= 0;
 			std::uint32_t	uiExposureTime		= 0;
@@ -1477,9 +1813,24 @@ namespace arc
 			std::uint32_t	uiExposeCounter		= 0;
 			std::uint32_t	uiFPBCount		= 0;
 			std::uint32_t	uiPCIFrameCount		= 0;
+			std::uint32_t	uiRowsSent		= 0;
 			std::uint32_t uiImageSize         	= uiRows * uiCols * sizeof( std::uint16_t );
 			std::uint32_t uiBoundedImageSize  	= getContinuousImageSize( uiImageSize );
 
+			ARC_TRACE_SPAN( "expose", "device" );
+
+			auto pExecScope = applyExecPolicy();
+
+			arc::gen3::CArcTraceSpan tPhase;
+
+			std::chrono::steady_clock::time_point tReadoutStart;
+
+			std::uint32_t uiMetaPending = m_uiMetaMask;
+
+			arc::gen3::CArcBase::zeroMemory( &m_tExposeMeta, sizeof( arc::gen3::device::ExposeMetadata_t ) );
+
+			m_uiMetaTempMode = 0;
+
 			//
 			// Check for adequate buffer size
 			//
@@ -1491,11 +1842,17 @@ namespace arc
 			//
 			// Set the shutter position
 			//
+			tPhase.begin( "expose.shutter", "device" );
+
 			setOpenShutter( bOpenShutter );
 
 			//
 			// Start the exposure
 			//
+			tPhase.begin( "expose.setup", "device" );
+
+			retireFrameLeases();
+
 			auto uiRetVal = command( { TIM_ID, SEX } );
 
 			if ( uiRetVal != DON )
@@ -1503,13 +1860,28 @@ namespace arc
 				THROW( "arc::gen3::CArcDevice::expose() Start exposure command failed. Reply: 0x%X", uiRetVal );
 			}
 
+			tPhase.begin( "expose.integration", "device" );
+
 			while ( uiPixelCount < ( uiRows * uiCols ) )
 			{
-				if ( isReadout() )
+				if ( !bInReadout && isReadout() )
 				{
+					tPhase.begin( "expose.readout", "device" );
+
+					tReadoutStart = std::chrono::steady_clock::now();
+
 					bInReadout = true;
 				}
 
+				//
+				// Collect the requested metadata while integrating, one
+				// query per poll so readout detection is not delayed
+				//
+				if ( !bInReadout && uiMetaPending != META_NONE )
+				{
+					collectExposeMetadata( uiMetaPending, ( uiRetTime > 1000 ) );
+				}
+
 				// ----------------------------
 				// READ ELAPSED EXPOSURE TIME
 				// ----------------------------
@@ -1547,6 +1919,8 @@ namespace arc
 
 							if ( pCooExpIFace != nullptr )
 							{
+								ARC_TRACE_SPAN( "exposeCallback", "callback" );
+
 								pCooExpIFace->exposeCallback( devnum, uiElapsedTime, uiExposureTime );
 							}
 						}
@@ -1559,6 +1933,8 @@ namespace arc
 					bOnce = false;
 					if ( pCooExpIFace != nullptr )
 					{
+						ARC_TRACE_SPAN( "exposeCallback", "callback" );
+
 						pCooExpIFace->exposeCallback( devnum, uiExpTime, uiExposureTime );
 					}
 				}
@@ -1592,9 +1968,16 @@ namespace arc
 
 				if ( bInReadout && pCooExpIFace != nullptr )
 				{
+					ARC_TRACE_SPAN( "readCallback", "callback" );
+
 					pCooExpIFace->readCallback( devnum, uiPixelCount, uiRows*uiCols );
 				}
 
+				if ( bInReadout && pStreamIFace != nullptr )
+				{
+					streamRows( pStreamIFace, uiPixelCount, uiRows, uiCols, uiRowsSent );
+				}
+
 				if ( bAbort )
 				{
 					stopExposure();
@@ -1628,6 +2011,25 @@ namespace arc
 				std::this_thread::sleep_for( std::chrono::milliseconds( 25 ) );
 			}
 
+			//
+			// Learn the readout time for this configuration
+			//
+			if ( bInReadout )
+			{
+				m_pReadoutModel->addSample( m_uiCCParam,
+											m_uiBinRowFactor,
+											m_uiBinColFactor,
+											static_cast<std::uint64_t>( uiRows ) * static_cast<std::uint64_t>( uiCols ),
+											std::chrono::duration<double>( std::chrono::steady_clock::now() - tReadoutStart ).count() );
+			}
+
+			if ( pStreamIFace != nullptr )
+			{
+				streamRows( pStreamIFace, uiPixelCount, uiRows, uiCols, uiRowsSent );
+			}
+
+			tPhase.end();
+
 //			std::cerr << "[ARC_API] done reading image " << uiPCIFrameCount << " on dev " << devnum << "\n";
 
 			uiPCIFrameCount = getFrameCount();
@@ -1635,6 +2037,8 @@ namespace arc
 			// Call external deinterlace and fits file functions here
 			if ( pCooExpIFace != nullptr )
 			{
+				ARC_TRACE_SPAN( "frameCallback", "callback" );
+
 //				std::cerr << "[ARC_API] calling frameCallback with devnum=" << devnum 
 //					  << " uiFPBCount=" << uiFPBCount 
 //					  << " uiPCIFrameCount=" << uiPCIFrameCount 
@@ -1697,40 +2101,59 @@ namespace arc
 
 
 		// +----------------------------------------------------------------------------
-		// |  continuous
+		// |  frame_transfer -- Caltech
 		// +----------------------------------------------------------------------------
-		// |  This method can be called to start continuous readout.  A callback for 
-		// |  each frame read out can be used to process the frame.
+		// |  Runs a frame-transfer acquisition of the specified number of frames. The
+		// |  controller shifts each exposure into the CCD storage area and starts the
+		// |  next exposure immediately, so exposure N+1 integrates while frame N is
+		// |  read out of storage and into the next common buffer slot.
+		// |
+		// |  The ftCallback is called each time a frame has been shifted into storage
+		// |  ( readout start ) and the frameCallback is called each time a frame has
+		// |  been fully read into the common buffer. Timing telemetry, including the
+		// |  achieved duty cycle, is available from getFrameTransferStats() once the
+		// |  method returns.
 		// |
 		// |  Throws std::runtime_error on error
 		// |
+		// |  <IN> -> devnum - The device number passed through to the callbacks.
 		// |  <IN> -> uiRows - The image row size ( in pixels ).
 		// |  <IN> -> uiCols - The image column size ( in pixels ).
 		// |  <IN> -> uiNumOfFrames - The number of frames to take.
-		// |  <IN> -> fExpTime - The exposure time ( in seconds ).
-		// |  <IN> -> bAbort - 'true' to cause the readout method to abort/stop either
-		// |                    exposing or image readout. Default: false
-		// |  <IN> -> pConIFace - Function pointer to callback for frame completion.
-		// |                       NULL by default.
+		// |  <IN> -> uiExpTime - The exposure time ( in milliseconds ).
+		// |  <IN> -> bAbort - 'true' to abort the acquisition. Default: false
+		// |  <IN> -> pCooExpIFace - Pointer to CooExpIFace class. NULL by default.
 		// |  <IN> -> bOpenShutter - 'true' to open the shutter during expose; 'false'
 		// |                         otherwise.
 		// +----------------------------------------------------------------------------
-		void CArcDevice::continuous( std::uint32_t uiRows, std::uint32_t uiCols, std::uint32_t uiNumOfFrames, float fExpTime, const bool& bAbort, arc::gen3::CConIFace* pConIFace, bool bOpenShutter )
+		void CArcDevice::frame_transfer( int devnum, std::uint32_t uiRows, std::uint32_t uiCols, std::uint32_t uiNumOfFrames, std::uint32_t uiExpTime, const bool& bAbort, arc::gen3::CooExpIFace* pCooExpIFace, bool bOpenShutter )
 		{
+			using Clock = std::chrono::steady_clock;
+
+			const auto tPollPeriod = std::chrono::microseconds( 100 );
+
 			std::uint32_t uiFramesPerBuffer   = 0;
 			std::uint32_t uiPCIFrameCount     = 0;
 			std::uint32_t uiLastPCIFrameCount = 0;
 			std::uint32_t uiFPBCount          = 0;
+			std::uint32_t uiTransferCount     = 0;
+			bool          bInReadout          = false;
 
 			std::uint32_t uiImageSize         = uiRows * uiCols * sizeof( std::uint16_t );
 			std::uint32_t uiBoundedImageSize  = getContinuousImageSize( uiImageSize );
 
+			arc::gen3::device::FTStats_t tStats;
+
+			arc::gen3::CArcBase::zeroMemory( &tStats, sizeof( arc::gen3::device::FTStats_t ) );
+
+			tStats.gExposureTime = static_cast<double>( uiExpTime ) / 1000.0;
+
 			//
 			// Check for adequate buffer size
 			//
 			if ( uiImageSize > commonBufferSize() )
 			{
-				THROW( "Image dimensions [ %u x %u ] exceed buffer size: %u. %Try calling ReMapCommonBuffer().", uiCols, uiRows, commonBufferSize() );
+				THROW( "Image dimensions [ %u x %u ] exceed buffer size: %u. Try calling ReMapCommonBuffer().", uiCols, uiRows, commonBufferSize() );
 			}
 
 			//
@@ -1741,18 +2164,41 @@ namespace arc
 				THROW( "Number of frames must be > 0" );
 			}
 
-			if ( bAbort )
+			//
+			// Storage readout of frame N must not land in the slot that frame N+1
+			// will be written to, so at least two frames must fit in the buffer.
+			//
+			uiFramesPerBuffer = static_cast<std::uint32_t>( commonBufferSize() / uiBoundedImageSize );
+
+			if ( uiFramesPerBuffer < 2 )
 			{
-				THROW( "Continuous readout aborted by user!" );
+				THROW( "Frame-transfer requires room for at least two [ %u x %u ] frames. Try calling ReMapCommonBuffer().", uiCols, uiRows );
 			}
 
-			uiFramesPerBuffer = static_cast<std::uint32_t>( floor( static_cast<float>( commonBufferSize() / uiBoundedImageSize ) ) );
-
 			if ( bAbort )
 			{
-				THROW( "Continuous readout aborted by user!" );
+				THROW( "Frame-transfer aborted by user!" );
 			}
 
+			std::vector<Clock::time_point> vTransferTime( uiFramesPerBuffer );
+
+			Clock::time_point tStart;
+			Clock::time_point tFirstFrame;
+			Clock::time_point tLastFrame;
+			Clock::time_point tLastTransfer;
+
+			double gReadoutSum = 0.0;
+
+			std::uint32_t uiReadouts = 0;
+
+			std::uint32_t uiDetections = 0;
+
+			std::uint32_t uiFirstCount = 0;
+
+			ARC_TRACE_SPAN( "frame_transfer", "device" );
+
+			auto pExecScope = applyExecPolicy();
+
 			try
 			{
 				// Set the frames-per-buffer
@@ -1763,11 +2209,6 @@ namespace arc
 					THROW( "Failed to set the frames per buffer (FPB). Reply: 0x%X", uiRetVal );
 				}
 
-				if ( bAbort )
-				{
-					THROW( "Continuous readout aborted by user!" );
-				}
-
 				// Set the number of frames-to-take
 				uiRetVal = command( { TIM_ID, SNF, uiNumOfFrames } );
 
@@ -1778,7 +2219,7 @@ namespace arc
 
 				if ( bAbort )
 				{
-					THROW( "Continuous readout aborted by user!" );
+					THROW( "Frame-transfer aborted by user!" );
 				}
 
 				//
@@ -1789,8 +2230,6 @@ namespace arc
 				//
 				// Set the exposure time
 				//
-				std::uint32_t uiExpTime = static_cast<std::uint32_t>( fExpTime * 1000.0 );
-
 				uiRetVal = command( { TIM_ID, SET, uiExpTime } );
 
 				if ( uiRetVal != DON )
@@ -1801,6 +2240,8 @@ namespace arc
 				//
 				// Start the exposure
 				//
+				retireFrameLeases();
+
 				uiRetVal = command( { TIM_ID, SEX } );
 
 				if ( uiRetVal != DON )
@@ -1808,51 +2249,123 @@ namespace arc
 					THROW( "Start exposure command failed. Reply: 0x%X", uiRetVal );
 				}
 
-				if ( bAbort )
-				{
-					THROW( "Continuous readout aborted by user!" );
-				}
+				tStart     = Clock::now();
+				tLastFrame = tStart;
+
+				m_eFTState = arc::gen3::device::eFTState::INTEGRATING;
 
-				// Read the images
 				while ( uiPCIFrameCount < uiNumOfFrames )
 				{
 					if ( bAbort )
 					{
-						THROW( "Continuous readout aborted by user!" );
+						THROW( "Frame-transfer aborted by user!" );
 					}
 
-					uiPCIFrameCount = getFrameCount();
+					//
+					// A new readout means the last exposure was shifted into storage
+					// and the next exposure ( if any ) has started integrating.
+					//
+					bool bReadout = isReadout();
 
-					if ( bAbort )
+					if ( bReadout && !bInReadout && uiTransferCount < uiNumOfFrames )
 					{
-						THROW( "Continuous readout aborted by user!" );
-					}
+						tLastTransfer = Clock::now();
 
-					if ( uiFPBCount >= uiFramesPerBuffer )
-					{
-							uiFPBCount = 0;
-					}
+						vTransferTime[ frameSlot( uiTransferCount + 1, uiFramesPerBuffer ) ] = tLastTransfer;
 
-					if ( uiPCIFrameCount > uiLastPCIFrameCount )
-					{
-						// Call external deinterlace and fits file functions here
-						if ( pConIFace != nullptr )
+						uiTransferCount++;
+
+						m_eFTState = ( ( uiTransferCount < uiNumOfFrames ) ? arc::gen3::device::eFTState::TRANSFER_READOUT
+																		   : arc::gen3::device::eFTState::DRAINING );
+
+						if ( pCooExpIFace != nullptr )
 						{
-							pConIFace->frameCallback( uiFPBCount,
-													  uiPCIFrameCount,
-													  uiRows,
-													  uiCols,
-													  ( commonBufferVA() + static_cast<std::uint64_t>( uiFPBCount ) * static_cast< std::uint64_t >( uiBoundedImageSize ) ) );
-						}
+							ARC_TRACE_SPAN( "ftCallback", "callback" );
 
-						uiLastPCIFrameCount = uiPCIFrameCount;
-	
-						uiFPBCount++;
+							pCooExpIFace->ftCallback( devnum );
+						}
 					}
-				}
 
-				// Set back to single image mode
-				uiRetVal = command( { TIM_ID, SNF, 1 } );
+					bInReadout = bReadout;
+
+					uiPCIFrameCount = getFrameCount();
+
+					if ( uiPCIFrameCount > uiLastPCIFrameCount )
+					{
+						auto tNow = Clock::now();
+
+						double gPeriod = std::chrono::duration<double>( tNow - tLastFrame ).count();
+
+						//
+						// The first period includes the initial integration, so it is
+						// excluded from the frame period statistics.
+						//
+						if ( tStats.uiFrames > 0 )
+						{
+							tStats.gMinFramePeriod = ( uiDetections == 1 ? gPeriod : std::min( tStats.gMinFramePeriod, gPeriod ) );
+							tStats.gMaxFramePeriod = std::max( tStats.gMaxFramePeriod, gPeriod );
+						}
+
+						else
+						{
+							tFirstFrame  = tNow;
+							uiFirstCount = std::min( uiPCIFrameCount, uiNumOfFrames );
+						}
+
+						uiDetections++;
+
+						//
+						// If the count jumped, deliver the skipped frames that are
+						// still in the buffer, oldest first.
+						//
+						std::uint32_t uiFirstFrame  = uiLastPCIFrameCount + 1;
+						auto          uiOldestFrame = static_cast<std::uint32_t>( oldestBufferedFrame( uiPCIFrameCount, uiFramesPerBuffer ) );
+
+						if ( uiOldestFrame > uiFirstFrame )
+						{
+							tStats.uiLost += ( uiOldestFrame - uiFirstFrame );
+
+							uiFirstFrame = uiOldestFrame;
+						}
+
+						for ( std::uint32_t uiFrame = uiFirstFrame; uiFrame <= uiPCIFrameCount && uiFrame <= uiNumOfFrames; uiFrame++ )
+						{
+							if ( uiFrame <= uiTransferCount )
+							{
+								gReadoutSum += std::chrono::duration<double>( tNow - vTransferTime[ frameSlot( uiFrame, uiFramesPerBuffer ) ] ).count();
+
+								uiReadouts++;
+							}
+
+							uiFPBCount = frameSlot( uiFrame, uiFramesPerBuffer );
+
+							// Call external deinterlace and fits file functions here
+							if ( pCooExpIFace != nullptr )
+							{
+								ARC_TRACE_SPAN( "frameCallback", "callback" );
+
+								pCooExpIFace->frameCallback( devnum,
+															 uiFPBCount,
+															 uiFrame,
+															 uiRows,
+															 uiCols,
+															 ( commonBufferVA() + static_cast<std::uint64_t>( uiFPBCount ) * static_cast< std::uint64_t >( uiBoundedImageSize ) ) );
+							}
+						}
+
+						tStats.uiFrames = std::min( uiPCIFrameCount, uiNumOfFrames );
+						tLastFrame      = tNow;
+
+						uiLastPCIFrameCount = uiPCIFrameCount;
+					}
+
+					std::this_thread::sleep_for( tPollPeriod );
+				}
+
+				m_eFTState = arc::gen3::device::eFTState::IDLE;
+
+				// Set back to single image mode
+				uiRetVal = command( { TIM_ID, SNF, 1 } );
 
 				if ( uiRetVal != DON )
 				{
@@ -1861,32 +2374,2159 @@ namespace arc
 			}
 			catch ( ... )
 			{
+				m_eFTState = arc::gen3::device::eFTState::IDLE;
+
 				// Set back to single image mode
 				stopContinuous();
 
-				throw std::current_exception;
+				throw;
+			}
+
+			//
+			// Duty cycle is the measured integration time over the wall time from
+			// the start of the first exposure to the last frame completion. The
+			// first exposure starts with SEX and each later one as the previous
+			// frame is shifted into storage, so the sensor integrates from SEX
+			// until the last storage transfer. If a slow callback hid some
+			// transfers from the poll loop, the last one is taken to be the last
+			// frame completion less the mean readout time.
+			//
+			tStats.gElapsedTime = std::chrono::duration<double>( tLastFrame - tStart ).count();
+
+			if ( tStats.uiFrames > uiFirstCount )
+			{
+				tStats.gMeanFramePeriod = std::chrono::duration<double>( tLastFrame - tFirstFrame ).count() / ( tStats.uiFrames - uiFirstCount );
+			}
+
+			if ( uiReadouts > 0 )
+			{
+				tStats.gMeanReadoutTime = gReadoutSum / uiReadouts;
+			}
+
+			if ( tStats.uiFrames > 0 )
+			{
+				double gIntegration = ( uiTransferCount >= tStats.uiFrames ? std::chrono::duration<double>( tLastTransfer - tStart ).count()
+																		  : ( tStats.gElapsedTime - tStats.gMeanReadoutTime ) );
+
+				gIntegration = std::max( 0.0, gIntegration );
+
+				tStats.gMeanExposureTime = gIntegration / tStats.uiFrames;
+
+				if ( tStats.gElapsedTime > 0.0 )
+				{
+					tStats.gDutyCycle = std::min( 1.0, gIntegration / tStats.gElapsedTime );
+				}
 			}
+
+			m_tFTStats = tStats;
 		}
 
 
 		// +----------------------------------------------------------------------------
-		// |  stopContinuous
+		// |  getFrameTransferState
 		// +----------------------------------------------------------------------------
-		// |  Sends abort expose/readout and sets the controller back into single
-		// |  read mode.
+		// |  Returns the current frame-transfer acquisition state. Safe to call from
+		// |  another thread while frame_transfer() is running.
+		// +----------------------------------------------------------------------------
+		arc::gen3::device::eFTState CArcDevice::getFrameTransferState( void )
+		{
+			return m_eFTState;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  setExposeMetadata
+		// +----------------------------------------------------------------------------
+		// |  Selects the metadata that expose() collects while the exposure is
+		// |  integrating, so that no controller commands are needed after readout
+		// |  ( e.g. to fill in a FITS header ). The queries run before readout starts;
+		// |  any that do not fit within a short exposure are skipped. Queries are only
+		// |  sent while more than one second of the exposure remains. The temperature
+		// |  is a single read ( not the getArrayTemperature() average ). Retrieve the
+		// |  results with getExposeMetadata().
+		// |
+		// |  <IN> -> uiMask - Bit mask of META_TEMPERATURE, META_CONTROLLER_ID,
+		// |                   META_EXPOSURE_TIME and META_CC_PARAMS, or META_ALL.
+		// |                   META_NONE disables collection ( the default ).
+		// +----------------------------------------------------------------------------
+		void CArcDevice::setExposeMetadata( std::uint32_t uiMask )
+		{
+			m_uiMetaMask = ( uiMask & META_ALL );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  getExposeMetadata
+		// +----------------------------------------------------------------------------
+		// |  Returns the metadata collected during the last expose(). Only fields
+		// |  whose bit is set in uiValid were collected.
+		// +----------------------------------------------------------------------------
+		arc::gen3::device::ExposeMetadata_t CArcDevice::getExposeMetadata( void )
+		{
+			return m_tExposeMeta;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  getFrameTransferStats
+		// +----------------------------------------------------------------------------
+		// |  Returns the timing telemetry from the last completed frame_transfer()
+		// |  run. The duty cycle is the fraction of the elapsed time during which the
+		// |  shutter was open ( i.e. the detector was integrating ).
+		// +----------------------------------------------------------------------------
+		arc::gen3::device::FTStats_t CArcDevice::getFrameTransferStats( void )
+		{
+			return m_tFTStats;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  subArrayLoop
+		// +----------------------------------------------------------------------------
+		// |  Repeatedly acquires a sub-array ( ROI ) at the highest cadence the
+		// |  controller allows. Intended for guiding and focus. The sub-array, shutter
+		// |  and exposure time are set once; each frame then costs a single SEX
+		// |  command plus pixel count polling. Most of the exposure time is slept
+		// |  through and only the readout is polled finely. Each frame is passed to
+		// |  the callback with its readout complete timestamp. The controller is
+		// |  returned to full frame mode on exit. Achieved cadence and jitter are
+		// |  available from getSubArrayLoopStats().
 		// |
 		// |  Throws std::runtime_error on error
+		// |
+		// |  <IN> -> uiRow - The row # of the center of the sub-array in pixels
+		// |  <IN> -> uiCol - The col # of the center of the sub-array in pixels
+		// |  <IN> -> uiSubRows - The sub-array row count in pixels
+		// |  <IN> -> uiSubCols - The sub-array col count in pixels
+		// |  <IN> -> uiBiasOffset - The offset of the bias region in pixels
+		// |  <IN> -> uiBiasCols - The col count of the bias region in pixels
+		// |  <IN> -> uiNumOfFrames - The number of frames to take. If 0, the loop
+		// |                          runs until bAbort is set, which then ends the
+		// |                          loop normally.
+		// |  <IN> -> fExpTime - The exposure time ( in seconds ).
+		// |  <IN> -> bAbort - 'true' to stop the loop. Default: false
+		// |  <IN> -> pRoiIFace - Pointer to the frame callback. NULL by default.
+		// |  <IN> -> bOpenShutter - 'true' to open the shutter during expose; 'false'
+		// |                         otherwise.
 		// +----------------------------------------------------------------------------
-		void CArcDevice::stopContinuous( void )
+		void CArcDevice::subArrayLoop( std::uint32_t uiRow, std::uint32_t uiCol, std::uint32_t uiSubRows, std::uint32_t uiSubCols, std::uint32_t uiBiasOffset, std::uint32_t uiBiasCols,
+									   std::uint32_t uiNumOfFrames, float fExpTime, const bool& bAbort, arc::gen3::CRoiIFace* pRoiIFace, bool bOpenShutter )
 		{
-			stopExposure();
+			using Clock = std::chrono::steady_clock;
 
-			auto uiRetVal = command( { TIM_ID, SNF, 1 } );
+			const auto tPollPeriod  = std::chrono::microseconds( 250 );
+			const auto tWakeMargin  = std::chrono::milliseconds( 2 );
+			const auto tStallPeriod = std::chrono::milliseconds( 25 * READ_TIMEOUT );	// Same limit as expose()
 
-			if ( uiRetVal != DON )
+			std::uint32_t uiOldRows = 0;
+			std::uint32_t uiOldCols = 0;
+			std::uint32_t uiRows    = uiSubRows;
+			std::uint32_t uiCols    = uiSubCols + uiBiasCols;
+			std::uint32_t uiFrame   = 0;
+
+			arc::gen3::CArcBase::zeroMemory( &m_tRoiStats, sizeof( arc::gen3::device::RoiStats_t ) );
+
+			ARC_TRACE_SPAN( "subArrayLoop", "device" );
+
+			auto pExecScope = applyExecPolicy();
+
+			arc::gen3::CArcTraceSpan tPhase;
+
+			if ( uiSubRows == 0 || uiSubCols == 0 )
 			{
-				THROW( "Failed to set number of frames ( SNF ) to 1. Reply: 0x%X", uiRetVal );
+				THROW_INVALID_ARGUMENT( "Invalid sub-array size [ %u x %u ].", uiSubCols, uiSubRows );
+			}
+
+			//
+			// Check for adequate buffer size
+			//
+			if ( ( static_cast<std::uint64_t>( uiRows ) * static_cast< std::uint64_t >( uiCols ) * sizeof( std::uint16_t ) ) > commonBufferSize() )
+			{
+				THROW( "Image dimensions [ %u x %u ] exceed buffer size: %u. Try calling ReMapCommonBuffer().", uiCols, uiRows, commonBufferSize() );
+			}
+
+			if ( bAbort )
+			{
+				THROW( "Sub-array loop aborted by user!" );
+			}
+
+			auto tExpTime = std::chrono::microseconds( static_cast<std::int64_t>( fExpTime * 1.0e6 ) );
+
+			Clock::time_point tStart;
+			Clock::time_point tFirstFrame;
+			Clock::time_point tLastFrame;
+
+			double gPeriodSum   = 0.0;
+			double gPeriodSumSq = 0.0;
+
+			tPhase.begin( "subArrayLoop.setup", "device" );
+
+			setSubArray( uiOldRows, uiOldCols, uiRow, uiCol, uiSubRows, uiSubCols, uiBiasOffset, uiBiasCols );
+
+			try
+			{
+				//
+				// Set the shutter position
+				//
+				setOpenShutter( bOpenShutter );
+
+				//
+				// Set the exposure time
+				//
+				auto uiRetVal = command( { TIM_ID, SET, static_cast<std::uint32_t>( fExpTime * 1000.0 ) } );
+
+				if ( uiRetVal != DON )
+				{
+					THROW( "Set exposure time failed. Reply: 0x%X", uiRetVal );
+				}
+
+				tStart     = Clock::now();
+				tLastFrame = tStart;
+
+				while ( uiNumOfFrames == 0 || uiFrame < uiNumOfFrames )
+				{
+					if ( bAbort )
+					{
+						break;
+					}
+
+					//
+					// Start the exposure
+					//
+					tPhase.begin( "subArrayLoop.integration", "device" );
+
+					retireFrameLeases();
+
+					uiRetVal = command( { TIM_ID, SEX } );
+
+					if ( uiRetVal != DON )
+					{
+						THROW( "Start exposure command failed. Reply: 0x%X", uiRetVal );
+					}
+
+					auto tWake = Clock::now() + tExpTime - tWakeMargin;
+
+					while ( !bAbort && Clock::now() < tWake )
+					{
+						std::this_thread::sleep_for( std::min<Clock::duration>( tWake - Clock::now(), std::chrono::milliseconds( 25 ) ) );
+					}
+
+					//
+					// Poll the readout
+					//
+					tPhase.begin( "subArrayLoop.readout", "device" );
+
+					std::uint32_t uiPixelCount     = 0;
+					std::uint32_t uiLastPixelCount = 0;
+
+					auto tLastChange = Clock::now();
+
+					while ( !bAbort && ( uiPixelCount = getPixelCount() ) < ( uiRows * uiCols ) )
+					{
+						if ( containsError( uiPixelCount ) )
+						{
+							stopExposure();
+
+							THROW( "Failed to read pixel count!" );
+						}
+
+						auto tNow = Clock::now();
+
+						if ( uiPixelCount != uiLastPixelCount )
+						{
+							uiLastPixelCount = uiPixelCount;
+							tLastChange      = tNow;
+						}
+						else if ( ( tNow - tLastChange ) > tStallPeriod )
+						{
+							stopExposure();
+
+							THROW( "Read timeout!" );
+						}
+
+						std::this_thread::sleep_for( tPollPeriod );
+					}
+
+					if ( bAbort )
+					{
+						stopExposure();
+
+						break;
+					}
+
+					auto tFrame = Clock::now();
+
+					uiFrame++;
+
+					if ( uiFrame == 1 )
+					{
+						tFirstFrame = tFrame;
+					}
+					else
+					{
+						double gPeriod = std::chrono::duration<double>( tFrame - tLastFrame ).count();
+
+						m_tRoiStats.gMinFramePeriod = ( uiFrame == 2 ? gPeriod : std::min( m_tRoiStats.gMinFramePeriod, gPeriod ) );
+						m_tRoiStats.gMaxFramePeriod = std::max( m_tRoiStats.gMaxFramePeriod, gPeriod );
+
+						gPeriodSum   += gPeriod;
+						gPeriodSumSq += gPeriod * gPeriod;
+					}
+
+					tLastFrame = tFrame;
+
+					m_tRoiStats.uiFrames = uiFrame;
+
+					if ( pRoiIFace != nullptr )
+					{
+						tPhase.begin( "roiFrameCallback", "callback" );
+
+						pRoiIFace->roiFrameCallback( uiFrame,
+													 std::chrono::duration<double>( tFrame - tStart ).count(),
+													 uiRows,
+													 uiCols,
+													 commonBufferVA() );
+					}
+				}
+
+				tPhase.end();
+			}
+			catch ( ... )
+			{
+				try
+				{
+					unSetSubArray( uiOldRows, uiOldCols );
+				}
+				catch ( ... ) {}
+
+				throw;
 			}
+
+			unSetSubArray( uiOldRows, uiOldCols );
+
+			//
+			// Cadence and jitter are taken from the completion times, excluding
+			// the first frame ( which has no preceding frame ).
+			//
+			m_tRoiStats.gElapsedTime = std::chrono::duration<double>( tLastFrame - tStart ).count();
+
+			if ( uiFrame > 1 )
+			{
+				double gIntervals = static_cast<double>( uiFrame - 1 );
+
+				m_tRoiStats.gMeanFramePeriod = std::chrono::duration<double>( tLastFrame - tFirstFrame ).count() / gIntervals;
+				m_tRoiStats.gCadence         = 1.0 / m_tRoiStats.gMeanFramePeriod;
+				m_tRoiStats.gJitter          = std::sqrt( std::max( 0.0, gPeriodSumSq / gIntervals - ( gPeriodSum / gIntervals ) * ( gPeriodSum / gIntervals ) ) );
+			}
+
+			if ( bAbort && uiNumOfFrames != 0 )
+			{
+				THROW( "Sub-array loop aborted by user!" );
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  getSubArrayLoopStats
+		// +----------------------------------------------------------------------------
+		// |  Returns the timing telemetry from the last subArrayLoop() run. Cadence is
+		// |  the mean frame rate; jitter is the standard deviation of the frame period.
+		// +----------------------------------------------------------------------------
+		arc::gen3::device::RoiStats_t CArcDevice::getSubArrayLoopStats( void )
+		{
+			return m_tRoiStats;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  triggered
+		// +----------------------------------------------------------------------------
+		// |  Acquires frames whose exposures are started by an external hardware
+		// |  trigger. The controller is put into trigger mode ( STM 1 ) and armed with
+		// |  SEX; each trigger then starts one exposure. The readout start of every
+		// |  frame is detected by fine polling and its host timestamp is recorded (
+		// |  see getTriggerTimestamps() ). Completed frames are delivered as frame
+		// |  leases through CConIFace::leaseFrameCallback(), as continuous() does.
+		// |  The controller is returned to free running, single image mode on exit.
+		// |
+		// |  Throws std::runtime_error on error
+		// |
+		// |  <IN> -> uiRows - The image row size ( in pixels ).
+		// |  <IN> -> uiCols - The image column size ( in pixels ).
+		// |  <IN> -> uiNumOfFrames - The number of triggered frames to take.
+		// |  <IN> -> fExpTime - The exposure time ( in seconds ).
+		// |  <IN> -> bAbort - 'true' to cause the method to abort/stop waiting for
+		// |                    triggers or image readout. Default: false
+		// |  <IN> -> pConIFace - Function pointer to callback for frame completion.
+		// |                       NULL by default.
+		// |  <IN> -> bOpenShutter - 'true' to open the shutter during expose; 'false'
+		// |                         otherwise.
+		// +----------------------------------------------------------------------------
+		void CArcDevice::triggered( std::uint32_t uiRows, std::uint32_t uiCols, std::uint32_t uiNumOfFrames, float fExpTime, const bool& bAbort, arc::gen3::CConIFace* pConIFace, bool bOpenShutter )
+		{
+			using Clock = std::chrono::steady_clock;
+
+			const auto tPollPeriod = std::chrono::microseconds( 100 );
+
+			std::uint32_t uiFramesPerBuffer   = 0;
+			std::uint32_t uiPCIFrameCount     = 0;
+			std::uint32_t uiLastPCIFrameCount = 0;
+			std::uint32_t uiFPBCount          = 0;
+			bool          bInReadout          = false;
+
+			std::uint32_t uiImageSize         = uiRows * uiCols * sizeof( std::uint16_t );
+			std::uint32_t uiBoundedImageSize  = getContinuousImageSize( uiImageSize );
+
+			std::shared_ptr<arc::gen3::CArcFrameRing> pRing;
+
+			auto tCall = Clock::now();
+
+			arc::gen3::CArcBase::zeroMemory( &m_tTrigStats, sizeof( arc::gen3::device::TriggerStats_t ) );
+
+			m_vTrigTimestamps.clear();
+
+			ARC_TRACE_SPAN( "triggered", "device" );
+
+			auto pExecScope = applyExecPolicy();
+
+			arc::gen3::CArcTraceSpan tPhase;
+
+			//
+			// Check for adequate buffer size
+			//
+			if ( uiImageSize == 0 || uiImageSize > commonBufferSize() )
+			{
+				THROW( "Image dimensions [ %u x %u ] exceed buffer size: %u. Try calling ReMapCommonBuffer().", uiCols, uiRows, commonBufferSize() );
+			}
+
+			if ( uiNumOfFrames == 0 )
+			{
+				THROW( "Number of frames must be > 0" );
+			}
+
+			if ( bAbort )
+			{
+				THROW( "Triggered readout aborted by user!" );
+			}
+
+			//
+			// A frame is delivered from its slot while the next trigger writes the
+			// following one, so at least two frames must fit in the buffer.
+			//
+			uiFramesPerBuffer = static_cast<std::uint32_t>( commonBufferSize() / uiBoundedImageSize );
+
+			if ( uiFramesPerBuffer < 2 )
+			{
+				THROW( "Triggered readout requires room for at least two [ %u x %u ] frames. Try calling ReMapCommonBuffer().", uiCols, uiRows );
+			}
+
+			m_vTrigTimestamps.reserve( uiNumOfFrames );
+
+			Clock::time_point tArmed;
+			Clock::time_point tLastPoll;
+
+			double gPeriodSum   = 0.0;
+			double gPeriodSumSq = 0.0;
+
+			try
+			{
+				tPhase.begin( "triggered.arm", "device" );
+
+				// Set the frames-per-buffer
+				auto uiRetVal = command( { TIM_ID, FPB, uiFramesPerBuffer } );
+
+				if ( uiRetVal != DON )
+				{
+					THROW( "Failed to set the frames per buffer (FPB). Reply: 0x%X", uiRetVal );
+				}
+
+				// Set the number of frames-to-take
+				uiRetVal = command( { TIM_ID, SNF, uiNumOfFrames } );
+
+				if ( uiRetVal != DON )
+				{
+					THROW( "Failed to set the number of frames (SNF). Reply: 0x%X", uiRetVal );
+				}
+
+				//
+				// Set the shutter position
+				//
+				setOpenShutter( bOpenShutter );
+
+				//
+				// Set the exposure time
+				//
+				uiRetVal = command( { TIM_ID, SET, static_cast<std::uint32_t>( fExpTime * 1000.0 ) } );
+
+				if ( uiRetVal != DON )
+				{
+					THROW( "Set exposure time failed. Reply: 0x%X", uiRetVal );
+				}
+
+				//
+				// Enable the external trigger
+				//
+				uiRetVal = command( { TIM_ID, STM, 1 } );
+
+				if ( uiRetVal != DON )
+				{
+					THROW( "Failed to enable trigger mode (STM). Reply: 0x%X", uiRetVal );
+				}
+
+				if ( bAbort )
+				{
+					THROW( "Triggered readout aborted by user!" );
+				}
+
+				//
+				// Arm. Exposures now start on each trigger.
+				//
+				// Lease the common buffer slots to this acquisition
+				pRing = beginFrameLeases( uiFramesPerBuffer );
+
+				uiRetVal = command( { TIM_ID, SEX } );
+
+				if ( uiRetVal != DON )
+				{
+					THROW( "Start exposure command failed. Reply: 0x%X", uiRetVal );
+				}
+
+				tArmed    = Clock::now();
+				tLastPoll = tArmed;
+
+				std::uint64_t u64LastPoll = monotonicTime();
+
+				m_tTrigStats.gArmLatency = std::chrono::duration<double>( tArmed - tCall ).count();
+
+				tPhase.begin( "triggered.armed", "device" );
+
+				while ( uiPCIFrameCount < uiNumOfFrames )
+				{
+					if ( bAbort )
+					{
+						THROW( "Triggered readout aborted by user!" );
+					}
+
+					//
+					// A rising readout edge marks the end of a triggered exposure
+					//
+					bool bReadout = isReadout();
+
+					auto tNow = Clock::now();
+
+					m_tTrigStats.gMaxPollGap = std::max( m_tTrigStats.gMaxPollGap, std::chrono::duration<double>( tNow - tLastPoll ).count() );
+
+					tLastPoll = tNow;
+
+					if ( bReadout && !bInReadout && m_vTrigTimestamps.size() < uiNumOfFrames )
+					{
+						m_vTrigTimestamps.push_back( std::chrono::duration<double>( tNow - tArmed ).count() );
+
+						auto uiStarts = m_vTrigTimestamps.size();
+
+						if ( uiStarts > 1 )
+						{
+							double gPeriod = m_vTrigTimestamps[ uiStarts - 1 ] - m_vTrigTimestamps[ uiStarts - 2 ];
+
+							m_tTrigStats.gMinPeriod = ( uiStarts == 2 ? gPeriod : std::min( m_tTrigStats.gMinPeriod, gPeriod ) );
+							m_tTrigStats.gMaxPeriod = std::max( m_tTrigStats.gMaxPeriod, gPeriod );
+
+							gPeriodSum   += gPeriod;
+							gPeriodSumSq += gPeriod * gPeriod;
+						}
+					}
+
+					bInReadout = bReadout;
+
+					uiPCIFrameCount = getFrameCount();
+
+					std::uint64_t u64Poll = monotonicTime();
+
+					pRing->publish( uiPCIFrameCount );
+
+					if ( uiPCIFrameCount > uiLastPCIFrameCount )
+					{
+						m_tTrigStats.uiFrames = std::min( uiPCIFrameCount, uiNumOfFrames );
+
+						arc::gen3::device::FrameStamp_t tStamp;
+
+						stampFrame( tStamp, u64Poll, u64LastPoll );
+
+						//
+						// If the count jumped, deliver the skipped frames that are
+						// still in the buffer, oldest first.
+						//
+						std::uint32_t uiFirstFrame  = uiLastPCIFrameCount + 1;
+						auto          uiOldestFrame = static_cast<std::uint32_t>( oldestBufferedFrame( uiPCIFrameCount, uiFramesPerBuffer ) );
+
+						if ( uiOldestFrame > uiFirstFrame )
+						{
+							m_tTrigStats.uiLost += ( uiOldestFrame - uiFirstFrame );
+
+							if ( pConIFace != nullptr )
+							{
+								pConIFace->gapCallback( uiFirstFrame, ( uiOldestFrame - uiFirstFrame ) );
+							}
+
+							uiFirstFrame = uiOldestFrame;
+						}
+
+						for ( std::uint32_t uiFrame = uiFirstFrame; uiFrame <= uiPCIFrameCount && uiFrame <= uiNumOfFrames; uiFrame++ )
+						{
+							uiFPBCount = frameSlot( uiFrame, uiFramesPerBuffer );
+
+							// Call external deinterlace and fits file functions here
+							if ( pConIFace != nullptr )
+							{
+								ARC_TRACE_SPAN( "frameCallback", "callback" );
+
+								std::uint8_t* pFrame = ( commonBufferVA() + static_cast<std::uint64_t>( uiFPBCount ) * static_cast< std::uint64_t >( uiBoundedImageSize ) );
+
+								arc::gen3::CArcFrameLease tLease( pRing, uiFrame, uiFPBCount, uiRows, uiCols, pFrame );
+
+								pConIFace->leaseFrameCallback( tLease, tStamp );
+							}
+						}
+
+						uiLastPCIFrameCount = uiPCIFrameCount;
+					}
+
+					u64LastPoll = u64Poll;
+
+					std::this_thread::sleep_for( tPollPeriod );
+				}
+
+				tPhase.end();
+
+				// Back to free running, single image mode
+				uiRetVal = command( { TIM_ID, STM, 0 } );
+
+				if ( uiRetVal != DON )
+				{
+					THROW( "Failed to disable trigger mode (STM). Reply: 0x%X", uiRetVal );
+				}
+
+				uiRetVal = command( { TIM_ID, SNF, 1 } );
+
+				if ( uiRetVal != DON )
+				{
+					THROW( "Failed to set number of frames (SNF) to 1. Reply: 0x%X", uiRetVal );
+				}
+			}
+			catch ( ... )
+			{
+				try
+				{
+					command( { TIM_ID, STM, 0 } );
+
+					// Set back to single image mode
+					stopContinuous();
+				}
+				catch ( ... ) {}
+
+				throw;
+			}
+
+			if ( m_vTrigTimestamps.size() > 1 )
+			{
+				double gIntervals = static_cast<double>( m_vTrigTimestamps.size() - 1 );
+
+				m_tTrigStats.gMeanPeriod = gPeriodSum / gIntervals;
+				m_tTrigStats.gJitter     = std::sqrt( std::max( 0.0, gPeriodSumSq / gIntervals - m_tTrigStats.gMeanPeriod * m_tTrigStats.gMeanPeriod ) );
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  getTriggerStats
+		// +----------------------------------------------------------------------------
+		// |  Returns the timing telemetry from the last triggered() run. The maximum
+		// |  poll gap bounds the host latency in detecting each readout start.
+		// +----------------------------------------------------------------------------
+		arc::gen3::device::TriggerStats_t CArcDevice::getTriggerStats( void )
+		{
+			return m_tTrigStats;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  getTriggerTimestamps
+		// +----------------------------------------------------------------------------
+		// |  Returns the host timestamp of each detected readout start from the last
+		// |  triggered() run, in seconds since the controller was armed. The trigger
+		// |  time of frame N is approximately its readout start minus the exposure
+		// |  time.
+		// +----------------------------------------------------------------------------
+		std::vector<double> CArcDevice::getTriggerTimestamps( void )
+		{
+			return m_vTrigTimestamps;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  continuous
+		// +----------------------------------------------------------------------------
+		// |  This method can be called to start continuous readout.  A callback for 
+		// |  each frame read out can be used to process the frame.
+		// |
+		// |  With uiNumOfFrames = 0 the readout streams until stopContinuous() is
+		// |  called ( from another thread ) or bAbort is set, and then returns
+		// |  normally. The controller runs at most getContinuousRunLimit() frames
+		// |  per start exposure, so a stream re-arms it after each run. Frames are
+		// |  numbered from 1 with 64-bit sequence numbers ( CArcFrameLease::frame() )
+		// |  that carry across runs and 32-bit frame count wraparound; the 32-bit
+		// |  frame counts passed to the other callbacks are the low 32 bits.
+		// |
+		// |  Throws std::runtime_error on error
+		// |  Throws std::invalid_argument if uiNumOfFrames exceeds the run limit
+		// |
+		// |  <IN> -> uiRows - The image row size ( in pixels ).
+		// |  <IN> -> uiCols - The image column size ( in pixels ).
+		// |  <IN> -> uiNumOfFrames - The number of frames to take. 0 to stream until
+		// |                          stopped. Must not exceed getContinuousRunLimit().
+		// |  <IN> -> fExpTime - The exposure time ( in seconds ).
+		// |  <IN> -> bAbort - 'true' to cause the readout method to abort/stop either
+		// |                    exposing or image readout. Default: false
+		// |  <IN> -> pConIFace - Function pointer to callback for frame completion.
+		// |                       NULL by default.
+		// |  <IN> -> bOpenShutter - 'true' to open the shutter during expose; 'false'
+		// |                         otherwise.
+		// +----------------------------------------------------------------------------
+		void CArcDevice::continuous( std::uint32_t uiRows, std::uint32_t uiCols, std::uint32_t uiNumOfFrames, float fExpTime, const bool& bAbort, arc::gen3::CConIFace* pConIFace, bool bOpenShutter )
+		{
+			std::uint32_t uiFramesPerBuffer   = 0;
+			std::uint32_t uiPCIFrameCount     = 0;
+			std::uint32_t uiFPBCount          = 0;
+			std::uint32_t uiRunFrames         = uiNumOfFrames;
+
+			bool          bStream             = ( uiNumOfFrames == 0 );
+			std::uint64_t u64NumOfFrames      = ( bStream ? UINT64_MAX : uiNumOfFrames );
+			std::uint64_t u64FrameCount       = 0;
+			std::uint64_t u64LastFrameCount   = 0;
+			std::uint64_t u64RunBase          = 0;
+			std::uint64_t u64RunFrames        = 0;
+			bool          bRearmed            = false;
+
+			std::uint32_t uiImageSize         = uiRows * uiCols * sizeof( std::uint16_t );
+			std::uint32_t uiBoundedImageSize  = getContinuousImageSize( uiImageSize );
+
+			std::uint32_t uiCoaddFrames       = m_uiCoaddFrames;
+			std::uint32_t uiCoaddPending      = 0;
+			std::uint32_t uiCoaddCount        = 0;
+			std::uint64_t u64CoaddFrame       = 0;
+
+			arc::gen3::device::FrameStamp_t tCoaddStamp;
+
+			std::unique_ptr<std::uint32_t[]> pCoadd;
+
+			arc::gen3::CArcFrameQueue* pQueue = nullptr;
+
+			std::shared_ptr<arc::gen3::CArcFrameRing> pRing;
+
+			ARC_TRACE_SPAN( "continuous", "device" );
+
+			auto pExecScope = applyExecPolicy();
+
+			arc::gen3::CArcTraceSpan tPhase;
+
+			//
+			// Check for adequate buffer size
+			//
+			if ( uiImageSize > commonBufferSize() )
+			{
+				THROW( "Image dimensions [ %u x %u ] exceed buffer size: %u. %Try calling ReMapCommonBuffer().", uiCols, uiRows, commonBufferSize() );
+			}
+
+			//
+			// The controller frame count ( SNF ) is limited; longer runs must stream
+			//
+			if ( uiNumOfFrames > getContinuousRunLimit() )
+			{
+				THROW_INVALID_ARGUMENT( "Number of frames ( %u ) exceeds the controller limit ( %u ). Use 0 to stream until stopped.", uiNumOfFrames, getContinuousRunLimit() );
+			}
+
+			if ( bAbort )
+			{
+				THROW( "Continuous readout aborted by user!" );
+			}
+
+			//
+			// A frame is delivered from its slot while the controller writes the
+			// following one, so at least two frames must fit in the buffer.
+			//
+			uiFramesPerBuffer = static_cast<std::uint32_t>( floor( static_cast<float>( commonBufferSize() / uiBoundedImageSize ) ) );
+
+			if ( uiFramesPerBuffer < 2 )
+			{
+				THROW( "Continuous readout requires room for at least two [ %u x %u ] frames. Try calling ReMapCommonBuffer().", uiCols, uiRows );
+			}
+
+			if ( m_uiConFramesPerBuffer > 0 )
+			{
+				uiFramesPerBuffer = std::min( uiFramesPerBuffer, std::max( 2U, m_uiConFramesPerBuffer ) );
+			}
+
+			arc::gen3::CArcBase::zeroMemory( &m_tConStats, sizeof( arc::gen3::device::ConStats_t ) );
+
+			m_tConStats.uiFramesPerBuffer = uiFramesPerBuffer;
+
+			//
+			// A stream runs the controller in whole passes over the buffer slots
+			//
+			if ( bStream )
+			{
+				uiRunFrames = std::max( uiFramesPerBuffer, ( getContinuousRunLimit() / uiFramesPerBuffer ) * uiFramesPerBuffer );
+			}
+
+			//
+			// Allocate the host co-add accumulator
+			//
+			if ( uiCoaddFrames > 1 )
+			{
+				pCoadd.reset( new std::uint32_t[ static_cast<std::uint64_t>( uiRows ) * static_cast<std::uint64_t>( uiCols ) ] );
+			}
+
+			//
+			// Start the frame queue workers. The queued plus in-flight frames are
+			// kept fewer than the common buffer holds, so a frame is not overwritten
+			// before a worker has finished with it.
+			//
+			if ( m_uiConWorkers > 0 && pConIFace != nullptr && pCoadd == nullptr )
+			{
+				std::uint32_t uiQueueDepth = std::max( 1U, uiFramesPerBuffer - 1 );
+
+				if ( m_uiConQueueDepth > 0 )
+				{
+					uiQueueDepth = std::min( m_uiConQueueDepth, uiQueueDepth );
+				}
+
+				std::unique_ptr<arc::gen3::CArcFrameQueue> pNewQueue( new arc::gen3::CArcFrameQueue( uiQueueDepth, m_eConQueuePolicy ) );
+
+				pNewQueue->start( m_uiConWorkers, [ pConIFace ]( const arc::gen3::device::FrameDesc_t& tDesc )
+				{
+					ARC_TRACE_SPAN( "frameCallback", "callback" );
+
+					pConIFace->leaseFrameCallback( tDesc.tLease, tDesc.tStamp );
+				},
+				[ this ]( void )
+				{
+					applyWorkerExecPolicy();
+				} );
+
+				std::lock_guard<std::mutex> tLock( m_tQueueMutex );
+
+				m_pFrameQueue = std::move( pNewQueue );
+
+				pQueue = m_pFrameQueue.get();
+			}
+
+			if ( bAbort )
+			{
+				if ( pQueue != nullptr )
+				{
+					pQueue->stop( false );
+				}
+
+				THROW( "Continuous readout aborted by user!" );
+			}
+
+			//
+			// The run is active from here, so a stopContinuous() from another
+			// thread during the setup below is seen by the acquisition loop
+			// instead of racing it with controller commands.
+			//
+			m_bConStop.store( false, std::memory_order_release );
+			m_bConActive.store( true, std::memory_order_release );
+
+			try
+			{
+				tPhase.begin( "continuous.setup", "device" );
+
+				// Set the frames-per-buffer
+				auto uiRetVal = command( { TIM_ID, FPB, uiFramesPerBuffer } );
+
+				if ( uiRetVal != DON )
+				{
+					THROW( "Failed to set the frames per buffer (FPB). Reply: 0x%X", uiRetVal );
+				}
+
+				if ( bAbort )
+				{
+					THROW( "Continuous readout aborted by user!" );
+				}
+
+				// Set the number of frames-to-take
+				uiRetVal = command( { TIM_ID, SNF, uiRunFrames } );
+
+				if ( uiRetVal != DON )
+				{
+					THROW( "Failed to set the number of frames (SNF). Reply: 0x%X", uiRetVal );
+				}
+
+				if ( bAbort )
+				{
+					THROW( "Continuous readout aborted by user!" );
+				}
+
+				//
+				// Set the shutter position
+				//
+				tPhase.begin( "continuous.shutter", "device" );
+
+				setOpenShutter( bOpenShutter );
+
+				tPhase.begin( "continuous.setup", "device" );
+
+				//
+				// Set the exposure time
+				//
+				std::uint32_t uiExpTime = static_cast<std::uint32_t>( fExpTime * 1000.0 );
+
+				uiRetVal = command( { TIM_ID, SET, uiExpTime } );
+
+				if ( uiRetVal != DON )
+				{
+					THROW( "Set exposure time failed. Reply: 0x%X", uiRetVal );
+				}
+
+				//
+				// Start the exposure
+				//
+				// Lease the common buffer slots to this acquisition
+				pRing = beginFrameLeases( uiFramesPerBuffer );
+
+				//
+				// Do not start the controller if the run was already stopped
+				//
+				if ( !m_bConStop.load( std::memory_order_acquire ) )
+				{
+					uiRetVal = command( { TIM_ID, SEX } );
+
+					if ( uiRetVal != DON )
+					{
+						THROW( "Start exposure command failed. Reply: 0x%X", uiRetVal );
+					}
+				}
+
+				if ( bAbort )
+				{
+					THROW( "Continuous readout aborted by user!" );
+				}
+
+				tPhase.begin( "continuous.acquire", "device" );
+
+				std::uint64_t u64LastPoll = monotonicTime();
+
+				double gLatencySum = 0.0;
+
+				std::uint64_t u64Detections = 0;
+
+				arc::gen3::CArcFrameWait tWait( m_eConWait, m_gConCpuBudget, fExpTime );
+
+				tWait.start( u64LastPoll );
+
+				m_tConStats.eWait      = m_eConWait;
+				m_tConStats.gCpuBudget = m_gConCpuBudget;
+				m_tConStats.uiRuns     = 1;
+
+				// Read the images
+				while ( u64FrameCount < u64NumOfFrames )
+				{
+					if ( bAbort && !bStream )
+					{
+						THROW( "Continuous readout aborted by user!" );
+					}
+
+					if ( bAbort || m_bConStop.load( std::memory_order_acquire ) )
+					{
+						break;
+					}
+
+					tWait.wait( bAbort, &m_bConStop );
+
+					if ( bAbort || m_bConStop.load( std::memory_order_acquire ) )
+					{
+						continue;
+					}
+
+					uiPCIFrameCount = getFrameCount();
+
+					std::uint64_t u64Poll = monotonicTime();
+
+					//
+					// Until the controller resets its frame count after a re-arm,
+					// the count read back is the previous run's final count. Do not
+					// count those frames again.
+					//
+					if ( bRearmed )
+					{
+						if ( uiPCIFrameCount == uiRunFrames )
+						{
+							u64LastPoll = u64Poll;
+
+							continue;
+						}
+
+						bRearmed = false;
+					}
+
+					u64RunFrames  = extendFrameCount( u64RunFrames, uiPCIFrameCount );
+					u64FrameCount = u64RunBase + u64RunFrames;
+
+					tWait.polled( u64Poll, u64LastPoll, static_cast<std::uint32_t>( std::min<std::uint64_t>( u64FrameCount - std::min( u64FrameCount, u64LastFrameCount ), UINT32_MAX ) ) );
+
+					pRing->publish( u64FrameCount );
+
+					if ( u64FrameCount > u64LastFrameCount )
+					{
+						arc::gen3::device::FrameStamp_t tStamp;
+
+						stampFrame( tStamp, u64Poll, u64LastPoll );
+
+						gLatencySum += static_cast<double>( tStamp.u64Latency ) / 1.0e9;
+
+						u64Detections++;
+
+						m_tConStats.gMaxLatency = std::max( m_tConStats.gMaxLatency, static_cast<double>( tStamp.u64LatencyMax ) / 1.0e9 );
+
+						std::uint64_t u64FirstFrame = u64LastFrameCount + 1;
+
+						//
+						// Frames older than the oldest still in the buffer are lost;
+						// the newest frame is always delivered.
+						//
+						std::uint64_t u64OldestFrame = oldestBufferedFrame( u64FrameCount, uiFramesPerBuffer );
+
+						m_tConStats.u64Frames = u64FrameCount;
+						m_tConStats.uiMaxJump = std::max( m_tConStats.uiMaxJump, static_cast<std::uint32_t>( std::min<std::uint64_t>( u64FrameCount - u64LastFrameCount, UINT32_MAX ) ) );
+
+						if ( u64OldestFrame > u64FirstFrame )
+						{
+							m_tConStats.u64Lost += ( u64OldestFrame - u64FirstFrame );
+							m_tConStats.uiGaps++;
+
+							if ( pConIFace != nullptr )
+							{
+								pConIFace->gapCallback( static_cast<std::uint32_t>( u64FirstFrame ), static_cast<std::uint32_t>( u64OldestFrame - u64FirstFrame ) );
+							}
+
+							u64FirstFrame = u64OldestFrame;
+						}
+
+						for ( std::uint64_t u64Frame = u64FirstFrame; u64Frame <= u64FrameCount && u64Frame <= u64NumOfFrames; u64Frame++ )
+						{
+							uiFPBCount = frameSlot( u64Frame, uiFramesPerBuffer );
+
+							std::uint8_t* pFrame = ( commonBufferVA() + static_cast<std::uint64_t>( uiFPBCount ) * static_cast< std::uint64_t >( uiBoundedImageSize ) );
+
+							if ( pCoadd != nullptr )
+							{
+								ARC_TRACE_SPAN( "continuous.coadd", "device" );
+
+								coaddFrame( pCoadd.get(),
+											reinterpret_cast<std::uint16_t*>( pFrame ),
+											static_cast<std::uint64_t>( uiRows ) * static_cast<std::uint64_t>( uiCols ),
+											( uiCoaddPending == 0 ) );
+
+								uiCoaddPending++;
+								u64CoaddFrame = u64Frame;
+								tCoaddStamp   = tStamp;
+
+								//
+								// Emit on every N frames, and emit the partial co-add at the end
+								//
+								if ( uiCoaddPending == uiCoaddFrames || u64Frame >= u64NumOfFrames )
+								{
+									uiCoaddCount++;
+
+									if ( pConIFace != nullptr )
+									{
+										ARC_TRACE_SPAN( "timedCoaddCallback", "callback" );
+
+										pConIFace->timedCoaddCallback( uiCoaddCount,
+																	   static_cast<std::uint32_t>( u64Frame ),
+																	   uiCoaddPending,
+																	   uiRows,
+																	   uiCols,
+																	   pCoadd.get(),
+																	   tStamp );
+									}
+
+									uiCoaddPending = 0;
+								}
+							}
+
+							// Hand the frame to the worker pool
+							else if ( pQueue != nullptr )
+							{
+								arc::gen3::device::FrameDesc_t tDesc;
+
+								tDesc.uiFPBCount      = uiFPBCount;
+								tDesc.uiPCIFrameCount = static_cast<std::uint32_t>( u64Frame );
+								tDesc.uiRows          = uiRows;
+								tDesc.uiCols          = uiCols;
+								tDesc.pBuffer         = pFrame;
+								tDesc.tStamp          = tStamp;
+								tDesc.tLease          = arc::gen3::CArcFrameLease( pRing, u64Frame, uiFPBCount, uiRows, uiCols, pFrame );
+
+								pQueue->push( tDesc, bAbort );
+							}
+
+							// Call external deinterlace and fits file functions here
+							else if ( pConIFace != nullptr )
+							{
+								ARC_TRACE_SPAN( "frameCallback", "callback" );
+
+								arc::gen3::CArcFrameLease tLease( pRing, u64Frame, uiFPBCount, uiRows, uiCols, pFrame );
+
+								pConIFace->leaseFrameCallback( tLease, tStamp );
+							}
+
+							m_tConStats.u64Delivered++;
+
+							if ( u64Frame < u64FrameCount )
+							{
+								m_tConStats.u64Recovered++;
+							}
+						}
+
+						u64LastFrameCount = u64FrameCount;
+
+						m_tConStats.u64Polls         = tWait.polls();
+						m_tConStats.gPredictedPeriod = tWait.predictedPeriod();
+						m_tConStats.gMeanLatency     = gLatencySum / static_cast<double>( u64Detections );
+						m_tConStats.gPollCpu         = tWait.cpuUsage();
+
+						tWait.resume();
+					}
+
+					u64LastPoll = u64Poll;
+
+					//
+					// The controller stops after each run of SNF frames. A stream
+					// re-arms it; the run length is a multiple of the frames per
+					// buffer, so the next run continues in the next buffer slot.
+					//
+					if ( bStream && u64RunFrames >= uiRunFrames )
+					{
+						tPhase.begin( "continuous.rearm", "device" );
+
+						uiRetVal = command( { TIM_ID, SEX } );
+
+						if ( uiRetVal != DON )
+						{
+							THROW( "Start exposure command failed on run %u. Reply: 0x%X", m_tConStats.uiRuns + 1, uiRetVal );
+						}
+
+						u64RunBase  += u64RunFrames;
+						u64RunFrames = 0;
+						bRearmed     = true;
+
+						m_tConStats.uiRuns++;
+
+						tPhase.begin( "continuous.acquire", "device" );
+					}
+				}
+
+				m_tConStats.u64Polls = tWait.polls();
+
+				//
+				// Emit the partial co-add of a stopped run
+				//
+				if ( pCoadd != nullptr && uiCoaddPending > 0 )
+				{
+					uiCoaddCount++;
+
+					if ( pConIFace != nullptr )
+					{
+						ARC_TRACE_SPAN( "timedCoaddCallback", "callback" );
+
+						pConIFace->timedCoaddCallback( uiCoaddCount, static_cast<std::uint32_t>( u64CoaddFrame ), uiCoaddPending, uiRows, uiCols, pCoadd.get(), tCoaddStamp );
+					}
+
+					uiCoaddPending = 0;
+				}
+
+				//
+				// Stop the controller if the run ended early
+				//
+				if ( u64FrameCount < u64NumOfFrames )
+				{
+					tPhase.begin( "continuous.stop", "device" );
+
+					stopExposure();
+				}
+
+				// Set back to single image mode
+				uiRetVal = command( { TIM_ID, SNF, 1 } );
+
+				if ( uiRetVal != DON )
+				{
+					THROW( "Failed to set number of frames (SNF) to 1. Reply: 0x%X", uiRetVal );
+				}
+
+				// Wait for the workers to finish the queued frames
+				if ( pQueue != nullptr )
+				{
+					tPhase.begin( "continuous.drain", "device" );
+
+					pQueue->stop( true );
+				}
+
+				m_bConActive.store( false, std::memory_order_release );
+			}
+			catch ( ... )
+			{
+				m_bConActive.store( false, std::memory_order_release );
+
+				if ( pQueue != nullptr )
+				{
+					pQueue->stop( false );
+				}
+
+				// Set back to single image mode
+				stopContinuous();
+
+				throw std::current_exception;
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  stopContinuous
+		// +----------------------------------------------------------------------------
+		// |  Sends abort expose/readout and sets the controller back into single
+		// |  read mode. If continuous() is running on another thread, it is asked
+		// |  to stop instead; it stops the controller once the frames it has seen
+		// |  are delivered and then returns normally. This is how a stream
+		// |  ( uiNumOfFrames = 0 ) is ended.
+		// |
+		// |  Throws std::runtime_error on error
+		// +----------------------------------------------------------------------------
+		void CArcDevice::stopContinuous( void )
+		{
+			if ( m_bConActive.load( std::memory_order_acquire ) )
+			{
+				m_bConStop.store( true, std::memory_order_release );
+
+				return;
+			}
+
+			stopExposure();
+
+			auto uiRetVal = command( { TIM_ID, SNF, 1 } );
+
+			if ( uiRetVal != DON )
+			{
+				THROW( "Failed to set number of frames ( SNF ) to 1. Reply: 0x%X", uiRetVal );
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  getContinuousStats
+		// +----------------------------------------------------------------------------
+		// |  Returns the frame accounting from the last continuous() run. Frames
+		// |  are recovered when the frame count advanced by more than one between
+		// |  polls but the skipped frames were still in the common buffer; they are
+		// |  lost when the controller had already overwritten them. The detection
+		// |  latency and polling CPU use show the effect of the wait strategy; see
+		// |  setContinuousWaitStrategy().
+		// +----------------------------------------------------------------------------
+		arc::gen3::device::ConStats_t CArcDevice::getContinuousStats( void )
+		{
+			return m_tConStats;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  setContinuousFramesPerBuffer
+		// +----------------------------------------------------------------------------
+		// |  Limits the number of frames continuous() places in the common buffer
+		// |  ring ( FPB ). Set by autoTuneContinuous().
+		// |
+		// |  <IN> -> uiFrames - The maximum frames per buffer ( at least 2 are used ).
+		// |                     0 uses as many frames as fit in the common buffer
+		// |                     ( the default ).
+		// +----------------------------------------------------------------------------
+		void CArcDevice::setContinuousFramesPerBuffer( std::uint32_t uiFrames )
+		{
+			m_uiConFramesPerBuffer = uiFrames;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  getContinuousFramesPerBuffer
+		// +----------------------------------------------------------------------------
+		// |  Returns the frames per buffer limit. 0 means as many as fit.
+		// +----------------------------------------------------------------------------
+		std::uint32_t CArcDevice::getContinuousFramesPerBuffer( void )
+		{
+			return m_uiConFramesPerBuffer;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  setContinuousWaitStrategy
+		// +----------------------------------------------------------------------------
+		// |  Sets how continuous() waits for frames between frame count polls. SPIN
+		// |  ( the default ) polls without pause and uses a full core. HYBRID
+		// |  predicts the next frame from the observed frame period and sleeps until
+		// |  a spin window before it; the window is the CPU budget times the frame
+		// |  period, so a smaller budget saves CPU but risks detecting a frame that
+		// |  arrives early one park interval late. SLEEP never spins. Frames later
+		// |  than predicted are polled at the park interval ( 1/32 of the frame
+		// |  period, at least 100 us ). The achieved detection latency and CPU use
+		// |  are reported by getContinuousStats(). Takes effect on the next call to
+		// |  continuous().
+		// |
+		// |  <IN> -> eStrategy  - The wait strategy.
+		// |  <IN> -> gCpuBudget - Fraction of one core HYBRID may spend spinning
+		// |                       ( 0.0 - 1.0 ). Default: 0.1
+		// +----------------------------------------------------------------------------
+		void CArcDevice::setContinuousWaitStrategy( arc::gen3::device::eWaitStrategy eStrategy, double gCpuBudget )
+		{
+			if ( gCpuBudget < 0.0 || gCpuBudget > 1.0 )
+			{
+				THROW_INVALID_ARGUMENT( "CPU budget must be between 0.0 and 1.0" );
+			}
+
+			m_eConWait      = eStrategy;
+			m_gConCpuBudget = gCpuBudget;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  getContinuousWaitStrategy
+		// +----------------------------------------------------------------------------
+		// |  Returns the continuous() frame wait strategy.
+		// +----------------------------------------------------------------------------
+		arc::gen3::device::eWaitStrategy CArcDevice::getContinuousWaitStrategy( void )
+		{
+			return m_eConWait;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  getContinuousCpuBudget
+		// +----------------------------------------------------------------------------
+		// |  Returns the fraction of one core the HYBRID wait strategy may spend
+		// |  spinning.
+		// +----------------------------------------------------------------------------
+		double CArcDevice::getContinuousCpuBudget( void )
+		{
+			return m_gConCpuBudget;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  autoTuneContinuous
+		// +----------------------------------------------------------------------------
+		// |  Sizes the continuous readout ring from a short warm-up run. The warm-up
+		// |  calls continuous() with the given consumer ( which receives the frames
+		// |  as usual ) and measures the frame period and the time the consumer
+		// |  spends on each frame. The consumer backlog is modelled as a queue with
+		// |  deterministic arrivals; with mean service time m and variance s^2 per
+		// |  frame, the probability that the backlog exceeds t seconds is about
+		// |  exp( -2 ( T - m ) t / s^2 ), where T is the frame period. Frame N is
+		// |  overwritten once the backlog reaches FPB - 1 frames ( see
+		// |  oldestBufferedFrame() ), so the smallest FPB meeting the target is
+		// |  chosen.
+		// |  With worker threads ( setContinuousWorkers() ) the mean and variance
+		// |  are divided by the worker count.
+		// |
+		// |  If the consumer cannot keep up on average no depth is enough; the ring
+		// |  is left at the largest depth that fits and bSustainable is 'false'.
+		// |
+		// |  The chosen depth is applied with setContinuousFramesPerBuffer(). If
+		// |  re-mapping is allowed the common buffer is re-sized to exactly that
+		// |  depth ( growing or shrinking it ); otherwise the depth is limited to
+		// |  what fits and the predicted overrun probability reflects that.
+		// |
+		// |  Throws std::runtime_error on error
+		// |
+		// |  <IN> -> uiRows              - The image row size ( in pixels ).
+		// |  <IN> -> uiCols              - The image column size ( in pixels ).
+		// |  <IN> -> fExpTime            - The exposure time ( in seconds ).
+		// |  <IN> -> pConIFace           - The frame consumer. Must not be NULL.
+		// |  <IN> -> uiWarmupFrames      - The number of warm-up frames ( >= 10 ).
+		// |  <IN> -> gOverrunProbability - The target probability that a frame is
+		// |                                overwritten before it is consumed.
+		// |  <IN> -> bAllowRemap         - 'true' to allow the common buffer to be
+		// |                                re-mapped.
+		// |  <IN> -> bAbort              - 'true' to abort the warm-up.
+		// |  <IN> -> bOpenShutter        - 'true' to open the shutter during the
+		// |                                warm-up.
+		// +----------------------------------------------------------------------------
+		arc::gen3::device::AutoTune_t CArcDevice::autoTuneContinuous( std::uint32_t uiRows, std::uint32_t uiCols, float fExpTime, arc::gen3::CConIFace* pConIFace, std::uint32_t uiWarmupFrames,
+																	  double gOverrunProbability, bool bAllowRemap, const bool& bAbort, bool bOpenShutter )
+		{
+			//
+			// Times the consumer and records the first frame stamp
+			//
+			class CProbe : public arc::gen3::CConIFace
+			{
+				public:
+
+					CProbe( arc::gen3::CConIFace* pConsumer ) : m_pConsumer( pConsumer ), m_uiFirstFrame( 0 )
+					{
+						arc::gen3::CArcBase::zeroMemory( &m_tFirstStamp, sizeof( arc::gen3::device::FrameStamp_t ) );
+					}
+
+					void frameCallback( std::uint32_t, std::uint32_t, std::uint32_t, std::uint32_t, void* ) {}
+
+					void leaseFrameCallback( const arc::gen3::CArcFrameLease& tLease, const arc::gen3::device::FrameStamp_t& tStamp )
+					{
+						auto tStart = std::chrono::steady_clock::now();
+
+						m_pConsumer->leaseFrameCallback( tLease, tStamp );
+
+						double gService = std::chrono::duration<double>( std::chrono::steady_clock::now() - tStart ).count();
+
+						std::lock_guard<std::mutex> tLock( m_tMutex );
+
+						if ( m_uiFirstFrame == 0 || tLease.frame() < m_uiFirstFrame )
+						{
+							m_uiFirstFrame = static_cast<std::uint32_t>( tLease.frame() );
+							m_tFirstStamp  = tStamp;
+						}
+
+						m_vService.push_back( gService );
+					}
+
+					void gapCallback( std::uint32_t uiFirstFrame, std::uint32_t uiLostFrames )
+					{
+						m_pConsumer->gapCallback( uiFirstFrame, uiLostFrames );
+					}
+
+					arc::gen3::CConIFace*				m_pConsumer;
+					std::uint32_t						m_uiFirstFrame;
+					arc::gen3::device::FrameStamp_t		m_tFirstStamp;
+					std::vector<double>					m_vService;
+					std::mutex							m_tMutex;
+			};
+
+			if ( pConIFace == nullptr )
+			{
+				THROW_INVALID_ARGUMENT( "Invalid frame consumer ( nullptr )" );
+			}
+
+			if ( uiWarmupFrames < 10 )
+			{
+				THROW_INVALID_ARGUMENT( "Warm-up must be at least 10 frames, not %u", uiWarmupFrames );
+			}
+
+			if ( !( gOverrunProbability > 0.0 && gOverrunProbability < 1.0 ) )
+			{
+				THROW_INVALID_ARGUMENT( "Overrun probability must be between 0 and 1, not %f", gOverrunProbability );
+			}
+
+			if ( m_uiCoaddFrames > 1 )
+			{
+				THROW( "Disable host co-adding before auto-tuning continuous readout" );
+			}
+
+			arc::gen3::device::AutoTune_t tTune;
+
+			arc::gen3::CArcBase::zeroMemory( &tTune, sizeof( arc::gen3::device::AutoTune_t ) );
+
+			tTune.gTargetOverrun = gOverrunProbability;
+			tTune.uiWorkers      = std::max( 1U, m_uiConWorkers );
+
+			//
+			// Warm up with the deepest ring available
+			//
+			CProbe cProbe( pConIFace );
+
+			std::uint32_t uiSavedFPB = m_uiConFramesPerBuffer;
+
+			m_uiConFramesPerBuffer = 0;
+
+			try
+			{
+				ARC_TRACE_SPAN( "autoTuneContinuous.warmup", "device" );
+
+				continuous( uiRows, uiCols, uiWarmupFrames, fExpTime, bAbort, &cProbe, bOpenShutter );
+			}
+			catch ( ... )
+			{
+				m_uiConFramesPerBuffer = uiSavedFPB;
+
+				throw;
+			}
+
+			m_uiConFramesPerBuffer = uiSavedFPB;
+
+			auto tLastStamp = getLastFrameStamp();
+
+			auto uiLastFrame = static_cast<std::uint32_t>( m_tConStats.u64Frames );
+
+			if ( cProbe.m_vService.size() < 2 || uiLastFrame <= cProbe.m_uiFirstFrame || tLastStamp.u64Monotonic <= cProbe.m_tFirstStamp.u64Monotonic )
+			{
+				THROW( "Too few frames delivered during the warm-up to measure the frame rate" );
+			}
+
+			//
+			// Measure
+			//
+			tTune.uiWarmupFrames = static_cast<std::uint32_t>( cProbe.m_vService.size() );
+
+			tTune.gFramePeriod = static_cast<double>( tLastStamp.u64Monotonic - cProbe.m_tFirstStamp.u64Monotonic ) / 1.0e9 /
+								 static_cast<double>( uiLastFrame - cProbe.m_uiFirstFrame );
+
+			double gSum   = 0.0;
+			double gSumSq = 0.0;
+
+			for ( auto gService : cProbe.m_vService )
+			{
+				gSum   += gService;
+				gSumSq += gService * gService;
+			}
+
+			double gCount = static_cast<double>( cProbe.m_vService.size() );
+
+			tTune.gMeanService = gSum / gCount;
+			tTune.gStdService  = std::sqrt( std::max( 0.0, ( gSumSq - gSum * gSum / gCount ) / ( gCount - 1.0 ) ) );
+
+			double gWorkers  = static_cast<double>( tTune.uiWorkers );
+			double gMean     = tTune.gMeanService / gWorkers;
+			double gVariance = ( tTune.gStdService * tTune.gStdService ) / gWorkers;
+
+			tTune.gUtilization = gMean / tTune.gFramePeriod;
+			tTune.bSustainable = ( tTune.gUtilization < 1.0 );
+
+			//
+			// Size the ring. Decay rate of the backlog tail, per frame.
+			//
+			std::uint32_t uiBoundedImageSize = getContinuousImageSize( uiRows * uiCols * sizeof( std::uint16_t ) );
+
+			std::uint32_t uiFitFPB = static_cast<std::uint32_t>( commonBufferSize() / uiBoundedImageSize );
+
+			double gDecay = ( gVariance > 0.0 ? 2.0 * ( tTune.gFramePeriod - gMean ) * tTune.gFramePeriod / gVariance : HUGE_VAL );
+
+			std::uint32_t uiFPB = uiFitFPB;
+
+			if ( tTune.bSustainable )
+			{
+				double gFrames = std::ceil( -std::log( gOverrunProbability ) / gDecay );
+
+				uiFPB = 1 + static_cast<std::uint32_t>( std::min( gFrames, 65536.0 ) );
+
+				uiFPB = std::max( 2U, uiFPB );
+
+				if ( bAllowRemap && static_cast<std::uint64_t>( uiFPB ) * uiBoundedImageSize != commonBufferSize() )
+				{
+					std::uint64_t u64Bytes = std::min<std::uint64_t>( static_cast<std::uint64_t>( uiFPB ) * uiBoundedImageSize, UINT32_MAX );
+
+					reMapCommonBuffer( static_cast<std::uint32_t>( u64Bytes ) );
+
+					tTune.bRemapped = true;
+
+					uiFitFPB = static_cast<std::uint32_t>( commonBufferSize() / uiBoundedImageSize );
+				}
+
+				uiFPB = std::min( uiFPB, uiFitFPB );
+			}
+
+			tTune.uiFramesPerBuffer = uiFPB;
+			tTune.u64BufferSize     = commonBufferSize();
+
+			tTune.gPredictedOverrun = ( tTune.bSustainable ? std::min( 1.0, std::exp( -gDecay * static_cast<double>( uiFPB > 1 ? uiFPB - 1 : 0 ) ) ) : 1.0 );
+
+			m_uiConFramesPerBuffer = uiFPB;
+
+			m_tAutoTune = tTune;
+
+			return tTune;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  getAutoTuneReport
+		// +----------------------------------------------------------------------------
+		// |  Returns the measurements and ring configuration chosen by the last
+		// |  autoTuneContinuous().
+		// +----------------------------------------------------------------------------
+		arc::gen3::device::AutoTune_t CArcDevice::getAutoTuneReport( void )
+		{
+			return m_tAutoTune;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  setExecPolicy
+		// +----------------------------------------------------------------------------
+		// |  Sets the scheduling of the threads used for readout. The acquisition
+		// |  thread ( the thread calling expose(), continuous(), triggered(),
+		// |  subArrayLoop() or frame_transfer() ) gets the polling CPU mask and
+		// |  SCHED_FIFO priority for the duration of the call; its previous settings
+		// |  are restored on return. Frame queue workers get the worker CPU mask and
+		// |  priority. The NUMA node is the preferred node for host buffers
+		// |  allocated by these threads ( co-add accumulator, frame queue ); the
+		// |  driver's common buffer is not moved. This lets latency-critical polling
+		// |  run on isolated cores away from the processing cores.
+		// |
+		// |  How the continuous() polling loop waits is set by
+		// |  setContinuousWaitStrategy(). With SPIN ( the default ) it never sleeps,
+		// |  so a real-time polling thread sharing a CPU with lower priority threads
+		// |  will starve them; keep the CPU masks disjoint. HYBRID sleeps until just
+		// |  before each predicted frame and SLEEP only sleeps, which leaves the CPU
+		// |  to other threads at the cost of detection latency.
+		// |
+		// |  Memory locking applies to the whole process and takes effect now; a
+		// |  failure clears bMemoryLocked at once and is counted in the report of
+		// |  each following acquisition. Settings that cannot be applied ( usually
+		// |  for lack of privilege, e.g. CAP_SYS_NICE for SCHED_FIFO ) are reported
+		// |  by getExecReport() rather than thrown.
+		// |
+		// |  <IN> -> tPolicy - The execution policy. Zero masks and priorities and a
+		// |                    NUMA node of -1 leave the setting unchanged.
+		// +----------------------------------------------------------------------------
+		void CArcDevice::setExecPolicy( const arc::gen3::device::ExecPolicy_t& tPolicy )
+		{
+			std::lock_guard<std::mutex> tLock( m_tExecMutex );
+
+			if ( tPolicy.bLockMemory != m_tExecPolicy.bLockMemory || ( tPolicy.bLockMemory && !m_tExecReport.bMemoryLocked ) )
+			{
+				m_sLockError.clear();
+
+				bool bOk = arc::gen3::CArcExecScope::lockMemory( tPolicy.bLockMemory, m_sLockError );
+
+				m_tExecReport.bMemoryLocked = ( tPolicy.bLockMemory && bOk );
+			}
+
+			m_tExecPolicy = tPolicy;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  getExecPolicy
+		// +----------------------------------------------------------------------------
+		// |  Returns the current execution policy.
+		// +----------------------------------------------------------------------------
+		arc::gen3::device::ExecPolicy_t CArcDevice::getExecPolicy( void )
+		{
+			std::lock_guard<std::mutex> tLock( m_tExecMutex );
+
+			return m_tExecPolicy;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  getExecReport
+		// +----------------------------------------------------------------------------
+		// |  Returns the execution settings applied by the last acquisition and any
+		// |  that failed. Safe to call from another thread during acquisition.
+		// +----------------------------------------------------------------------------
+		arc::gen3::device::ExecReport_t CArcDevice::getExecReport( void )
+		{
+			std::lock_guard<std::mutex> tLock( m_tExecMutex );
+
+			return m_tExecReport;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  applyExecPolicy
+		// +----------------------------------------------------------------------------
+		// |  Applies the polling part of the execution policy to the calling thread
+		// |  and starts a new execution report, which counts a memory lock failure
+		// |  left by setExecPolicy(). The returned scope restores the
+		// |  thread's previous settings when it goes out of scope. Returns nullptr
+		// |  if the policy leaves the acquisition thread unchanged.
+		// +----------------------------------------------------------------------------
+		std::unique_ptr<arc::gen3::CArcExecScope> CArcDevice::applyExecPolicy( void )
+		{
+			std::lock_guard<std::mutex> tLock( m_tExecMutex );
+
+			bool bMemoryLocked = m_tExecReport.bMemoryLocked;
+
+			m_tExecReport = arc::gen3::device::ExecReport_t();
+
+			m_tExecReport.bMemoryLocked = bMemoryLocked;
+
+			if ( !m_sLockError.empty() )
+			{
+				m_tExecReport.uiFailures++;
+				m_tExecReport.sLastError = m_sLockError;
+			}
+
+			if ( m_tExecPolicy.u64PollCpuMask == 0 && m_tExecPolicy.iPollPriority <= 0 && m_tExecPolicy.iNumaNode < 0 )
+			{
+				return nullptr;
+			}
+
+			std::unique_ptr<arc::gen3::CArcExecScope> pScope( new arc::gen3::CArcExecScope( m_tExecPolicy.u64PollCpuMask, m_tExecPolicy.iPollPriority, m_tExecPolicy.iNumaNode ) );
+
+			m_tExecReport.bPollAffinity = pScope->affinityApplied();
+			m_tExecReport.bPollPriority = pScope->priorityApplied();
+			m_tExecReport.bPollNumaNode = pScope->numaApplied();
+
+			if ( pScope->failures() > 0 )
+			{
+				m_tExecReport.uiFailures += pScope->failures();
+				m_tExecReport.sLastError  = pScope->lastError();
+			}
+
+			return pScope;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  applyWorkerExecPolicy
+		// +----------------------------------------------------------------------------
+		// |  Applies the worker part of the execution policy to the calling frame
+		// |  queue worker thread for the rest of its life, and records the result.
+		// +----------------------------------------------------------------------------
+		void CArcDevice::applyWorkerExecPolicy( void )
+		{
+			arc::gen3::device::ExecPolicy_t tPolicy = getExecPolicy();
+
+			arc::gen3::CArcExecScope tScope( tPolicy.u64WorkerCpuMask, tPolicy.iWorkerPriority, tPolicy.iNumaNode, false );
+
+			std::lock_guard<std::mutex> tLock( m_tExecMutex );
+
+			m_tExecReport.uiWorkers++;
+
+			if ( tScope.failures() == 0 )
+			{
+				m_tExecReport.uiWorkersApplied++;
+			}
+			else
+			{
+				m_tExecReport.uiFailures += tScope.failures();
+				m_tExecReport.sLastError  = tScope.lastError();
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  setContinuousCoadd
+		// +----------------------------------------------------------------------------
+		// |  Enables host co-adding for continuous(). Every N frames read from the
+		// |  common buffer are summed into a 32-bit accumulator, which is delivered
+		// |  through CConIFace::timedCoaddCallback() ( by default forwarded to
+		// |  coaddCallback() ) in place of the N leaseFrameCallback() calls. If the
+		// |  frame count is not a multiple of N, the final co-add holds the remaining
+		// |  frames. Takes effect on the next call to continuous().
+		// |
+		// |  <IN> -> uiFrames - The number of frames per co-add. 0 or 1 disables
+		// |                     co-adding.
+		// +----------------------------------------------------------------------------
+		void CArcDevice::setContinuousCoadd( std::uint32_t uiFrames )
+		{
+			m_uiCoaddFrames = std::max( 1U, uiFrames );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  getContinuousCoadd
+		// +----------------------------------------------------------------------------
+		// |  Returns the number of frames per host co-add. 1 means co-adding is
+		// |  disabled.
+		// +----------------------------------------------------------------------------
+		std::uint32_t CArcDevice::getContinuousCoadd( void )
+		{
+			return m_uiCoaddFrames;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  setContinuousWorkers
+		// +----------------------------------------------------------------------------
+		// |  Decouples continuous() from frame processing. When enabled, the
+		// |  acquisition loop pushes each frame onto a lock-free queue and returns
+		// |  to polling; a pool of worker threads calls the CConIFace frame callback.
+		// |  A slow callback then no longer delays frame count detection. With more
+		// |  than one worker the callback must be thread-safe and frames may
+		// |  complete out of order. Not used while host co-adding is enabled. Takes
+		// |  effect on the next call to continuous().
+		// |
+		// |  <IN> -> uiWorkers    - The number of worker threads. 0 calls the frame
+		// |                         callback from the acquisition loop ( default ).
+		// |  <IN> -> uiQueueDepth - The maximum number of queued frames, including
+		// |                         those a worker is still processing. 0 or any
+		// |                         value larger than the number of frames per
+		// |                         common buffer minus one is limited to that,
+		// |                         since the controller overwrites older frames.
+		// |  <IN> -> ePolicy      - The action when the queue is full: BLOCK waits
+		// |                         for a worker, DROP_OLDEST discards the oldest
+		// |                         queued frame and FAIL stops the readout.
+		// +----------------------------------------------------------------------------
+		void CArcDevice::setContinuousWorkers( std::uint32_t uiWorkers, std::uint32_t uiQueueDepth, arc::gen3::device::eQueuePolicy ePolicy )
+		{
+			m_uiConWorkers    = uiWorkers;
+			m_uiConQueueDepth = uiQueueDepth;
+			m_eConQueuePolicy = ePolicy;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  getContinuousWorkers
+		// +----------------------------------------------------------------------------
+		// |  Returns the number of continuous readout worker threads. 0 means frames
+		// |  are processed on the acquisition thread.
+		// +----------------------------------------------------------------------------
+		std::uint32_t CArcDevice::getContinuousWorkers( void )
+		{
+			return m_uiConWorkers;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  getFrameQueueStats
+		// +----------------------------------------------------------------------------
+		// |  Returns the frame queue telemetry ( depth, high-water mark, drops and
+		// |  latency ) for the current or last continuous() run that used workers.
+		// |  Safe to call from another thread during acquisition.
+		// +----------------------------------------------------------------------------
+		arc::gen3::device::QueueStats_t CArcDevice::getFrameQueueStats( void )
+		{
+			std::lock_guard<std::mutex> tLock( m_tQueueMutex );
+
+			if ( m_pFrameQueue == nullptr )
+			{
+				arc::gen3::device::QueueStats_t tStats;
+
+				arc::gen3::CArcBase::zeroMemory( &tStats, sizeof( arc::gen3::device::QueueStats_t ) );
+
+				return tStats;
+			}
+
+			return m_pFrameQueue->getStats();
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  getFrameLeaseStats
+		// +----------------------------------------------------------------------------
+		// |  Returns the frame lease telemetry ( leases issued, still held and found
+		// |  overwritten ) for the current or last continuous() or triggered() run.
+		// |  Safe to call from another thread during acquisition.
+		// +----------------------------------------------------------------------------
+		arc::gen3::device::LeaseStats_t CArcDevice::getFrameLeaseStats( void )
+		{
+			std::lock_guard<std::mutex> tLock( m_tRingMutex );
+
+			if ( m_pFrameRing == nullptr )
+			{
+				arc::gen3::device::LeaseStats_t tStats;
+
+				arc::gen3::CArcBase::zeroMemory( &tStats, sizeof( arc::gen3::device::LeaseStats_t ) );
+
+				return tStats;
+			}
+
+			return m_pFrameRing->getStats();
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  beginFrameLeases
+		// +----------------------------------------------------------------------------
+		// |  Invalidates all outstanding frame leases and starts a new common buffer
+		// |  ring for a continuous or triggered acquisition. Returns the ring to
+		// |  lease frames on.
+		// |
+		// |  <IN> -> uiFramesPerBuffer - The number of frames the common buffer holds.
+		// +----------------------------------------------------------------------------
+		std::shared_ptr<arc::gen3::CArcFrameRing> CArcDevice::beginFrameLeases( std::uint32_t uiFramesPerBuffer )
+		{
+			auto pRing = std::make_shared<arc::gen3::CArcFrameRing>( std::max( 1U, uiFramesPerBuffer ) );
+
+			std::lock_guard<std::mutex> tLock( m_tRingMutex );
+
+			if ( m_pFrameRing != nullptr )
+			{
+				m_pFrameRing->retire();
+			}
+
+			m_pFrameRing = pRing;
+
+			return pRing;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  retireFrameLeases
+		// +----------------------------------------------------------------------------
+		// |  Invalidates all outstanding frame leases. Called before any readout
+		// |  that writes the common buffer. The lease telemetry of the last
+		// |  continuous() run remains available.
+		// +----------------------------------------------------------------------------
+		void CArcDevice::retireFrameLeases( void )
+		{
+			std::lock_guard<std::mutex> tLock( m_tRingMutex );
+
+			if ( m_pFrameRing != nullptr )
+			{
+				m_pFrameRing->retire();
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  getLastFrameStamp
+		// +----------------------------------------------------------------------------
+		// |  Returns the timestamp of the most recent frame detected by continuous()
+		// |  or triggered(). Safe to call from another thread during acquisition.
+		// +----------------------------------------------------------------------------
+		arc::gen3::device::FrameStamp_t CArcDevice::getLastFrameStamp( void )
+		{
+			std::lock_guard<std::mutex> tLock( m_tStampMutex );
+
+			return m_tLastStamp;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  formatFrameStamp
+		// +----------------------------------------------------------------------------
+		// |  Returns the realtime part of a frame timestamp as a UTC ISO 8601 string
+		// |  with microsecond precision, e.g. 2024-03-01T04:05:06.123456. This is the
+		// |  FITS DATE-OBS format.
+		// |
+		// |  <IN> -> tStamp - The frame timestamp.
+		// +----------------------------------------------------------------------------
+		const std::string CArcDevice::formatFrameStamp( const arc::gen3::device::FrameStamp_t& tStamp )
+		{
+			std::int64_t i64Seconds = tStamp.i64Realtime / 1000000000LL;
+			std::int64_t i64Micros  = ( tStamp.i64Realtime % 1000000000LL ) / 1000LL;
+
+			if ( i64Micros < 0 )
+			{
+				i64Seconds -= 1;
+				i64Micros  += 1000000LL;
+			}
+
+			std::time_t tSeconds = static_cast<std::time_t>( i64Seconds );
+			std::tm     tUTC;
+
+			#ifdef _WINDOWS
+				gmtime_s( &tUTC, &tSeconds );
+			#else
+				gmtime_r( &tSeconds, &tUTC );
+			#endif
+
+			std::ostringstream oss;
+
+			oss << std::setfill( '0' )
+				<< std::setw( 4 ) << ( tUTC.tm_year + 1900 ) << "-"
+				<< std::setw( 2 ) << ( tUTC.tm_mon + 1 ) << "-"
+				<< std::setw( 2 ) << tUTC.tm_mday << "T"
+				<< std::setw( 2 ) << tUTC.tm_hour << ":"
+				<< std::setw( 2 ) << tUTC.tm_min << ":"
+				<< std::setw( 2 ) << tUTC.tm_sec << "."
+				<< std::setw( 6 ) << i64Micros;
+
+			return oss.str();
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  stampFrame
+		// +----------------------------------------------------------------------------
+		// |  Fills in a frame timestamp and saves it as the last frame stamp. The frame
+		// |  count changed at some point between the previous poll and this one, so
+		// |  the poll interval bounds the detection latency; the estimate is half of
+		// |  it. The realtime clock is read immediately after the monotonic poll time.
+		// |
+		// |  <OUT> -> tStamp          - The frame timestamp.
+		// |  <IN>  -> u64PollTime     - Monotonic time of the poll that saw the frame.
+		// |  <IN>  -> u64LastPollTime - Monotonic time of the previous poll.
+		// +----------------------------------------------------------------------------
+		void CArcDevice::stampFrame( arc::gen3::device::FrameStamp_t& tStamp, std::uint64_t u64PollTime, std::uint64_t u64LastPollTime )
+		{
+			#ifdef _WINDOWS
+				tStamp.i64Realtime = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::system_clock::now().time_since_epoch() ).count();
+			#else
+				struct timespec tRealtime;
+
+				clock_gettime( CLOCK_REALTIME, &tRealtime );
+
+				tStamp.i64Realtime = static_cast<std::int64_t>( tRealtime.tv_sec ) * 1000000000LL + tRealtime.tv_nsec;
+			#endif
+
+			tStamp.u64Monotonic  = u64PollTime;
+			tStamp.u64LatencyMax = ( u64PollTime > u64LastPollTime ? u64PollTime - u64LastPollTime : 0 );
+			tStamp.u64Latency    = tStamp.u64LatencyMax / 2;
+
+			std::lock_guard<std::mutex> tLock( m_tStampMutex );
+
+			m_tLastStamp = tStamp;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  getContinuousRunLimit
+		// +----------------------------------------------------------------------------
+		// |  Returns the most frames the controller takes for one start exposure in
+		// |  continuous mode. The number of frames ( SNF ) is sent as a 24-bit DSP
+		// |  word.
+		// +----------------------------------------------------------------------------
+		std::uint32_t CArcDevice::getContinuousRunLimit( void )
+		{
+			return 0xFFFFFF;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  extendFrameCount
+		// +----------------------------------------------------------------------------
+		// |  Extends a 32-bit device frame count to 64 bits. The count may wrap around,
+		// |  but must advance by less than 2^32 frames between calls.
+		// |
+		// |  <IN> -> u64Count     - The previous extended frame count.
+		// |  <IN> -> uiFrameCount - The device frame count.
+		// +----------------------------------------------------------------------------
+		std::uint64_t CArcDevice::extendFrameCount( std::uint64_t u64Count, std::uint32_t uiFrameCount )
+		{
+			return ( u64Count + static_cast<std::uint32_t>( uiFrameCount - static_cast<std::uint32_t>( u64Count ) ) );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  frameSlot
+		// +----------------------------------------------------------------------------
+		// |  Returns the common buffer slot that holds a frame. The controller writes
+		// |  frame N ( 1-based ) to slot ( N - 1 ) % FPB.
+		// |
+		// |  <IN> -> u64Frame          - The frame number ( 1-based ).
+		// |  <IN> -> uiFramesPerBuffer - The number of frames per common buffer.
+		// +----------------------------------------------------------------------------
+		std::uint32_t CArcDevice::frameSlot( std::uint64_t u64Frame, std::uint32_t uiFramesPerBuffer )
+		{
+			return static_cast<std::uint32_t>( ( u64Frame - 1 ) % uiFramesPerBuffer );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  oldestBufferedFrame
+		// +----------------------------------------------------------------------------
+		// |  Returns the oldest frame still intact in the common buffer. Frame N is
+		// |  held in its slot until the controller starts writing frame N + FPB, as
+		// |  soon as frame N + FPB - 1 completes. Frames older than the one returned
+		// |  have been overwritten; the newest frame is always intact. A frame lease
+		// |  stays valid on the same rule ( see CArcFrameLease::isValid() ).
+		// |
+		// |  <IN> -> u64FrameCount     - The number of frames completed.
+		// |  <IN> -> uiFramesPerBuffer - The number of frames per common buffer.
+		// +----------------------------------------------------------------------------
+		std::uint64_t CArcDevice::oldestBufferedFrame( std::uint64_t u64FrameCount, std::uint32_t uiFramesPerBuffer )
+		{
+			std::uint64_t u64Oldest = ( ( u64FrameCount + 2 ) > uiFramesPerBuffer ? ( u64FrameCount + 2 - uiFramesPerBuffer ) : 1 );
+
+			return std::min( u64Oldest, u64FrameCount );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  monotonicTime
+		// +----------------------------------------------------------------------------
+		// |  Returns the CLOCK_MONOTONIC time in nanoseconds.
+		// +----------------------------------------------------------------------------
+		std::uint64_t CArcDevice::monotonicTime( void )
+		{
+			#ifdef _WINDOWS
+				return static_cast<std::uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count() );
+			#else
+				struct timespec tMonotonic;
+
+				clock_gettime( CLOCK_MONOTONIC, &tMonotonic );
+
+				return static_cast<std::uint64_t>( tMonotonic.tv_sec ) * 1000000000ULL + static_cast<std::uint64_t>( tMonotonic.tv_nsec );
+			#endif
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  predictReadoutTime
+		// +----------------------------------------------------------------------------
+		// |  Returns the predicted image readout time ( in seconds ) for the current
+		// |  controller configuration. The model is learned from the readouts observed
+		// |  by expose() or loaded using loadReadoutModel(). Observed times include
+		// |  the expose() polling latency, so predictions match what callers of
+		// |  expose() actually wait for.
+		// |
+		// |  Throws std::runtime_error if no readout has been observed for the current
+		// |  controller configuration.
+		// |
+		// |  <IN> -> uiRows      - The unbinned image ( or subarray ) row size.
+		// |  <IN> -> uiCols      - The unbinned image ( or subarray ) column size.
+		// |  <IN> -> uiRowFactor - The row binning factor. Default: 1
+		// |  <IN> -> uiColFactor - The column binning factor. Default: 1
+		// +----------------------------------------------------------------------------
+		double CArcDevice::predictReadoutTime( std::uint32_t uiRows, std::uint32_t uiCols, std::uint32_t uiRowFactor, std::uint32_t uiColFactor )
+		{
+			if ( uiRowFactor == 0 || uiColFactor == 0 )
+			{
+				THROW_INVALID_ARGUMENT( "Invalid binning factor [ %u x %u ]. Must be > 0.", uiColFactor, uiRowFactor );
+			}
+
+			auto u64Pixels = static_cast<std::uint64_t>( uiRows / uiRowFactor ) * static_cast<std::uint64_t>( uiCols / uiColFactor );
+
+			return m_pReadoutModel->predict( m_uiCCParam, uiRowFactor, uiColFactor, u64Pixels );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  getReadoutModel
+		// +----------------------------------------------------------------------------
+		// |  Returns the learned readout model ( overhead and pixel rate ) for the
+		// |  current controller configuration and the specified binning factors.
+		// |
+		// |  Throws std::runtime_error if no readout has been observed for the
+		// |  configuration.
+		// |
+		// |  <IN> -> uiRowFactor - The row binning factor. Default: 1
+		// |  <IN> -> uiColFactor - The column binning factor. Default: 1
+		// +----------------------------------------------------------------------------
+		arc::gen3::device::ReadoutModel_t CArcDevice::getReadoutModel( std::uint32_t uiRowFactor, std::uint32_t uiColFactor )
+		{
+			return m_pReadoutModel->getModel( m_uiCCParam, uiRowFactor, uiColFactor );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  clearReadoutModel
+		// +----------------------------------------------------------------------------
+		// |  Discards all learned readout models.
+		// +----------------------------------------------------------------------------
+		void CArcDevice::clearReadoutModel( void )
+		{
+			m_pReadoutModel->clear();
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  loadReadoutModel
+		// +----------------------------------------------------------------------------
+		// |  Loads readout models previously written by saveReadoutModel(). Models
+		// |  are stored per controller configuration, so one file can hold models
+		// |  for several configurations.
+		// |
+		// |  Throws std::runtime_error on error
+		// |
+		// |  <IN> -> sFilename - The readout model file to load.
+		// +----------------------------------------------------------------------------
+		void CArcDevice::loadReadoutModel( const std::string& sFilename )
+		{
+			m_pReadoutModel->load( sFilename );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  saveReadoutModel
+		// +----------------------------------------------------------------------------
+		// |  Writes all learned readout models to the specified file.
+		// |
+		// |  Throws std::runtime_error on error
+		// |
+		// |  <IN> -> sFilename - The readout model file to write.
+		// +----------------------------------------------------------------------------
+		void CArcDevice::saveReadoutModel( const std::string& sFilename )
+		{
+			m_pReadoutModel->save( sFilename );
 		}
 
 
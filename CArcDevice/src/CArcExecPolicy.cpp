@@ -0,0 +1,412 @@
+//
+// CArcExecPolicy.cpp : Defines acquisition thread scheduling controls
+//
+#ifdef _WINDOWS
+	#include <windows.h>
+#else
+	#include <pthread.h>
+	#include <sched.h>
+	#include <sys/mman.h>
+	#include <unistd.h>
+	#include <errno.h>
+	#include <cstring>
+
+	#ifdef __linux__
+		#include <sys/syscall.h>
+	#endif
+#endif
+
+#include <CArcBase.h>
+#include <CArcExecPolicy.h>
+
+
+
+namespace arc
+{
+	namespace gen3
+	{
+
+		// +----------------------------------------------------------------------------
+		// |  Linux memory policy modes ( see set_mempolicy(2) )
+		// +----------------------------------------------------------------------------
+		#define ARC_MPOL_DEFAULT		0
+		#define ARC_MPOL_PREFERRED		1
+		#define ARC_MPOL_LOCAL			4
+
+		// +----------------------------------------------------------------------------
+		// |  Mode flags returned with the memory policy mode
+		// +----------------------------------------------------------------------------
+		#define ARC_MPOL_MODE_FLAGS		( ( 1 << 15 ) | ( 1 << 14 ) | ( 1 << 13 ) )
+
+		// +----------------------------------------------------------------------------
+		// |  Number of NUMA nodes the saved node mask can hold. get_mempolicy(2)
+		// |  fails if this is less than the number of nodes the kernel supports.
+		// +----------------------------------------------------------------------------
+		#define ARC_NUMA_MAX_NODES		1024
+
+
+		// +----------------------------------------------------------------------------------------------------+
+		// |  Constructor                                                                                       |
+		// +----------------------------------------------------------------------------------------------------+
+		// |  <IN> -> u64CpuMask - CPUs the thread may run on ( bit N = CPU N ). 0 leaves it unchanged.         |
+		// |  <IN> -> iPriority  - SCHED_FIFO priority ( 1 - 99 ). 0 leaves it unchanged.                       |
+		// |  <IN> -> iNumaNode  - Preferred NUMA node for memory the thread allocates. -1 leaves it unchanged. |
+		// |  <IN> -> bRestore   - 'true' to restore the previous settings when destroyed.                      |
+		// +----------------------------------------------------------------------------------------------------+
+		CArcExecScope::CArcExecScope( std::uint64_t u64CpuMask, std::int32_t iPriority, std::int32_t iNumaNode, bool bRestore )
+			: m_bRestore( bRestore ), m_bAffinity( false ), m_bPriority( false ), m_bNuma( false ), m_u64OldMask( 0 ), m_iOldPolicy( 0 ),
+			  m_iOldPriority( 0 ), m_iOldNumaMode( 0 ), m_uiFailures( 0 )
+		{
+			//
+			// CPU affinity
+			//
+			if ( u64CpuMask != 0 )
+			{
+			#if defined( _WINDOWS )
+
+				auto ulOldMask = SetThreadAffinityMask( GetCurrentThread(), static_cast<DWORD_PTR>( u64CpuMask ) );
+
+				if ( ulOldMask != 0 )
+				{
+					m_u64OldMask = static_cast<std::uint64_t>( ulOldMask );
+					m_bAffinity  = true;
+				}
+				else
+				{
+					fail( arc::gen3::CArcBase::formatString( "CPU affinity 0x%X failed, error: %e", static_cast<unsigned int>( u64CpuMask ), arc::gen3::CArcBase::getSystemError() ) );
+				}
+
+			#elif defined( __linux__ )
+
+				cpu_set_t tOldSet;
+
+				CPU_ZERO( &tOldSet );
+
+				pthread_getaffinity_np( pthread_self(), sizeof( cpu_set_t ), &tOldSet );
+
+				for ( int i = 0; i < 64; i++ )
+				{
+					if ( CPU_ISSET( i, &tOldSet ) )
+					{
+						m_u64OldMask |= ( 1ULL << i );
+					}
+				}
+
+				cpu_set_t tSet;
+
+				CPU_ZERO( &tSet );
+
+				for ( int i = 0; i < 64; i++ )
+				{
+					if ( u64CpuMask & ( 1ULL << i ) )
+					{
+						CPU_SET( i, &tSet );
+					}
+				}
+
+				int iError = pthread_setaffinity_np( pthread_self(), sizeof( cpu_set_t ), &tSet );
+
+				if ( iError == 0 )
+				{
+					m_bAffinity = true;
+				}
+				else
+				{
+					fail( std::string( "CPU affinity failed: " ) + std::strerror( iError ) );
+				}
+
+			#else
+
+				fail( "CPU affinity is not supported on this platform" );
+
+			#endif
+			}
+
+			//
+			// Real-time priority
+			//
+			if ( iPriority > 0 )
+			{
+			#ifdef _WINDOWS
+
+				m_iOldPriority = GetThreadPriority( GetCurrentThread() );
+
+				if ( SetThreadPriority( GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL ) )
+				{
+					m_bPriority = true;
+				}
+				else
+				{
+					fail( arc::gen3::CArcBase::formatString( "Thread priority failed, error: %e", arc::gen3::CArcBase::getSystemError() ) );
+				}
+
+			#else
+
+				sched_param tParam;
+
+				pthread_getschedparam( pthread_self(), &m_iOldPolicy, &tParam );
+
+				m_iOldPriority = tParam.sched_priority;
+
+				tParam.sched_priority = iPriority;
+
+				int iError = pthread_setschedparam( pthread_self(), SCHED_FIFO, &tParam );
+
+				if ( iError == 0 )
+				{
+					m_bPriority = true;
+				}
+				else
+				{
+					fail( std::string( "SCHED_FIFO priority " ) + std::to_string( iPriority ) + " failed: " + std::strerror( iError ) );
+				}
+
+			#endif
+			}
+
+			//
+			// NUMA memory preference
+			//
+			if ( iNumaNode >= 0 )
+			{
+			#if defined( __linux__ ) && defined( SYS_set_mempolicy ) && defined( SYS_get_mempolicy )
+
+				const std::size_t uiMaskBits = ( sizeof( unsigned long ) * 8 );
+
+				if ( iNumaNode < 64 )
+				{
+					//
+					// Save the thread's current policy so that it can be restored
+					//
+					bool bSaved = true;
+
+					if ( bRestore )
+					{
+						m_vOldNumaNodes.assign( ARC_NUMA_MAX_NODES / uiMaskBits, 0 );
+
+						if ( syscall( SYS_get_mempolicy, &m_iOldNumaMode, m_vOldNumaNodes.data(), ARC_NUMA_MAX_NODES, nullptr, 0 ) != 0 )
+						{
+							fail( std::string( "NUMA policy could not be saved: " ) + std::strerror( errno ) );
+
+							bSaved = false;
+						}
+					}
+
+					unsigned long ulNodeMask = ( 1UL << iNumaNode );
+
+					if ( bSaved )
+					{
+						if ( syscall( SYS_set_mempolicy, ARC_MPOL_PREFERRED, &ulNodeMask, uiMaskBits ) == 0 )
+						{
+							m_bNuma = true;
+						}
+						else
+						{
+							fail( std::string( "NUMA node " ) + std::to_string( iNumaNode ) + " preference failed: " + std::strerror( errno ) );
+						}
+					}
+				}
+				else
+				{
+					fail( std::string( "NUMA node " ) + std::to_string( iNumaNode ) + " is out of range" );
+				}
+
+			#else
+
+				fail( "NUMA memory preference is not supported on this platform" );
+
+			#endif
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------+
+		// |  Destructor                                                                                        |
+		// +----------------------------------------------------------------------------------------------------+
+		// |  Restores the settings that were changed, if requested.                                            |
+		// +----------------------------------------------------------------------------------------------------+
+		CArcExecScope::~CArcExecScope( void )
+		{
+			if ( !m_bRestore )
+			{
+				return;
+			}
+
+		#if defined( _WINDOWS )
+
+			if ( m_bAffinity )
+			{
+				SetThreadAffinityMask( GetCurrentThread(), static_cast<DWORD_PTR>( m_u64OldMask ) );
+			}
+
+			if ( m_bPriority )
+			{
+				SetThreadPriority( GetCurrentThread(), m_iOldPriority );
+			}
+
+		#else
+
+			#ifdef __linux__
+
+				if ( m_bAffinity )
+				{
+					cpu_set_t tSet;
+
+					CPU_ZERO( &tSet );
+
+					for ( int i = 0; i < 64; i++ )
+					{
+						if ( m_u64OldMask & ( 1ULL << i ) )
+						{
+							CPU_SET( i, &tSet );
+						}
+					}
+
+					pthread_setaffinity_np( pthread_self(), sizeof( cpu_set_t ), &tSet );
+				}
+
+				#if defined( SYS_set_mempolicy ) && defined( SYS_get_mempolicy )
+
+					if ( m_bNuma )
+					{
+						//
+						// The default and local policies take an empty node mask
+						//
+						int iMode = ( m_iOldNumaMode & ~ARC_MPOL_MODE_FLAGS );
+
+						if ( iMode == ARC_MPOL_DEFAULT || iMode == ARC_MPOL_LOCAL )
+						{
+							syscall( SYS_set_mempolicy, m_iOldNumaMode, nullptr, 0 );
+						}
+						else
+						{
+							syscall( SYS_set_mempolicy, m_iOldNumaMode, m_vOldNumaNodes.data(), ARC_NUMA_MAX_NODES );
+						}
+					}
+
+				#endif
+
+			#endif
+
+			if ( m_bPriority )
+			{
+				sched_param tParam;
+
+				tParam.sched_priority = m_iOldPriority;
+
+				pthread_setschedparam( pthread_self(), m_iOldPolicy, &tParam );
+			}
+
+		#endif
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  affinityApplied
+		// +----------------------------------------------------------------------------
+		// |  Returns 'true' if the CPU affinity was applied.
+		// +----------------------------------------------------------------------------
+		bool CArcExecScope::affinityApplied( void ) const
+		{
+			return m_bAffinity;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  priorityApplied
+		// +----------------------------------------------------------------------------
+		// |  Returns 'true' if the real-time priority was applied.
+		// +----------------------------------------------------------------------------
+		bool CArcExecScope::priorityApplied( void ) const
+		{
+			return m_bPriority;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  numaApplied
+		// +----------------------------------------------------------------------------
+		// |  Returns 'true' if the NUMA memory preference was applied.
+		// +----------------------------------------------------------------------------
+		bool CArcExecScope::numaApplied( void ) const
+		{
+			return m_bNuma;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  failures
+		// +----------------------------------------------------------------------------
+		// |  Returns the number of settings that could not be applied.
+		// +----------------------------------------------------------------------------
+		std::uint32_t CArcExecScope::failures( void ) const
+		{
+			return m_uiFailures;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  lastError
+		// +----------------------------------------------------------------------------
+		// |  Returns the most recent failure message, or an empty string.
+		// +----------------------------------------------------------------------------
+		const std::string& CArcExecScope::lastError( void ) const
+		{
+			return m_sLastError;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  lockMemory
+		// +----------------------------------------------------------------------------
+		// |  Locks ( or unlocks ) all current and future process memory into RAM, so
+		// |  acquisition threads never take a page fault. Returns 'false' and sets
+		// |  the error message on failure.
+		// |
+		// |  <IN>  -> bOnOff - 'true' to lock; 'false' to unlock.
+		// |  <OUT> -> sError - The failure message.
+		// +----------------------------------------------------------------------------
+		bool CArcExecScope::lockMemory( bool bOnOff, std::string& sError )
+		{
+		#ifdef _WINDOWS
+
+			if ( bOnOff )
+			{
+				sError = "Locking all process memory is not supported on this platform";
+
+				return false;
+			}
+
+			return true;
+
+		#else
+
+			int iStatus = ( bOnOff ? mlockall( MCL_CURRENT | MCL_FUTURE ) : munlockall() );
+
+			if ( iStatus != 0 )
+			{
+				sError = std::string( bOnOff ? "mlockall" : "munlockall" ) + " failed: " + std::strerror( errno );
+
+				return false;
+			}
+
+			return true;
+
+		#endif
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  fail
+		// +----------------------------------------------------------------------------
+		// |  Records a setting that could not be applied.
+		// +----------------------------------------------------------------------------
+		void CArcExecScope::fail( const std::string& sWhat )
+		{
+			m_uiFailures++;
+
+			m_sLastError = sWhat;
+		}
+
+	}	// end gen3 namespace
+}	// end arc namespace
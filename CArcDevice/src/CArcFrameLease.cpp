@@ -0,0 +1,326 @@
+//
+// CArcFrameLease.cpp : Defines zero-copy continuous readout frame leases
+//
+#include <algorithm>
+
+#include <CArcBase.h>
+#include <CArcFrameLease.h>
+
+
+
+namespace arc
+{
+	namespace gen3
+	{
+
+		// +----------------------------------------------------------------------------
+		// |  Lease state shared by all copies of a lease
+		// +----------------------------------------------------------------------------
+		struct CArcFrameLease::Lease_t
+		{
+			std::shared_ptr<CArcFrameRing>	pRing;
+			std::uint64_t					u64Frame;
+			std::uint32_t					uiSlot;
+			std::uint32_t					uiRows;
+			std::uint32_t					uiCols;
+			void*							pData;
+			mutable std::atomic<bool>		bLapped;
+
+			~Lease_t( void )
+			{
+				pRing->m_u64Released.fetch_add( 1, std::memory_order_relaxed );
+			}
+		};
+
+
+		// +----------------------------------------------------------------------------------------------------+
+		// |  CArcFrameRing constructor                                                                         |
+		// +----------------------------------------------------------------------------------------------------+
+		// |  <IN> -> uiFramesPerBuffer - The number of frames the common buffer holds. Must be > 0.            |
+		// +----------------------------------------------------------------------------------------------------+
+		CArcFrameRing::CArcFrameRing( std::uint32_t uiFramesPerBuffer )
+			: m_uiFramesPerBuffer( uiFramesPerBuffer ), m_u64Completed( 0 ), m_bRetired( false ), m_u64Leased( 0 ), m_u64Released( 0 ), m_u64Lapped( 0 )
+		{
+			if ( uiFramesPerBuffer == 0 )
+			{
+				THROW_INVALID_ARGUMENT( "Frames per buffer must be > 0" );
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  publish
+		// +----------------------------------------------------------------------------
+		// |  Records the number of frames the device has completed. Called by the
+		// |  acquisition loop on each poll.
+		// |
+		// |  <IN> -> u64Completed - The device frame count.
+		// +----------------------------------------------------------------------------
+		void CArcFrameRing::publish( std::uint64_t u64Completed )
+		{
+			m_u64Completed.store( u64Completed, std::memory_order_release );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  retire
+		// +----------------------------------------------------------------------------
+		// |  Marks every lease on this ring invalid. Called when a new acquisition
+		// |  starts writing the common buffer from the first slot again.
+		// +----------------------------------------------------------------------------
+		void CArcFrameRing::retire( void )
+		{
+			m_bRetired.store( true, std::memory_order_release );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  isRetired
+		// +----------------------------------------------------------------------------
+		// |  Returns 'true' if a later acquisition has reused the common buffer.
+		// +----------------------------------------------------------------------------
+		bool CArcFrameRing::isRetired( void ) const
+		{
+			return m_bRetired.load( std::memory_order_acquire );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  completed
+		// +----------------------------------------------------------------------------
+		// |  Returns the last published device frame count.
+		// +----------------------------------------------------------------------------
+		std::uint64_t CArcFrameRing::completed( void ) const
+		{
+			return m_u64Completed.load( std::memory_order_acquire );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  framesPerBuffer
+		// +----------------------------------------------------------------------------
+		// |  Returns the number of frames the common buffer holds.
+		// +----------------------------------------------------------------------------
+		std::uint32_t CArcFrameRing::framesPerBuffer( void ) const
+		{
+			return m_uiFramesPerBuffer;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  getStats
+		// +----------------------------------------------------------------------------
+		// |  Returns the lease telemetry for this ring.
+		// +----------------------------------------------------------------------------
+		arc::gen3::device::LeaseStats_t CArcFrameRing::getStats( void ) const
+		{
+			arc::gen3::device::LeaseStats_t tStats;
+
+			tStats.uiFramesPerBuffer = m_uiFramesPerBuffer;
+			tStats.u64Completed      = m_u64Completed.load();
+			tStats.u64Leased         = m_u64Leased.load();
+			tStats.u64Outstanding    = tStats.u64Leased - std::min( tStats.u64Leased, m_u64Released.load() );
+			tStats.u64Lapped         = m_u64Lapped.load();
+
+			return tStats;
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------+
+		// |  CArcFrameLease constructor                                                                        |
+		// +----------------------------------------------------------------------------------------------------+
+		// |  <IN> -> pRing    - The ring the frame was read into.                                              |
+		// |  <IN> -> u64Frame - The frame number ( the device frame count when the frame completed ).          |
+		// |  <IN> -> uiSlot   - The common buffer slot holding the frame.                                      |
+		// |  <IN> -> uiRows   - The image row size ( in pixels ).                                              |
+		// |  <IN> -> uiCols   - The image column size ( in pixels ).                                           |
+		// |  <IN> -> pData    - The frame address within the common buffer.                                    |
+		// +----------------------------------------------------------------------------------------------------+
+		CArcFrameLease::CArcFrameLease( std::shared_ptr<CArcFrameRing> pRing, std::uint64_t u64Frame, std::uint32_t uiSlot, std::uint32_t uiRows, std::uint32_t uiCols, void* pData )
+		{
+			if ( pRing == nullptr )
+			{
+				THROW_INVALID_ARGUMENT( "Invalid frame ring ( nullptr )" );
+			}
+
+			m_pLease = std::make_shared<Lease_t>();
+
+			m_pLease->pRing    = pRing;
+			m_pLease->u64Frame = u64Frame;
+			m_pLease->uiSlot   = uiSlot;
+			m_pLease->uiRows   = uiRows;
+			m_pLease->uiCols   = uiCols;
+			m_pLease->pData    = pData;
+
+			m_pLease->bLapped.store( false );
+
+			pRing->m_u64Leased.fetch_add( 1, std::memory_order_relaxed );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  data
+		// +----------------------------------------------------------------------------
+		// |  Returns the frame address within the common buffer, or nullptr for an
+		// |  empty lease. Check isValid() after using the data.
+		// +----------------------------------------------------------------------------
+		void* CArcFrameLease::data( void ) const
+		{
+			return ( m_pLease != nullptr ? m_pLease->pData : nullptr );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  frame
+		// +----------------------------------------------------------------------------
+		// |  Returns the frame number ( 1 is the first frame of the acquisition ).
+		// +----------------------------------------------------------------------------
+		std::uint64_t CArcFrameLease::frame( void ) const
+		{
+			return ( m_pLease != nullptr ? m_pLease->u64Frame : 0 );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  slot
+		// +----------------------------------------------------------------------------
+		// |  Returns the common buffer slot holding the frame.
+		// +----------------------------------------------------------------------------
+		std::uint32_t CArcFrameLease::slot( void ) const
+		{
+			return ( m_pLease != nullptr ? m_pLease->uiSlot : 0 );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  rows
+		// +----------------------------------------------------------------------------
+		// |  Returns the image row size ( in pixels ).
+		// +----------------------------------------------------------------------------
+		std::uint32_t CArcFrameLease::rows( void ) const
+		{
+			return ( m_pLease != nullptr ? m_pLease->uiRows : 0 );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  cols
+		// +----------------------------------------------------------------------------
+		// |  Returns the image column size ( in pixels ).
+		// +----------------------------------------------------------------------------
+		std::uint32_t CArcFrameLease::cols( void ) const
+		{
+			return ( m_pLease != nullptr ? m_pLease->uiCols : 0 );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  bytes
+		// +----------------------------------------------------------------------------
+		// |  Returns the image size ( in bytes ).
+		// +----------------------------------------------------------------------------
+		std::uint64_t CArcFrameLease::bytes( void ) const
+		{
+			return ( static_cast<std::uint64_t>( rows() ) * static_cast<std::uint64_t>( cols() ) * sizeof( std::uint16_t ) );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  isValid
+		// +----------------------------------------------------------------------------
+		// |  Returns 'true' if the frame has not been overwritten. Frame N shares its
+		// |  slot with frame N + FPB, which the controller starts writing as soon as
+		// |  frame N + FPB - 1 completes. This is the same rule the acquisition loop
+		// |  uses to recover frames ( CArcDevice::oldestBufferedFrame() ), so every
+		// |  frame delivered is valid on arrival. The frame count is only as current
+		// |  as the last poll, so check the lease as soon as the data has been read.
+		// |  A lease is also invalid once a later acquisition reuses the common
+		// |  buffer. The first time a lease is found lapped it is counted in the ring
+		// |  telemetry.
+		// +----------------------------------------------------------------------------
+		bool CArcFrameLease::isValid( void ) const
+		{
+			if ( m_pLease == nullptr )
+			{
+				return false;
+			}
+
+			if ( headroom() > 0 && !m_pLease->pRing->isRetired() )
+			{
+				return true;
+			}
+
+			if ( !m_pLease->bLapped.exchange( true ) )
+			{
+				m_pLease->pRing->m_u64Lapped.fetch_add( 1, std::memory_order_relaxed );
+			}
+
+			return false;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  validate
+		// +----------------------------------------------------------------------------
+		// |  Throws std::runtime_error if the frame has been overwritten. See
+		// |  isValid().
+		// +----------------------------------------------------------------------------
+		void CArcFrameLease::validate( void ) const
+		{
+			if ( m_pLease == nullptr )
+			{
+				THROW( "Frame lease is empty!" );
+			}
+
+			if ( !isValid() && m_pLease->pRing->isRetired() )
+			{
+				THROW( "Frame %J lease expired, a later readout has reused the common buffer!", static_cast<unsigned long long>( m_pLease->u64Frame ) );
+			}
+
+			if ( !isValid() )
+			{
+				THROW( "Frame %J in buffer slot %u was overwritten while leased ( device frame count: %J, frames per buffer: %u )!",
+						static_cast<unsigned long long>( m_pLease->u64Frame ),
+						m_pLease->uiSlot,
+						static_cast<unsigned long long>( m_pLease->pRing->completed() ),
+						m_pLease->pRing->framesPerBuffer() );
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  headroom
+		// +----------------------------------------------------------------------------
+		// |  Returns the number of frames the device can still complete before this
+		// |  frame's slot may be overwritten. 0 means the lease is lapped.
+		// +----------------------------------------------------------------------------
+		std::uint64_t CArcFrameLease::headroom( void ) const
+		{
+			if ( m_pLease == nullptr )
+			{
+				return 0;
+			}
+
+			//
+			// Last safe frame count is N + FPB - 2
+			//
+			std::uint64_t u64Limit = m_pLease->u64Frame + m_pLease->pRing->framesPerBuffer();
+
+			std::uint64_t u64Completed = m_pLease->pRing->completed() + 1;
+
+			return ( u64Limit > u64Completed ? u64Limit - u64Completed : 0 );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  release
+		// +----------------------------------------------------------------------------
+		// |  Releases this copy of the lease. The lease becomes empty.
+		// +----------------------------------------------------------------------------
+		void CArcFrameLease::release( void )
+		{
+			m_pLease.reset();
+		}
+
+	}	// end gen3 namespace
+}	// end arc namespace
@@ -0,0 +1,521 @@
+//
+// CArcFrameQueue.cpp : Defines a lock-free continuous readout queue
+//
+#include <algorithm>
+#include <chrono>
+
+#include <CArcBase.h>
+#include <CArcFrameQueue.h>
+
+
+
+namespace arc
+{
+	namespace gen3
+	{
+
+		// +----------------------------------------------------------------------------
+		// |  Number of empty polls a worker yields before it starts sleeping
+		// +----------------------------------------------------------------------------
+		#define QUEUE_IDLE_YIELDS		256
+
+		// +----------------------------------------------------------------------------
+		// |  Worker sleep time once idle ( microseconds )
+		// +----------------------------------------------------------------------------
+		#define QUEUE_IDLE_SLEEP		50
+
+
+		// +----------------------------------------------------------------------------------------------------+
+		// |  Constructor                                                                                       |
+		// +----------------------------------------------------------------------------------------------------+
+		// |  <IN> -> uiCapacity - The number of queue slots. Must be > 0.                                      |
+		// |  <IN> -> ePolicy    - The action taken when a frame is pushed onto a full queue.                   |
+		// +----------------------------------------------------------------------------------------------------+
+		CArcFrameQueue::CArcFrameQueue( std::uint32_t uiCapacity, arc::gen3::device::eQueuePolicy ePolicy )
+			: m_u64Capacity( uiCapacity ), m_ePolicy( ePolicy ), m_u64Head( 0 ), m_u64Tail( 0 ), m_u64Done( 0 ), m_bStop( false ), m_bDiscard( false ),
+			  m_bFailed( false ), m_u64Queued( 0 ), m_u64Dropped( 0 ), m_uiHighWater( 0 ), m_uiWorkers( 0 ), m_u64Processed( 0 ), m_gWaitSum( 0.0 ),
+			  m_gLatencySum( 0.0 ), m_gLatencyMax( 0.0 )
+		{
+			if ( uiCapacity == 0 )
+			{
+				THROW_INVALID_ARGUMENT( "Frame queue capacity must be > 0" );
+			}
+
+			m_pCells.reset( new Cell_t[ uiCapacity ] );
+
+			for ( std::uint64_t i = 0; i < m_u64Capacity; i++ )
+			{
+				m_pCells[ i ].u64Seq.store( i, std::memory_order_relaxed );
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------+
+		// |  Destructor                                                                                        |
+		// +----------------------------------------------------------------------------------------------------+
+		CArcFrameQueue::~CArcFrameQueue( void )
+		{
+			try
+			{
+				stop( false );
+			}
+			catch ( ... ) {}
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  start
+		// +----------------------------------------------------------------------------
+		// |  Starts the worker threads. With more than one worker the handler runs
+		// |  concurrently and frames may complete out of order.
+		// |
+		// |  Throws std::invalid_argument on error
+		// |
+		// |  <IN> -> uiWorkers    - The number of worker threads. Must be > 0.
+		// |  <IN> -> fnHandler    - The function called by a worker for each frame.
+		// |  <IN> -> fnThreadInit - Optional function each worker calls once when it
+		// |                         starts ( e.g. to set its scheduling ).
+		// +----------------------------------------------------------------------------
+		void CArcFrameQueue::start( std::uint32_t uiWorkers, Handler_t fnHandler, std::function<void( void )> fnThreadInit )
+		{
+			if ( uiWorkers == 0 )
+			{
+				THROW_INVALID_ARGUMENT( "Frame queue worker count must be > 0" );
+			}
+
+			if ( !m_vWorkers.empty() )
+			{
+				THROW( "Frame queue workers already running" );
+			}
+
+			m_fnHandler = fnHandler;
+
+			m_uiWorkers = uiWorkers;
+
+			m_bStop.store( false );
+			m_bDiscard.store( false );
+
+			for ( std::uint32_t i = 0; i < uiWorkers; i++ )
+			{
+				m_vWorkers.emplace_back( &CArcFrameQueue::worker, this, fnThreadInit );
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  push
+		// +----------------------------------------------------------------------------
+		// |  Queues a frame. Must only be called from one thread. The queue is full
+		// |  when the queued plus in-flight frames reach the capacity; the configured
+		// |  policy then applies: BLOCK waits for a worker to finish a frame,
+		// |  DROP_OLDEST discards the oldest queued frame ( or waits, if every frame
+		// |  is in flight ) and FAIL throws.
+		// |
+		// |  Throws std::runtime_error on overrun ( FAIL policy ), on abort while
+		// |  blocked, or to report an exception thrown by the handler.
+		// |
+		// |  <IN> -> tDesc  - The frame descriptor. The queue time is set here.
+		// |  <IN> -> bAbort - Reference to an abort flag checked while blocked.
+		// +----------------------------------------------------------------------------
+		void CArcFrameQueue::push( arc::gen3::device::FrameDesc_t& tDesc, const bool& bAbort )
+		{
+			if ( m_bFailed.load( std::memory_order_acquire ) )
+			{
+				rethrow();
+			}
+
+			tDesc.u64Queued = now();
+
+			std::uint32_t uiBlocked = 0;
+
+			while ( !tryPush( tDesc ) )
+			{
+				switch ( m_ePolicy )
+				{
+					case arc::gen3::device::eQueuePolicy::DROP_OLDEST:
+					{
+						arc::gen3::device::FrameDesc_t tOldest;
+
+						if ( tryPop( tOldest ) )
+						{
+							m_u64Dropped.fetch_add( 1, std::memory_order_relaxed );
+
+							m_u64Done.fetch_add( 1, std::memory_order_release );
+						}
+						else
+						{
+							wait( uiBlocked, bAbort );
+						}
+					}
+					break;
+
+					case arc::gen3::device::eQueuePolicy::FAIL:
+					{
+						THROW( "Frame queue overrun at frame %u, %u frames queued!", tDesc.uiPCIFrameCount, depth() );
+					}
+					break;
+
+					default:
+					{
+						wait( uiBlocked, bAbort );
+					}
+				}
+			}
+
+			m_u64Queued.fetch_add( 1, std::memory_order_relaxed );
+
+			auto uiDepth = depth();
+
+			if ( uiDepth > m_uiHighWater.load( std::memory_order_relaxed ) )
+			{
+				m_uiHighWater.store( uiDepth, std::memory_order_relaxed );
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  stop
+		// +----------------------------------------------------------------------------
+		// |  Stops and joins the worker threads.
+		// |
+		// |  Throws any exception thrown by the handler when draining
+		// |
+		// |  <IN> -> bDrain - 'true' to process the queued frames first; 'false' to
+		// |                   discard them ( counted as dropped ).
+		// +----------------------------------------------------------------------------
+		void CArcFrameQueue::stop( bool bDrain )
+		{
+			if ( !bDrain )
+			{
+				m_bDiscard.store( true, std::memory_order_release );
+			}
+
+			m_bStop.store( true, std::memory_order_release );
+
+			for ( auto& tWorker : m_vWorkers )
+			{
+				if ( tWorker.joinable() )
+				{
+					tWorker.join();
+				}
+			}
+
+			m_vWorkers.clear();
+
+			//
+			// Count whatever is left behind as dropped
+			//
+			arc::gen3::device::FrameDesc_t tDesc;
+
+			while ( tryPop( tDesc ) )
+			{
+				m_u64Dropped.fetch_add( 1, std::memory_order_relaxed );
+
+				m_u64Done.fetch_add( 1, std::memory_order_release );
+			}
+
+			if ( bDrain && m_bFailed.load( std::memory_order_acquire ) )
+			{
+				rethrow();
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  depth
+		// +----------------------------------------------------------------------------
+		// |  Returns the number of frames currently queued.
+		// +----------------------------------------------------------------------------
+		std::uint32_t CArcFrameQueue::depth( void ) const
+		{
+			auto u64Tail = m_u64Tail.load( std::memory_order_acquire );
+			auto u64Head = m_u64Head.load( std::memory_order_acquire );
+
+			return ( u64Head > u64Tail ? static_cast<std::uint32_t>( u64Head - u64Tail ) : 0 );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  inFlight
+		// +----------------------------------------------------------------------------
+		// |  Returns the number of frames taken by a worker and not yet finished.
+		// +----------------------------------------------------------------------------
+		std::uint32_t CArcFrameQueue::inFlight( void ) const
+		{
+			auto u64Done = m_u64Done.load( std::memory_order_acquire );
+			auto u64Tail = m_u64Tail.load( std::memory_order_acquire );
+
+			return ( u64Tail > u64Done ? static_cast<std::uint32_t>( u64Tail - u64Done ) : 0 );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  getStats
+		// +----------------------------------------------------------------------------
+		// |  Returns the queue telemetry.
+		// +----------------------------------------------------------------------------
+		arc::gen3::device::QueueStats_t CArcFrameQueue::getStats( void )
+		{
+			arc::gen3::device::QueueStats_t tStats;
+
+			std::lock_guard<std::mutex> tLock( m_tStatsMutex );
+
+			tStats.uiWorkers    = m_uiWorkers;
+			tStats.uiCapacity   = static_cast<std::uint32_t>( m_u64Capacity );
+			tStats.uiDepth      = depth();
+			tStats.uiInFlight   = inFlight();
+			tStats.uiHighWater  = m_uiHighWater.load();
+			tStats.u64Queued    = m_u64Queued.load();
+			tStats.u64Processed = m_u64Processed;
+			tStats.u64Dropped   = m_u64Dropped.load();
+			tStats.gMeanWait    = ( m_u64Processed > 0 ? m_gWaitSum / static_cast<double>( m_u64Processed ) : 0.0 );
+			tStats.gMeanLatency = ( m_u64Processed > 0 ? m_gLatencySum / static_cast<double>( m_u64Processed ) : 0.0 );
+			tStats.gMaxLatency  = m_gLatencyMax;
+
+			return tStats;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  now
+		// +----------------------------------------------------------------------------
+		// |  Returns the steady clock time in nanoseconds; the same clock used for
+		// |  the frame detection timestamp.
+		// +----------------------------------------------------------------------------
+		std::uint64_t CArcFrameQueue::now( void )
+		{
+			return static_cast<std::uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count() );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  tryPush
+		// +----------------------------------------------------------------------------
+		// |  Single producer enqueue. Each cell carries a sequence number: a cell is
+		// |  free for position p when its sequence equals p and holds a frame when
+		// |  it equals p + 1. A popped cell is free again as soon as it is read, so
+		// |  the frames still held by workers are counted against the capacity
+		// |  separately. Returns 'false' if the queue is full.
+		// +----------------------------------------------------------------------------
+		bool CArcFrameQueue::tryPush( const arc::gen3::device::FrameDesc_t& tDesc )
+		{
+			auto u64Pos = m_u64Head.load( std::memory_order_relaxed );
+
+			if ( u64Pos - m_u64Done.load( std::memory_order_acquire ) >= m_u64Capacity )
+			{
+				return false;
+			}
+
+			auto& tCell = m_pCells[ u64Pos % m_u64Capacity ];
+
+			if ( tCell.u64Seq.load( std::memory_order_acquire ) != u64Pos )
+			{
+				return false;
+			}
+
+			tCell.tDesc = tDesc;
+
+			tCell.u64Seq.store( u64Pos + 1, std::memory_order_release );
+
+			m_u64Head.store( u64Pos + 1, std::memory_order_release );
+
+			return true;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  tryPop
+		// +----------------------------------------------------------------------------
+		// |  Multiple consumer dequeue; also used by the producer to drop the oldest
+		// |  frame. Returns 'false' if the queue is empty.
+		// +----------------------------------------------------------------------------
+		bool CArcFrameQueue::tryPop( arc::gen3::device::FrameDesc_t& tDesc )
+		{
+			auto u64Pos = m_u64Tail.load( std::memory_order_relaxed );
+
+			while ( true )
+			{
+				auto& tCell = m_pCells[ u64Pos % m_u64Capacity ];
+
+				auto u64Seq = tCell.u64Seq.load( std::memory_order_acquire );
+
+				if ( u64Seq == u64Pos + 1 )
+				{
+					if ( m_u64Tail.compare_exchange_weak( u64Pos, u64Pos + 1, std::memory_order_relaxed ) )
+					{
+						tDesc = std::move( tCell.tDesc );
+
+						tCell.u64Seq.store( u64Pos + m_u64Capacity, std::memory_order_release );
+
+						return true;
+					}
+				}
+
+				else if ( u64Seq < u64Pos + 1 )
+				{
+					return false;
+				}
+
+				else
+				{
+					u64Pos = m_u64Tail.load( std::memory_order_relaxed );
+				}
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  worker
+		// +----------------------------------------------------------------------------
+		// |  Worker thread. Drains frames until stopped. The first exception thrown
+		// |  by the handler is kept and reported to the producer; the worker keeps
+		// |  draining so the producer is never left blocked on a full queue.
+		// +----------------------------------------------------------------------------
+		void CArcFrameQueue::worker( std::function<void( void )> fnThreadInit )
+		{
+			if ( fnThreadInit != nullptr )
+			{
+				fnThreadInit();
+			}
+
+			arc::gen3::device::FrameDesc_t tDesc;
+
+			std::uint32_t uiIdle = 0;
+
+			while ( !m_bDiscard.load( std::memory_order_acquire ) )
+			{
+				if ( !tryPop( tDesc ) )
+				{
+					if ( m_bStop.load( std::memory_order_acquire ) )
+					{
+						break;
+					}
+
+					if ( ++uiIdle < QUEUE_IDLE_YIELDS )
+					{
+						std::this_thread::yield();
+					}
+					else
+					{
+						std::this_thread::sleep_for( std::chrono::microseconds( QUEUE_IDLE_SLEEP ) );
+					}
+
+					continue;
+				}
+
+				uiIdle = 0;
+
+				if ( m_bFailed.load( std::memory_order_acquire ) )
+				{
+					m_u64Dropped.fetch_add( 1, std::memory_order_relaxed );
+
+					m_u64Done.fetch_add( 1, std::memory_order_release );
+
+					continue;
+				}
+
+				auto u64Start = now();
+
+				try
+				{
+					m_fnHandler( tDesc );
+				}
+				catch ( ... )
+				{
+					std::lock_guard<std::mutex> tLock( m_tStatsMutex );
+
+					if ( !m_bFailed.load() )
+					{
+						m_pError = std::current_exception();
+
+						m_bFailed.store( true, std::memory_order_release );
+					}
+				}
+
+				auto u64End = now();
+
+				//
+				// Release the frame's lease before counting it as finished
+				//
+				auto u64Stamp  = tDesc.tStamp.u64Monotonic;
+				auto u64Queued = tDesc.u64Queued;
+
+				tDesc = arc::gen3::device::FrameDesc_t();
+
+				m_u64Done.fetch_add( 1, std::memory_order_release );
+
+				std::lock_guard<std::mutex> tLock( m_tStatsMutex );
+
+				double gLatency = static_cast<double>( u64End - std::min( u64End, u64Stamp ) ) / 1.0e9;
+
+				m_u64Processed++;
+				m_gWaitSum    += static_cast<double>( u64Start - std::min( u64Start, u64Queued ) ) / 1.0e9;
+				m_gLatencySum += gLatency;
+				m_gLatencyMax  = std::max( m_gLatencyMax, gLatency );
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  wait
+		// +----------------------------------------------------------------------------
+		// |  Backs off while push() waits for a worker to finish a frame.
+		// |
+		// |  Throws std::runtime_error on abort, or to report an exception thrown by
+		// |  the handler.
+		// |
+		// |  <IN/OUT> -> uiBlocked - The number of times the producer has waited.
+		// |  <IN>     -> bAbort    - Reference to an abort flag.
+		// +----------------------------------------------------------------------------
+		void CArcFrameQueue::wait( std::uint32_t& uiBlocked, const bool& bAbort )
+		{
+			if ( bAbort )
+			{
+				THROW( "Frame queue push aborted by user!" );
+			}
+
+			if ( m_bFailed.load( std::memory_order_acquire ) )
+			{
+				rethrow();
+			}
+
+			//
+			// Sleep rather than only yield, so that workers with a lower
+			// real-time priority on the same CPU get to run
+			//
+			if ( ++uiBlocked < QUEUE_IDLE_YIELDS )
+			{
+				std::this_thread::yield();
+			}
+			else
+			{
+				std::this_thread::sleep_for( std::chrono::microseconds( QUEUE_IDLE_SLEEP ) );
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  rethrow
+		// +----------------------------------------------------------------------------
+		// |  Rethrows the first exception thrown by the handler.
+		// +----------------------------------------------------------------------------
+		void CArcFrameQueue::rethrow( void )
+		{
+			std::exception_ptr pError;
+
+			{
+				std::lock_guard<std::mutex> tLock( m_tStatsMutex );
+
+				pError = m_pError;
+			}
+
+			if ( pError )
+			{
+				std::rethrow_exception( pError );
+			}
+
+			THROW( "Frame queue handler failed!" );
+		}
+
+	}	// end gen3 namespace
+}	// end arc namespace
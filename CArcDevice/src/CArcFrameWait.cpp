@@ -0,0 +1,344 @@
+//
+// CArcFrameWait.cpp : Defines continuous readout frame wait strategies
+//
+#ifdef _WINDOWS
+	#include <windows.h>
+#else
+	#include <time.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include <CArcBase.h>
+#include <CArcFrameWait.h>
+
+
+
+namespace arc
+{
+	namespace gen3
+	{
+
+		// +----------------------------------------------------------------------------
+		// |  Smallest park interval ( ns ) and park interval as a fraction of the
+		// |  frame period. The smallest interval covers the usual sleep overshoot.
+		// +----------------------------------------------------------------------------
+		#define WAIT_MIN_PARK			100000ULL
+		#define WAIT_PARK_DIVISOR		32.0
+
+		// +----------------------------------------------------------------------------
+		// |  Longest single sleep ( ns ), so an abort is seen promptly
+		// +----------------------------------------------------------------------------
+		#define WAIT_MAX_SLEEP			25000000ULL
+
+		// +----------------------------------------------------------------------------
+		// |  Frame period moving average weight given to each new observation
+		// +----------------------------------------------------------------------------
+		#define WAIT_EWMA_WEIGHT		0.125
+
+
+		// +----------------------------------------------------------------------------
+		// |  Returns the CLOCK_MONOTONIC time in nanoseconds. Must match the clock the
+		// |  acquisition loop uses to time its polls.
+		// +----------------------------------------------------------------------------
+		static std::uint64_t waitClock( void )
+		{
+			#ifdef _WINDOWS
+				return static_cast<std::uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count() );
+			#else
+				struct timespec tMonotonic;
+
+				clock_gettime( CLOCK_MONOTONIC, &tMonotonic );
+
+				return static_cast<std::uint64_t>( tMonotonic.tv_sec ) * 1000000000ULL + static_cast<std::uint64_t>( tMonotonic.tv_nsec );
+			#endif
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------+
+		// |  Constructor                                                                                       |
+		// +----------------------------------------------------------------------------------------------------+
+		// |  <IN> -> eStrategy   - How to wait between frame count polls.                                      |
+		// |  <IN> -> gCpuBudget  - Fraction of one core HYBRID may spend spinning ( 0.0 - 1.0 ).               |
+		// |  <IN> -> gFirstFrame - Earliest expected completion of the first frame ( seconds after start ).    |
+		// +----------------------------------------------------------------------------------------------------+
+		CArcFrameWait::CArcFrameWait( arc::gen3::device::eWaitStrategy eStrategy, double gCpuBudget, double gFirstFrame )
+			: m_eStrategy( eStrategy ), m_gCpuBudget( std::min( 1.0, std::max( 0.0, gCpuBudget ) ) ), m_gPeriod( std::max( 0.0, gFirstFrame ) * 1.0e9 ),
+			  m_bMeasured( false ), m_u64Start( 0 ), m_u64Frames( 0 ), m_bAnchored( false ), m_bAccurate( false ), m_u64Anchor( 0 ), m_u64AnchorFrame( 0 ), m_u64Polls( 0 ),
+			  m_u64CpuMark( 0 ), m_u64WallMark( 0 ),
+			  m_u64CpuWaiting( 0 ), m_u64WallWaiting( 0 )
+		{
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  start
+		// +----------------------------------------------------------------------------
+		// |  Marks the start of the acquisition. The first frame is predicted at the
+		// |  first frame time passed to the constructor, which is also the period
+		// |  used until one has been measured. It should not be later than the real
+		// |  first frame ( the exposure time is a safe choice ), since frames that
+		// |  arrive before their predicted time are detected late.
+		// |
+		// |  <IN> -> u64Now - Monotonic time the exposure was started ( ns ).
+		// +----------------------------------------------------------------------------
+		void CArcFrameWait::start( std::uint64_t u64Now )
+		{
+			m_u64Start = u64Now;
+
+			resume();
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  wait
+		// +----------------------------------------------------------------------------
+		// |  Returns when the next frame count poll is due. SPIN returns at once.
+		// |  Sleeps are split so that an abort or stop is seen within WAIT_MAX_SLEEP.
+		// |
+		// |  <IN> -> bAbort - 'true' to return immediately.
+		// |  <IN> -> pStop  - Optional stop request; 'true' to return immediately.
+		// +----------------------------------------------------------------------------
+		void CArcFrameWait::wait( const bool& bAbort, const std::atomic<bool>* pStop )
+		{
+			if ( m_eStrategy == arc::gen3::device::eWaitStrategy::SPIN )
+			{
+				return;
+			}
+
+			std::uint64_t u64Window = spinWindow();
+			std::uint64_t u64Next   = nextFrame();
+
+			bool bSlept = false;
+
+			while ( !bAbort && ( pStop == nullptr || !pStop->load( std::memory_order_acquire ) ) )
+			{
+				std::uint64_t u64Now = waitClock();
+
+				//
+				// Ahead of the spin window; sleep up to it
+				//
+				if ( ( u64Now + u64Window ) < u64Next )
+				{
+					std::uint64_t u64Sleep = std::min<std::uint64_t>( u64Next - u64Window - u64Now, WAIT_MAX_SLEEP );
+
+					std::this_thread::sleep_for( std::chrono::nanoseconds( u64Sleep ) );
+
+					bSlept = true;
+
+					continue;
+				}
+
+				//
+				// Just reached the spin window, or inside it; poll now
+				//
+				if ( bSlept || ( m_eStrategy == arc::gen3::device::eWaitStrategy::HYBRID && u64Now < ( u64Next + u64Window ) ) )
+				{
+					return;
+				}
+
+				//
+				// The frame is late, or the strategy never spins; park between polls
+				//
+				std::this_thread::sleep_for( std::chrono::nanoseconds( parkInterval() ) );
+
+				return;
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  polled
+		// +----------------------------------------------------------------------------
+		// |  Records a frame count poll. When new frames were seen and the previous
+		// |  poll was recent, the latest one completed at about the midpoint between
+		// |  the two polls; it becomes the anchor for later predictions and its
+		// |  distance from the previous anchor updates the frame period. Otherwise
+		// |  the period is only clamped to the range the two polls allow. The time
+		// |  spent waiting for the frames is added to the CPU usage.
+		// |
+		// |  <IN> -> u64PollTime     - Monotonic time of this poll ( ns ).
+		// |  <IN> -> u64LastPollTime - Monotonic time of the previous poll ( ns ).
+		// |  <IN> -> uiFrames        - Number of new frames seen by this poll.
+		// +----------------------------------------------------------------------------
+		void CArcFrameWait::polled( std::uint64_t u64PollTime, std::uint64_t u64LastPollTime, std::uint32_t uiFrames )
+		{
+			m_u64Polls++;
+
+			if ( uiFrames == 0 )
+			{
+				return;
+			}
+
+			m_u64Frames += uiFrames;
+
+			std::uint64_t u64Gap = u64PollTime - std::min( u64PollTime, u64LastPollTime );
+
+			bool bAccurate = ( u64Gap <= 2 * parkInterval() );
+
+			if ( bAccurate || !m_bAnchored )
+			{
+				std::uint64_t u64Done = u64LastPollTime + u64Gap / 2;
+
+				if ( bAccurate && m_bAccurate && u64Done > m_u64Anchor )
+				{
+					double gSample = static_cast<double>( u64Done - m_u64Anchor ) / static_cast<double>( m_u64Frames - m_u64AnchorFrame );
+
+					m_gPeriod   = ( m_bMeasured ? m_gPeriod + WAIT_EWMA_WEIGHT * ( gSample - m_gPeriod ) : gSample );
+					m_bMeasured = true;
+				}
+
+				m_u64Anchor      = u64Done;
+				m_u64AnchorFrame = m_u64Frames;
+				m_bAnchored      = true;
+				m_bAccurate      = bAccurate;
+			}
+			else
+			{
+				//
+				// The frame completed between the two polls, so the period lies
+				// between these bounds
+				//
+				double gFrames = static_cast<double>( m_u64Frames - m_u64AnchorFrame );
+				double gLow    = static_cast<double>( u64LastPollTime - std::min( u64LastPollTime, m_u64Anchor ) ) / gFrames;
+				double gHigh   = static_cast<double>( u64PollTime - std::min( u64PollTime, m_u64Anchor ) ) / gFrames;
+
+				m_gPeriod = std::min( std::max( m_gPeriod, gLow ), gHigh );
+			}
+
+			m_u64CpuWaiting  += ( threadCpuTime() - m_u64CpuMark );
+			m_u64WallWaiting += ( u64PollTime - std::min( u64PollTime, m_u64WallMark ) );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  resume
+		// +----------------------------------------------------------------------------
+		// |  Starts timing a wait. Called once the frames seen by the last poll have
+		// |  been delivered, so frame processing is not counted as polling CPU time.
+		// +----------------------------------------------------------------------------
+		void CArcFrameWait::resume( void )
+		{
+			m_u64CpuMark  = threadCpuTime();
+			m_u64WallMark = waitClock();
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  predictedPeriod
+		// +----------------------------------------------------------------------------
+		// |  Returns the predicted frame period ( in seconds ).
+		// +----------------------------------------------------------------------------
+		double CArcFrameWait::predictedPeriod( void ) const
+		{
+			return ( m_gPeriod / 1.0e9 );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  polls
+		// +----------------------------------------------------------------------------
+		// |  Returns the number of frame count polls.
+		// +----------------------------------------------------------------------------
+		std::uint64_t CArcFrameWait::polls( void ) const
+		{
+			return m_u64Polls;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  cpuUsage
+		// +----------------------------------------------------------------------------
+		// |  Returns the CPU time spent waiting for frames as a fraction of the wall
+		// |  time spent waiting ( 1.0 = one full core ).
+		// +----------------------------------------------------------------------------
+		double CArcFrameWait::cpuUsage( void ) const
+		{
+			if ( m_u64WallWaiting == 0 )
+			{
+				return 0.0;
+			}
+
+			return ( static_cast<double>( m_u64CpuWaiting ) / static_cast<double>( m_u64WallWaiting ) );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  threadCpuTime
+		// +----------------------------------------------------------------------------
+		// |  Returns the CPU time used by the calling thread in nanoseconds.
+		// +----------------------------------------------------------------------------
+		std::uint64_t CArcFrameWait::threadCpuTime( void )
+		{
+			#ifdef _WINDOWS
+				FILETIME tCreation, tExit, tKernel, tUser;
+
+				if ( !GetThreadTimes( GetCurrentThread(), &tCreation, &tExit, &tKernel, &tUser ) )
+				{
+					return 0;
+				}
+
+				std::uint64_t u64Kernel = ( static_cast<std::uint64_t>( tKernel.dwHighDateTime ) << 32 ) | tKernel.dwLowDateTime;
+				std::uint64_t u64User   = ( static_cast<std::uint64_t>( tUser.dwHighDateTime ) << 32 ) | tUser.dwLowDateTime;
+
+				return ( ( u64Kernel + u64User ) * 100ULL );
+			#else
+				struct timespec tCpu;
+
+				clock_gettime( CLOCK_THREAD_CPUTIME_ID, &tCpu );
+
+				return static_cast<std::uint64_t>( tCpu.tv_sec ) * 1000000000ULL + static_cast<std::uint64_t>( tCpu.tv_nsec );
+			#endif
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  nextFrame
+		// +----------------------------------------------------------------------------
+		// |  Returns the predicted completion time of the next frame ( ns ).
+		// +----------------------------------------------------------------------------
+		std::uint64_t CArcFrameWait::nextFrame( void ) const
+		{
+			if ( !m_bAnchored )
+			{
+				return ( m_u64Start + static_cast<std::uint64_t>( m_gPeriod ) );
+			}
+
+			return ( m_u64Anchor + static_cast<std::uint64_t>( m_gPeriod * static_cast<double>( m_u64Frames - m_u64AnchorFrame + 1 ) ) );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  spinWindow
+		// +----------------------------------------------------------------------------
+		// |  Returns the time either side of the predicted frame in which HYBRID
+		// |  spins ( ns ). SLEEP parks between polls instead. Polling starts at least
+		// |  one park interval early, so a frame that is slightly early is still
+		// |  timed accurately.
+		// +----------------------------------------------------------------------------
+		std::uint64_t CArcFrameWait::spinWindow( void ) const
+		{
+			if ( m_eStrategy != arc::gen3::device::eWaitStrategy::HYBRID )
+			{
+				return parkInterval();
+			}
+
+			return std::max<std::uint64_t>( static_cast<std::uint64_t>( m_gCpuBudget * m_gPeriod ), parkInterval() );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  parkInterval
+		// +----------------------------------------------------------------------------
+		// |  Returns the sleep between polls once the predicted frame is overdue ( ns ).
+		// |  This bounds the detection latency of late frames.
+		// +----------------------------------------------------------------------------
+		std::uint64_t CArcFrameWait::parkInterval( void ) const
+		{
+			return std::max<std::uint64_t>( static_cast<std::uint64_t>( m_gPeriod / WAIT_PARK_DIVISOR ), WAIT_MIN_PARK );
+		}
+
+	}	// end gen3 namespace
+}	// end arc namespace
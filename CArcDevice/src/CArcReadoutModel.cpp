@@ -0,0 +1,343 @@
+//
+// CArcReadoutModel.cpp : Defines a learned image readout time model
+//
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+
+#include <CArcBase.h>
+#include <CArcReadoutModel.h>
+
+
+
+namespace arc
+{
+	namespace gen3
+	{
+
+		// +----------------------------------------------------------------------------
+		// |  Readout model file key
+		// +----------------------------------------------------------------------------
+		#define READOUT_MODEL_KEY		"[READOUT_MODEL]"
+
+
+		// +----------------------------------------------------------------------------------------------------+
+		// |  Constructor                                                                                       |
+		// +----------------------------------------------------------------------------------------------------+
+		CArcReadoutModel::CArcReadoutModel( void )
+		{
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  addSample
+		// +----------------------------------------------------------------------------
+		// |  Adds an observed readout to the model for the specified configuration.
+		// |  Once a configuration holds SAMPLE_WINDOW samples, older samples decay
+		// |  by a factor of ( 1 - 1 / SAMPLE_WINDOW ) per new sample.
+		// |
+		// |  <IN> -> uiConfig    - The controller configuration word ( RCC ).
+		// |  <IN> -> uiRowFactor - The row binning factor.
+		// |  <IN> -> uiColFactor - The column binning factor.
+		// |  <IN> -> u64Pixels   - The number of pixels read.
+		// |  <IN> -> gSeconds    - The measured readout time ( seconds ).
+		// +----------------------------------------------------------------------------
+		void CArcReadoutModel::addSample( std::uint32_t uiConfig, std::uint32_t uiRowFactor, std::uint32_t uiColFactor, std::uint64_t u64Pixels, double gSeconds )
+		{
+			if ( u64Pixels == 0 || !( gSeconds > 0.0 ) )
+			{
+				return;
+			}
+
+			std::lock_guard<std::mutex> tLock( m_tMutex );
+
+			auto& tSums = m_mSums[ Key_t( uiConfig, uiRowFactor, uiColFactor ) ];
+
+			if ( tSums.uiSamples >= SAMPLE_WINDOW )
+			{
+				double gDecay = 1.0 - 1.0 / static_cast<double>( SAMPLE_WINDOW );
+
+				tSums.gWeight *= gDecay;
+				tSums.gSumX   *= gDecay;
+				tSums.gSumY   *= gDecay;
+				tSums.gSumXX  *= gDecay;
+				tSums.gSumXY  *= gDecay;
+				tSums.gSumYY  *= gDecay;
+			}
+
+			double gX = static_cast<double>( u64Pixels );
+
+			tSums.gWeight += 1.0;
+			tSums.gSumX   += gX;
+			tSums.gSumY   += gSeconds;
+			tSums.gSumXX  += gX * gX;
+			tSums.gSumXY  += gX * gSeconds;
+			tSums.gSumYY  += gSeconds * gSeconds;
+
+			tSums.uiSamples++;
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  contains
+		// +----------------------------------------------------------------------------
+		// |  Returns 'true' if at least one readout has been observed for the specified
+		// |  configuration; 'false' otherwise.
+		// |
+		// |  <IN> -> uiConfig    - The controller configuration word ( RCC ).
+		// |  <IN> -> uiRowFactor - The row binning factor.
+		// |  <IN> -> uiColFactor - The column binning factor.
+		// +----------------------------------------------------------------------------
+		bool CArcReadoutModel::contains( std::uint32_t uiConfig, std::uint32_t uiRowFactor, std::uint32_t uiColFactor )
+		{
+			std::lock_guard<std::mutex> tLock( m_tMutex );
+
+			return ( m_mSums.find( Key_t( uiConfig, uiRowFactor, uiColFactor ) ) != m_mSums.end() );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  getModel
+		// +----------------------------------------------------------------------------
+		// |  Returns the fitted model for the specified configuration.
+		// |
+		// |  Throws std::runtime_error if no readouts have been observed for the
+		// |  configuration.
+		// |
+		// |  <IN> -> uiConfig    - The controller configuration word ( RCC ).
+		// |  <IN> -> uiRowFactor - The row binning factor.
+		// |  <IN> -> uiColFactor - The column binning factor.
+		// +----------------------------------------------------------------------------
+		arc::gen3::device::ReadoutModel_t CArcReadoutModel::getModel( std::uint32_t uiConfig, std::uint32_t uiRowFactor, std::uint32_t uiColFactor )
+		{
+			std::lock_guard<std::mutex> tLock( m_tMutex );
+
+			auto it = m_mSums.find( Key_t( uiConfig, uiRowFactor, uiColFactor ) );
+
+			if ( it == m_mSums.end() )
+			{
+				THROW( "No readout model for configuration 0x%X with binning [ %u x %u ].", uiConfig, uiColFactor, uiRowFactor );
+			}
+
+			return fit( it->second );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  predict
+		// +----------------------------------------------------------------------------
+		// |  Returns the predicted readout time ( in seconds ) for the specified pixel
+		// |  count. If the binning factors have not been observed, the unbinned model
+		// |  for the same configuration is used with the binned pixel count.
+		// |
+		// |  Throws std::runtime_error if no readouts have been observed for the
+		// |  configuration.
+		// |
+		// |  <IN> -> uiConfig    - The controller configuration word ( RCC ).
+		// |  <IN> -> uiRowFactor - The row binning factor.
+		// |  <IN> -> uiColFactor - The column binning factor.
+		// |  <IN> -> u64Pixels   - The number of pixels to be read.
+		// +----------------------------------------------------------------------------
+		double CArcReadoutModel::predict( std::uint32_t uiConfig, std::uint32_t uiRowFactor, std::uint32_t uiColFactor, std::uint64_t u64Pixels )
+		{
+			arc::gen3::device::ReadoutModel_t tModel;
+
+			{
+				std::lock_guard<std::mutex> tLock( m_tMutex );
+
+				auto it = m_mSums.find( Key_t( uiConfig, uiRowFactor, uiColFactor ) );
+
+				if ( it == m_mSums.end() )
+				{
+					it = m_mSums.find( Key_t( uiConfig, 1, 1 ) );
+				}
+
+				if ( it == m_mSums.end() )
+				{
+					THROW( "No readout model for configuration 0x%X. At least one readout must be observed.", uiConfig );
+				}
+
+				tModel = fit( it->second );
+			}
+
+			return ( tModel.gOverhead + static_cast<double>( u64Pixels ) / tModel.gPixelRate );
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  clear
+		// +----------------------------------------------------------------------------
+		// |  Discards all observed readouts.
+		// +----------------------------------------------------------------------------
+		void CArcReadoutModel::clear( void )
+		{
+			std::lock_guard<std::mutex> tLock( m_tMutex );
+
+			m_mSums.clear();
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  load
+		// +----------------------------------------------------------------------------
+		// |  Loads a readout model file previously written by save(). Configurations
+		// |  in the file replace any matching configurations already learned.
+		// |
+		// |  Throws std::runtime_error on error
+		// |
+		// |  <IN> -> sFilename - The readout model file to load.
+		// +----------------------------------------------------------------------------
+		void CArcReadoutModel::load( const std::string& sFilename )
+		{
+			std::ifstream ifs( sFilename.c_str() );
+
+			if ( !ifs.is_open() )
+			{
+				THROW( "Failed to open readout model file: %s", sFilename.c_str() );
+			}
+
+			std::lock_guard<std::mutex> tLock( m_tMutex );
+
+			std::string sBuf;
+
+			while ( getline( ifs, sBuf ) )
+			{
+				if ( sBuf.find( "//" ) != std::string::npos || sBuf.find( READOUT_MODEL_KEY ) == std::string::npos )
+				{
+					continue;
+				}
+
+				std::uint32_t uiConfig    = 0;
+				std::uint32_t uiRowFactor = 0;
+				std::uint32_t uiColFactor = 0;
+				Sums_t        tSums       = {};
+
+				std::istringstream issKey( sBuf.substr( sBuf.find( READOUT_MODEL_KEY ) + std::string( READOUT_MODEL_KEY ).length() ) );
+
+				issKey >> std::hex >> uiConfig >> std::dec >> uiRowFactor >> uiColFactor;
+
+				getline( ifs, sBuf );
+
+				std::istringstream issSums( sBuf );
+
+				issSums >> tSums.gWeight >> tSums.gSumX >> tSums.gSumY >> tSums.gSumXX >> tSums.gSumXY >> tSums.gSumYY >> tSums.uiSamples;
+
+				if ( issKey.fail() || issSums.fail() || uiRowFactor == 0 || uiColFactor == 0 || !( tSums.gWeight > 0.0 ) )
+				{
+					THROW( "Invalid readout model entry in file: %s", sFilename.c_str() );
+				}
+
+				m_mSums[ Key_t( uiConfig, uiRowFactor, uiColFactor ) ] = tSums;
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  save
+		// +----------------------------------------------------------------------------
+		// |  Writes all learned configurations to the specified file. The raw fit sums
+		// |  are stored so that learning can continue after the file is re-loaded.
+		// |
+		// |  Throws std::runtime_error on error
+		// |
+		// |  <IN> -> sFilename - The readout model file to write.
+		// +----------------------------------------------------------------------------
+		void CArcReadoutModel::save( const std::string& sFilename )
+		{
+			std::ofstream ofs( sFilename.c_str() );
+
+			if ( !ofs.is_open() )
+			{
+				THROW( "Failed to open readout model file: %s", sFilename.c_str() );
+			}
+
+			std::lock_guard<std::mutex> tLock( m_tMutex );
+
+			ofs.precision( 17 );
+
+			ofs << "// _____________________________________________________________" << std::endl;
+			ofs << "//" << std::endl;
+			ofs << "// READOUT MODEL FILE" << std::endl;
+			ofs << "// _____________________________________________________________" << std::endl;
+			ofs << "//" << std::endl;
+			ofs << "// +-----------------------------------------------------------" << std::endl;
+			ofs << "// | FORMAT:" << std::endl;
+			ofs << "// | ---------------------" << std::endl;
+			ofs << "// | " << READOUT_MODEL_KEY << " <Config Word ( hex )> <Row Factor> <Col Factor>" << std::endl;
+			ofs << "// | <Weight> <Sum X> <Sum Y> <Sum XX> <Sum XY> <Sum YY> <Samples>" << std::endl;
+			ofs << "// |" << std::endl;
+			ofs << "// | X is the pixel count, Y is the readout time ( seconds )." << std::endl;
+			ofs << "// +-----------------------------------------------------------" << std::endl;
+
+			for ( auto& tEntry : m_mSums )
+			{
+				auto tModel = fit( tEntry.second );
+
+				ofs << "// Overhead: " << tModel.gOverhead << " s, Rate: " << tModel.gPixelRate << " pixels/s" << std::endl;
+
+				ofs << READOUT_MODEL_KEY << " 0x" << std::hex << std::get<0>( tEntry.first ) << std::dec
+					<< " " << std::get<1>( tEntry.first ) << " " << std::get<2>( tEntry.first ) << std::endl;
+
+				ofs << tEntry.second.gWeight << " " << tEntry.second.gSumX << " " << tEntry.second.gSumY << " "
+					<< tEntry.second.gSumXX << " " << tEntry.second.gSumXY << " " << tEntry.second.gSumYY << " "
+					<< tEntry.second.uiSamples << std::endl << std::endl;
+			}
+
+			if ( !ofs.good() )
+			{
+				THROW( "Failed to write readout model file: %s", sFilename.c_str() );
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------
+		// |  fit
+		// +----------------------------------------------------------------------------
+		// |  Computes the least squares fit of readout time against pixel count. If
+		// |  only one image size has been observed the overhead cannot be separated
+		// |  from the pixel time, so the line is fit through the origin instead. The
+		// |  origin fit is also used if the free fit is unphysical ( negative
+		// |  overhead or non-positive pixel time ).
+		// |
+		// |  <IN> -> tSums - The accumulated sums for one configuration.
+		// +----------------------------------------------------------------------------
+		arc::gen3::device::ReadoutModel_t CArcReadoutModel::fit( const Sums_t& tSums )
+		{
+			arc::gen3::device::ReadoutModel_t tModel = { 0.0, 0.0, 0.0, tSums.uiSamples };
+
+			double gMeanX = tSums.gSumX / tSums.gWeight;
+			double gMeanY = tSums.gSumY / tSums.gWeight;
+			double gVarX  = tSums.gSumXX / tSums.gWeight - gMeanX * gMeanX;
+
+			double gIntercept = 0.0;
+			double gSlope     = 0.0;
+
+			if ( gVarX > 1.0e-9 * gMeanX * gMeanX )
+			{
+				gSlope     = ( tSums.gSumXY / tSums.gWeight - gMeanX * gMeanY ) / gVarX;
+				gIntercept = gMeanY - gSlope * gMeanX;
+			}
+
+			if ( !( gSlope > 0.0 ) || gIntercept < 0.0 )
+			{
+				gIntercept = 0.0;
+				gSlope     = tSums.gSumXY / tSums.gSumXX;
+			}
+
+			double gSSE = tSums.gSumYY
+						- 2.0 * gIntercept * tSums.gSumY
+						- 2.0 * gSlope * tSums.gSumXY
+						+ gIntercept * gIntercept * tSums.gWeight
+						+ 2.0 * gIntercept * gSlope * tSums.gSumX
+						+ gSlope * gSlope * tSums.gSumXX;
+
+			tModel.gOverhead  = gIntercept;
+			tModel.gPixelRate = 1.0 / gSlope;
+			tModel.gRmsError  = std::sqrt( std::max( 0.0, gSSE ) / tSums.gWeight );
+
+			return tModel;
+		}
+
+	}	// end gen3 namespace
+}	// end arc namespace
@@ -6,17 +6,20 @@
 CPP_SRCS += \
 ../src/ArcFitsFileCAPI.cpp \
 ../src/CArcFitsFile.cpp \
-../src/CArcFitsFileDllMain.cpp 
+../src/CArcFitsFileDllMain.cpp \
+../src/CArcFrameLog.cpp 
 
 OBJS += \
 ./src/ArcFitsFileCAPI.o \
 ./src/CArcFitsFile.o \
-./src/CArcFitsFileDllMain.o 
+./src/CArcFitsFileDllMain.o \
+./src/CArcFrameLog.o 
 
 CPP_DEPS += \
 ./src/ArcFitsFileCAPI.d \
 ./src/CArcFitsFile.d \
-./src/CArcFitsFileDllMain.d 
+./src/CArcFitsFileDllMain.d \
+./src/CArcFrameLog.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -0,0 +1,306 @@
+/*! \file CArcFrameLog.h */
+// +------------------------------------------------------------------------------------------------------------------+
+// |  FILE:  CArcFrameLog.h  ( Gen3 )                                                                                 |
+// +------------------------------------------------------------------------------------------------------------------+
+// |  PURPOSE: This file defines an append-only raw frame log for high-rate capture, with a reader and a FITS data    |
+// |           cube converter.                                                                                        |
+// +------------------------------------------------------------------------------------------------------------------+
+
+#ifndef _GEN3_CARCFRAMELOG_H_
+#define _GEN3_CARCFRAMELOG_H_
+
+#ifdef _WINDOWS
+#pragma warning( disable: 4251 )
+#endif
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <mutex>
+
+#include <CArcFitsFileDllMain.h>
+#include <CArcBase.h>
+
+
+
+namespace arc
+{
+	namespace gen3
+	{
+
+		namespace fits
+		{
+
+			/** @struct FrameLogEntry
+			 *  Frame log index entry. One entry per frame, in the order the frames were appended.
+			 */
+			struct GEN3_CARCFITSFILE_API FrameLogEntry
+			{
+				/** The frame ( sequence ) number supplied by the writer */
+				std::uint64_t u64Frame;
+
+				/** The frame timestamp supplied by the writer ( typically ns ) */
+				std::int64_t i64Timestamp;
+
+				/** The byte offset of the frame pixel data within the log file */
+				std::uint64_t u64Offset;
+
+				/** The image column size ( in pixels ) */
+				std::uint32_t uiCols;
+
+				/** The image row size ( in pixels ) */
+				std::uint32_t uiRows;
+
+				/** The image bits-per-pixel ( 16 or 32 ) */
+				std::uint32_t uiBpp;
+
+				/** Reserved, written as zero */
+				std::uint32_t uiReserved;
+
+				/** Returns the frame pixel data size ( in bytes ).
+				 *  @return The frame size in bytes.
+				 */
+				std::uint64_t bytes( void ) const;
+			};
+
+		}	// end fits namespace
+
+
+		/** @class CArcFrameLog
+		 *  Append-only raw frame log writer. Frames are copied into a large staging buffer and written with one
+		 *  sequential write per buffer, so capture runs at disk bandwidth; FITS formatting is deferred to
+		 *  CArcFrameLogReader::toFitsCube(). Each frame is preceded by a record header in the log, and a compact
+		 *  index ( <log file>.idx ) is written alongside for random access. The index only ever refers to data
+		 *  already written, and a missing or short index is rebuilt from the record headers by the reader, so
+		 *  a log cut short by a crash remains readable up to the last complete frame. append() is thread-safe.
+		 */
+		class GEN3_CARCFITSFILE_API CArcFrameLog
+		{
+		public:
+
+			/** Constructor
+			 *  Creates an empty frame log object.
+			 */
+			CArcFrameLog( void );
+
+			/** Destructor
+			 *  Closes the log, writing any buffered frames.
+			 */
+			virtual ~CArcFrameLog( void );
+
+			/** Creates a new, empty frame log on disk. Existing files are overwritten.
+			 *  @param sFileName	 - The log file name. The index is written to sFileName + ".idx".
+			 *  @param uiBufferBytes - The staging buffer size ( default = 16 MB ).
+			 *  @throws std::runtime_error
+			 *  @throws std::invalid_argument
+			 */
+			void create( const std::string& sFileName, std::uint32_t uiBufferBytes = ( 16 * 1024 * 1024 ) );
+
+			/** Appends a frame to the log.
+			 *  @param pBuf			- The frame pixel data. Buffer access violation results in undefined behavior.
+			 *  @param uiCols		- The image column size ( in pixels ).
+			 *  @param uiRows		- The image row size ( in pixels ).
+			 *  @param uiBpp		- The image bits-per-pixel ( 16 or 32 ).
+			 *  @param u64Frame		- The frame ( sequence ) number.
+			 *  @param i64Timestamp	- The frame timestamp ( typically ns ).
+			 *  @throws std::runtime_error
+			 *  @throws std::invalid_argument
+			 */
+			void append( const void* pBuf, std::uint32_t uiCols, std::uint32_t uiRows, std::uint32_t uiBpp, std::uint64_t u64Frame, std::int64_t i64Timestamp );
+
+			/** Writes all buffered frames and their index entries to disk.
+			 *  @throws std::runtime_error on error.
+			 */
+			void flush( void );
+
+			/** Writes all buffered frames and closes the log.
+			 *  @throws std::runtime_error on error.
+			 */
+			void close( void );
+
+			/** Returns the number of frames appended.
+			 *  @return The frame count.
+			 */
+			std::uint64_t getFrameCount( void );
+
+			/** Returns the log file size, including buffered data ( in bytes ).
+			 *  @return The log size in bytes.
+			 */
+			std::uint64_t getBytes( void );
+
+			/** Returns the log file name.
+			 *  @return The log file name, or an empty string if no log is open.
+			 */
+			const std::string getFileName( void );
+
+			/** Log file identifier */
+			static const char LOG_MAGIC[ 8 ];
+
+			/** Index file identifier */
+			static const char INDEX_MAGIC[ 8 ];
+
+			/** Frame record identifier */
+			static const std::uint32_t RECORD_MAGIC = 0x46435241;
+
+			/** File format version */
+			static const std::uint32_t VERSION = 1;
+
+			/** Log and index file header size ( in bytes ) */
+			static const std::uint32_t HEADER_BYTES = 64;
+
+			/** Frame record header size ( in bytes ) */
+			static const std::uint32_t RECORD_BYTES = 48;
+
+		private:
+
+			/** Writes the staging buffer and pending index entries. Caller must hold m_tMutex. */
+			void writeBuffer( void );
+
+			/** Writes the specified bytes to a file, throwing on error. */
+			void writeFile( std::ofstream& tFile, const void* pBuf, std::uint64_t u64Bytes, const std::string& sName );
+
+			/** Log file name */
+			std::string m_sFileName;
+
+			/** Log file */
+			std::ofstream m_tLog;
+
+			/** Index file */
+			std::ofstream m_tIndex;
+
+			/** Staging buffer */
+			std::unique_ptr<std::uint8_t[]> m_pBuffer;
+
+			/** Staging buffer size and fill level ( in bytes ) */
+			std::uint64_t m_u64BufferBytes;
+			std::uint64_t m_u64BufferUsed;
+
+			/** Index entries for the frames in the staging buffer */
+			std::vector<arc::gen3::fits::FrameLogEntry> m_vPending;
+
+			/** Log size, including buffered data ( in bytes ) */
+			std::uint64_t m_u64Bytes;
+
+			/** Frames appended */
+			std::uint64_t m_u64Frames;
+
+			/** Serializes append(), flush() and close() */
+			std::mutex m_tMutex;
+		};
+
+
+		/** @class CArcFrameLogReader
+		 *  Random access reader for logs written by CArcFrameLog, with conversion to FITS data cubes.
+		 */
+		class GEN3_CARCFITSFILE_API CArcFrameLogReader
+		{
+		public:
+
+			/** Constructor
+			 *  Creates an empty frame log reader.
+			 */
+			CArcFrameLogReader( void );
+
+			/** Destructor
+			 */
+			virtual ~CArcFrameLogReader( void );
+
+			/** Opens an existing frame log. The index file is used if it is present and consistent with the log;
+			 *  otherwise the index is rebuilt by scanning the log, stopping at the first incomplete frame.
+			 *  @param sFileName - The log file name.
+			 *  @throws std::runtime_error
+			 *  @throws std::invalid_argument
+			 */
+			void open( const std::string& sFileName );
+
+			/** Closes the log.
+			 */
+			void close( void );
+
+			/** Returns the number of frames in the log.
+			 *  @return The frame count.
+			 */
+			std::uint64_t getFrameCount( void );
+
+			/** Returns 'true' if the index was rebuilt from the log rather than read from the index file.
+			 *  @return <i>true</i> if the index was rebuilt; <i>false</i> otherwise.
+			 */
+			bool isRecovered( void );
+
+			/** Returns the index entry for a frame.
+			 *  @param u64Index - The position of the frame within the log ( 0 = first frame appended ).
+			 *  @return The frame index entry.
+			 *  @throws std::out_of_range
+			 */
+			arc::gen3::fits::FrameLogEntry getEntry( std::uint64_t u64Index );
+
+			/** Returns the log position of the frame with the specified frame number.
+			 *  @param u64Frame - The frame number supplied to CArcFrameLog::append().
+			 *  @return The position of the frame within the log.
+			 *  @throws std::out_of_range if no frame has this number.
+			 */
+			std::uint64_t findFrame( std::uint64_t u64Frame );
+
+			/** Reads a frame into the specified user buffer.
+			 *  @param u64Index	- The position of the frame within the log.
+			 *  @param pBuf		- The user supplied buffer.
+			 *  @param u64Bytes	- The buffer size ( in bytes ).
+			 *  @throws std::runtime_error
+			 *  @throws std::out_of_range
+			 *  @throws std::length_error
+			 */
+			void read( std::uint64_t u64Index, void* pBuf, std::uint64_t u64Bytes );
+
+			/** Reads a frame.
+			 *  @param u64Index - The position of the frame within the log.
+			 *  @return A pointer to the frame pixel data.
+			 *  @throws std::runtime_error
+			 *  @throws std::out_of_range
+			 */
+			std::unique_ptr<std::uint8_t[]> read( std::uint64_t u64Index );
+
+			/** Writes frames from the log to a new FITS data cube, one image plane per frame, in log order. The
+			 *  frame numbers and timestamps are written to a binary table extension ( FRAMELOG ) with one row per
+			 *  plane. All frames converted must have the same geometry.
+			 *  @param sFitsFile - The FITS file name. An existing file is overwritten.
+			 *  @param u64First	 - The position of the first frame to convert ( default = 0 ).
+			 *  @param u64Count	 - The number of frames to convert; 0 converts to the end of the log ( default = 0 ).
+			 *  @throws std::runtime_error
+			 *  @throws std::invalid_argument
+			 */
+			void toFitsCube( const std::string& sFitsFile, std::uint64_t u64First = 0, std::uint64_t u64Count = 0 );
+
+		private:
+
+			/** Reads and validates the index file. Returns <i>false</i> if it is missing or inconsistent. */
+			bool loadIndex( const std::string& sIndexFile, std::uint64_t u64LogBytes );
+
+			/** Rebuilds the index by scanning the log record headers. */
+			void scanLog( std::uint64_t u64LogBytes );
+
+			/** Writes a range of frames to an open FITS data cube. */
+			template <typename T> void writeCube( const std::string& sFitsFile, std::uint64_t u64First, std::uint64_t u64Count );
+
+			/** Log file name */
+			std::string m_sFileName;
+
+			/** Log file */
+			std::ifstream m_tLog;
+
+			/** Frame index, in log order */
+			std::vector<arc::gen3::fits::FrameLogEntry> m_vIndex;
+
+			/** Frame numbers and log positions, sorted by frame number */
+			std::vector<std::pair<std::uint64_t, std::uint64_t>> m_vByFrame;
+
+			/** 'true' if the index was rebuilt from the log */
+			bool m_bRecovered;
+		};
+
+	}	// end gen3 namespace
+}		// end arc namespace
+
+
+#endif		// _GEN3_CARCFRAMELOG_H_
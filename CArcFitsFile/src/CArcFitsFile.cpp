@@ -15,6 +15,7 @@
 #include <cmath>
 
 #include <CArcFitsFile.h>
+#include <CArcTrace.h>
 
 
 #if defined( _WINDOWS ) || defined( __linux )
@@ -1336,6 +1337,8 @@ namespace arc
 		// +----------------------------------------------------------------------------------------------------------+
 		template <typename T> void CArcFitsFile<T>::write( T* pBuf )
 		{
+			ARC_TRACE_SPAN( "CArcFitsFile::write", "fits" );
+
 			std::int64_t i64NElements = 0;
 			std::int64_t i64FPixel = 1;
 			std::int32_t iStatus = 0;
@@ -1407,6 +1410,8 @@ namespace arc
 		// +----------------------------------------------------------------------------------------------------------+
 		template <typename T> void CArcFitsFile<T>::write( T* pBuf, std::int64_t i64Bytes, std::int64_t i64Pixel )
 		{
+			ARC_TRACE_SPAN( "CArcFitsFile::write", "fits" );
+
 			std::int64_t i64NElements = 0;
 			std::int32_t iStatus = 0;
 
@@ -1520,6 +1525,8 @@ namespace arc
 		template <typename T>
 		void CArcFitsFile<T>::writeSubImage( T* pBuf, arc::gen3::fits::Point lowerLeftPoint, arc::gen3::fits::Point upperRightPoint )
 		{
+			ARC_TRACE_SPAN( "CArcFitsFile::writeSubImage", "fits" );
+
 			std::int32_t iStatus = 0;
 
 			VERIFY_FILE_HANDLE()
@@ -1843,6 +1850,8 @@ namespace arc
 			// +----------------------------------------------------------------------------------------------------------+
 			template <typename T> void CArcFitsFile<T>::write3D( T* pBuf )
 			{
+				ARC_TRACE_SPAN( "CArcFitsFile::write3D", "fits" );
+
 				std::int64_t i64NElements = 0;
 				std::int32_t iStatus = 0;
 
@@ -1932,6 +1941,8 @@ namespace arc
 			// +----------------------------------------------------------------------------------------------------------+
 			template <typename T> void CArcFitsFile<T>::reWrite3D( T* pBuf, std::uint32_t uiImageNumber )
 			{
+				ARC_TRACE_SPAN( "CArcFitsFile::reWrite3D", "fits" );
+
 				std::int64_t i64NElements = 0;
 				std::int64_t i64Pixel = 0;
 				std::int32_t iStatus = 0;
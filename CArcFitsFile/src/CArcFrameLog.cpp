@@ -0,0 +1,963 @@
+// +------------------------------------------------------------------------------------------------------------------+
+// |  FILE:  CArcFrameLog.cpp  ( Gen3 )                                                                               |
+// +------------------------------------------------------------------------------------------------------------------+
+// |  PURPOSE:  Defines an append-only raw frame log for high-rate capture, with a reader and a FITS data cube        |
+// |            converter.                                                                                            |
+// |                                                                                                                  |
+// |  FORMAT:   <log>      64 byte header ( "ARCFLOG1", version, header size, creation time ), followed by one        |
+// |                       record per frame: a 48 byte record header ( RECORD_MAGIC, record header size, index        |
+// |                       entry ) and the raw frame pixel data.                                                      |
+// |            <log>.idx  64 byte header ( "ARCFIDX1", ... ), followed by one 40 byte FrameLogEntry per frame.       |
+// |                                                                                                                  |
+// |            All values are written in host byte order.                                                            |
+// +------------------------------------------------------------------------------------------------------------------+
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+
+#include <CArcFitsFile.h>
+#include <CArcFrameLog.h>
+#include <CArcTrace.h>
+
+
+
+namespace arc
+{
+	namespace gen3
+	{
+
+		static_assert( sizeof( arc::gen3::fits::FrameLogEntry ) == 40, "FrameLogEntry must be 40 bytes" );
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// | File identifiers                                                                                         |
+		// +----------------------------------------------------------------------------------------------------------+
+		const char CArcFrameLog::LOG_MAGIC[ 8 ]   = { 'A', 'R', 'C', 'F', 'L', 'O', 'G', '1' };
+		const char CArcFrameLog::INDEX_MAGIC[ 8 ] = { 'A', 'R', 'C', 'F', 'I', 'D', 'X', '1' };
+
+		const std::uint32_t CArcFrameLog::RECORD_MAGIC;
+		const std::uint32_t CArcFrameLog::VERSION;
+		const std::uint32_t CArcFrameLog::HEADER_BYTES;
+		const std::uint32_t CArcFrameLog::RECORD_BYTES;
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  makeHeader                                                                                              |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Fills in a log or index file header.                                                                    |
+		// |                                                                                                          |
+		// |  <OUT> -> pHeader - A HEADER_BYTES buffer to receive the header.                                         |
+		// |  <IN>  -> pMagic  - The file identifier.                                                                 |
+		// +----------------------------------------------------------------------------------------------------------+
+		static void makeHeader( std::uint8_t* pHeader, const char* pMagic )
+		{
+			std::uint32_t uiVersion = CArcFrameLog::VERSION;
+			std::uint32_t uiHeaderBytes = CArcFrameLog::HEADER_BYTES;
+			std::int64_t  i64Created = static_cast<std::int64_t>( std::time( nullptr ) );
+
+			std::memset( pHeader, 0, CArcFrameLog::HEADER_BYTES );
+
+			std::memcpy( pHeader, pMagic, 8 );
+			std::memcpy( pHeader + 8, &uiVersion, sizeof( uiVersion ) );
+			std::memcpy( pHeader + 12, &uiHeaderBytes, sizeof( uiHeaderBytes ) );
+			std::memcpy( pHeader + 16, &i64Created, sizeof( i64Created ) );
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  checkHeader                                                                                             |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Returns 'true' if the header read from a log or index file is valid.                                    |
+		// |                                                                                                          |
+		// |  <IN> -> pHeader - The HEADER_BYTES header.                                                              |
+		// |  <IN> -> pMagic  - The expected file identifier.                                                         |
+		// +----------------------------------------------------------------------------------------------------------+
+		static bool checkHeader( const std::uint8_t* pHeader, const char* pMagic )
+		{
+			std::uint32_t uiVersion = 0;
+			std::uint32_t uiHeaderBytes = 0;
+
+			std::memcpy( &uiVersion, pHeader + 8, sizeof( uiVersion ) );
+			std::memcpy( &uiHeaderBytes, pHeader + 12, sizeof( uiHeaderBytes ) );
+
+			return ( std::memcmp( pHeader, pMagic, 8 ) == 0 && uiVersion == CArcFrameLog::VERSION && uiHeaderBytes == CArcFrameLog::HEADER_BYTES );
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  isValidGeometry                                                                                         |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Returns 'true' if an index entry describes a frame the log can hold.                                    |
+		// +----------------------------------------------------------------------------------------------------------+
+		static bool isValidGeometry( const arc::gen3::fits::FrameLogEntry& tEntry )
+		{
+			return ( tEntry.uiCols > 0 && tEntry.uiRows > 0 && ( tEntry.uiBpp == 16 || tEntry.uiBpp == 32 ) );
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  FrameLogEntry::bytes                                                                                    |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Returns the frame pixel data size ( in bytes ).                                                         |
+		// +----------------------------------------------------------------------------------------------------------+
+		std::uint64_t fits::FrameLogEntry::bytes( void ) const
+		{
+			return ( static_cast<std::uint64_t>( uiCols ) * static_cast<std::uint64_t>( uiRows ) * ( uiBpp / 8 ) );
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  CArcFrameLog constructor                                                                                |
+		// +----------------------------------------------------------------------------------------------------------+
+		CArcFrameLog::CArcFrameLog( void ) : m_u64BufferBytes( 0 ), m_u64BufferUsed( 0 ), m_u64Bytes( 0 ), m_u64Frames( 0 )
+		{
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  CArcFrameLog destructor                                                                                 |
+		// +----------------------------------------------------------------------------------------------------------+
+		CArcFrameLog::~CArcFrameLog( void )
+		{
+			try
+			{
+				close();
+			}
+			catch ( ... )
+			{
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  create                                                                                                  |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Creates a new, empty frame log on disk. Existing files are overwritten. Both files are opened without   |
+		// |  stream buffering; the staging buffer is the only buffer, so each flush is one large sequential write.   |
+		// |                                                                                                          |
+		// |  <IN> -> sFileName		- The log file name. The index is written to sFileName + ".idx".                  |
+		// |  <IN> -> uiBufferBytes	- The staging buffer size ( default = 16 MB ).                                    |
+		// |                                                                                                          |
+		// |  Throws std::runtime_error, std::invalid_argument                                                        |
+		// +----------------------------------------------------------------------------------------------------------+
+		void CArcFrameLog::create( const std::string& sFileName, std::uint32_t uiBufferBytes )
+		{
+			if ( sFileName.empty() )
+			{
+				THROW_INVALID_ARGUMENT( "Invalid file name : %s", sFileName.c_str() );
+			}
+
+			if ( uiBufferBytes < RECORD_BYTES )
+			{
+				THROW_INVALID_ARGUMENT( "Invalid staging buffer size: %u. Must be at least %u bytes.", uiBufferBytes, RECORD_BYTES );
+			}
+
+			close();
+
+			std::lock_guard<std::mutex> tLock( m_tMutex );
+
+			std::string sIndexFile = sFileName + ".idx";
+
+			m_tLog.rdbuf()->pubsetbuf( nullptr, 0 );
+
+			m_tLog.open( sFileName, std::ios::out | std::ios::binary | std::ios::trunc );
+
+			if ( !m_tLog.is_open() )
+			{
+				THROW( "Failed to create frame log: %s, error: %e", sFileName.c_str(), arc::gen3::CArcBase::getSystemError() );
+			}
+
+			m_tIndex.rdbuf()->pubsetbuf( nullptr, 0 );
+
+			m_tIndex.open( sIndexFile, std::ios::out | std::ios::binary | std::ios::trunc );
+
+			if ( !m_tIndex.is_open() )
+			{
+				m_tLog.close();
+
+				THROW( "Failed to create frame log index: %s, error: %e", sIndexFile.c_str(), arc::gen3::CArcBase::getSystemError() );
+			}
+
+			std::uint8_t a_uiHeader[ HEADER_BYTES ];
+
+			try
+			{
+				makeHeader( a_uiHeader, LOG_MAGIC );
+
+				writeFile( m_tLog, a_uiHeader, HEADER_BYTES, sFileName );
+
+				makeHeader( a_uiHeader, INDEX_MAGIC );
+
+				writeFile( m_tIndex, a_uiHeader, HEADER_BYTES, sIndexFile );
+
+				m_pBuffer.reset( new std::uint8_t[ uiBufferBytes ] );
+			}
+			catch ( ... )
+			{
+				m_tLog.close();
+				m_tIndex.close();
+
+				throw;
+			}
+
+			m_sFileName		 = sFileName;
+			m_u64BufferBytes = uiBufferBytes;
+			m_u64BufferUsed	 = 0;
+			m_u64Bytes		 = HEADER_BYTES;
+			m_u64Frames		 = 0;
+
+			m_vPending.clear();
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  append                                                                                                  |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Appends a frame to the log. The frame is copied into the staging buffer, which is written when the      |
+		// |  next frame will not fit. Frames larger than the staging buffer are written directly.                    |
+		// |                                                                                                          |
+		// |  <IN> -> pBuf			- The frame pixel data.                                                           |
+		// |  <IN> -> uiCols		- The image column size ( in pixels ).                                            |
+		// |  <IN> -> uiRows		- The image row size ( in pixels ).                                               |
+		// |  <IN> -> uiBpp			- The image bits-per-pixel ( 16 or 32 ).                                          |
+		// |  <IN> -> u64Frame		- The frame ( sequence ) number.                                                  |
+		// |  <IN> -> i64Timestamp	- The frame timestamp ( typically ns ).                                           |
+		// |                                                                                                          |
+		// |  Throws std::runtime_error, std::invalid_argument                                                        |
+		// +----------------------------------------------------------------------------------------------------------+
+		void CArcFrameLog::append( const void* pBuf, std::uint32_t uiCols, std::uint32_t uiRows, std::uint32_t uiBpp, std::uint64_t u64Frame, std::int64_t i64Timestamp )
+		{
+			if ( pBuf == nullptr )
+			{
+				THROW_INVALID_ARGUMENT( "Invalid frame buffer, cannot be nullptr" );
+			}
+
+			arc::gen3::fits::FrameLogEntry tEntry = { u64Frame, i64Timestamp, 0, uiCols, uiRows, uiBpp, 0 };
+
+			if ( !isValidGeometry( tEntry ) )
+			{
+				THROW_INVALID_ARGUMENT( "Invalid frame geometry [ cols: %u rows: %u bpp: %u ]", uiCols, uiRows, uiBpp );
+			}
+
+			std::lock_guard<std::mutex> tLock( m_tMutex );
+
+			if ( !m_tLog.is_open() )
+			{
+				THROW( "No frame log open" );
+			}
+
+			tEntry.u64Offset = m_u64Bytes + RECORD_BYTES;
+
+			std::uint64_t u64FrameBytes = tEntry.bytes();
+
+			std::uint64_t u64RecordBytes = ( RECORD_BYTES + u64FrameBytes );
+
+			std::uint8_t a_uiRecord[ RECORD_BYTES ];
+
+			std::uint32_t a_uiRecordId[] = { RECORD_MAGIC, RECORD_BYTES };
+
+			std::memcpy( a_uiRecord, a_uiRecordId, sizeof( a_uiRecordId ) );
+			std::memcpy( a_uiRecord + sizeof( a_uiRecordId ), &tEntry, sizeof( tEntry ) );
+
+			if ( ( m_u64BufferUsed + u64RecordBytes ) > m_u64BufferBytes )
+			{
+				writeBuffer();
+			}
+
+			if ( u64RecordBytes > m_u64BufferBytes )
+			{
+				writeFile( m_tLog, a_uiRecord, RECORD_BYTES, m_sFileName );
+
+				writeFile( m_tLog, pBuf, u64FrameBytes, m_sFileName );
+
+				writeFile( m_tIndex, &tEntry, sizeof( tEntry ), m_sFileName + ".idx" );
+			}
+
+			else
+			{
+				std::memcpy( m_pBuffer.get() + m_u64BufferUsed, a_uiRecord, RECORD_BYTES );
+
+				std::memcpy( m_pBuffer.get() + m_u64BufferUsed + RECORD_BYTES, pBuf, u64FrameBytes );
+
+				m_u64BufferUsed += u64RecordBytes;
+
+				m_vPending.push_back( tEntry );
+			}
+
+			m_u64Bytes += u64RecordBytes;
+
+			m_u64Frames++;
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  flush                                                                                                   |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Writes all buffered frames and their index entries to disk.                                             |
+		// |                                                                                                          |
+		// |  Throws std::runtime_error                                                                               |
+		// +----------------------------------------------------------------------------------------------------------+
+		void CArcFrameLog::flush( void )
+		{
+			ARC_TRACE_SPAN( "CArcFrameLog::flush", "fits" );
+
+			std::lock_guard<std::mutex> tLock( m_tMutex );
+
+			if ( m_tLog.is_open() )
+			{
+				writeBuffer();
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  close                                                                                                   |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Writes all buffered frames and closes the log. The files are closed even if the final write fails.      |
+		// |                                                                                                          |
+		// |  Throws std::runtime_error                                                                               |
+		// +----------------------------------------------------------------------------------------------------------+
+		void CArcFrameLog::close( void )
+		{
+			std::lock_guard<std::mutex> tLock( m_tMutex );
+
+			if ( !m_tLog.is_open() )
+			{
+				return;
+			}
+
+			try
+			{
+				writeBuffer();
+			}
+			catch ( ... )
+			{
+				m_tLog.close();
+				m_tIndex.close();
+
+				m_sFileName.clear();
+
+				throw;
+			}
+
+			m_tLog.close();
+			m_tIndex.close();
+
+			m_pBuffer.reset();
+
+			m_sFileName.clear();
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  getFrameCount                                                                                           |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Returns the number of frames appended.                                                                  |
+		// +----------------------------------------------------------------------------------------------------------+
+		std::uint64_t CArcFrameLog::getFrameCount( void )
+		{
+			std::lock_guard<std::mutex> tLock( m_tMutex );
+
+			return m_u64Frames;
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  getBytes                                                                                                |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Returns the log file size, including buffered data ( in bytes ).                                       |
+		// +----------------------------------------------------------------------------------------------------------+
+		std::uint64_t CArcFrameLog::getBytes( void )
+		{
+			std::lock_guard<std::mutex> tLock( m_tMutex );
+
+			return m_u64Bytes;
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  getFileName                                                                                             |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Returns the log file name, or an empty string if no log is open.                                        |
+		// +----------------------------------------------------------------------------------------------------------+
+		const std::string CArcFrameLog::getFileName( void )
+		{
+			std::lock_guard<std::mutex> tLock( m_tMutex );
+
+			return m_sFileName;
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  writeBuffer                                                                                             |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Writes the staging buffer, then the index entries for the frames it held, so the index never refers     |
+		// |  to data that is not yet in the log. Caller must hold m_tMutex.                                          |
+		// |                                                                                                          |
+		// |  Throws std::runtime_error                                                                               |
+		// +----------------------------------------------------------------------------------------------------------+
+		void CArcFrameLog::writeBuffer( void )
+		{
+			ARC_TRACE_SPAN( "CArcFrameLog::writeBuffer", "fits" );
+
+			if ( m_u64BufferUsed > 0 )
+			{
+				writeFile( m_tLog, m_pBuffer.get(), m_u64BufferUsed, m_sFileName );
+
+				m_u64BufferUsed = 0;
+			}
+
+			if ( !m_vPending.empty() )
+			{
+				writeFile( m_tIndex, m_vPending.data(), ( m_vPending.size() * sizeof( arc::gen3::fits::FrameLogEntry ) ), m_sFileName + ".idx" );
+
+				m_vPending.clear();
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  writeFile                                                                                               |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Writes the specified bytes to a file.                                                                   |
+		// |                                                                                                          |
+		// |  <IN> -> tFile		- The file to write.                                                                  |
+		// |  <IN> -> pBuf		- The data to write.                                                                  |
+		// |  <IN> -> u64Bytes	- The number of bytes to write.                                                       |
+		// |  <IN> -> sName		- The file name, for error reporting.                                                 |
+		// |                                                                                                          |
+		// |  Throws std::runtime_error                                                                               |
+		// +----------------------------------------------------------------------------------------------------------+
+		void CArcFrameLog::writeFile( std::ofstream& tFile, const void* pBuf, std::uint64_t u64Bytes, const std::string& sName )
+		{
+			tFile.write( static_cast<const char*>( pBuf ), static_cast<std::streamsize>( u64Bytes ) );
+
+			if ( !tFile )
+			{
+				THROW( "Failed to write %J bytes to frame log file: %s, error: %e", static_cast<unsigned long long>( u64Bytes ), sName.c_str(), arc::gen3::CArcBase::getSystemError() );
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  CArcFrameLogReader constructor                                                                          |
+		// +----------------------------------------------------------------------------------------------------------+
+		CArcFrameLogReader::CArcFrameLogReader( void ) : m_bRecovered( false )
+		{
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  CArcFrameLogReader destructor                                                                           |
+		// +----------------------------------------------------------------------------------------------------------+
+		CArcFrameLogReader::~CArcFrameLogReader( void )
+		{
+			close();
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  open                                                                                                    |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Opens an existing frame log. The index file is used as far as it is consistent with the log; frames     |
+		// |  beyond it ( or all frames, if it is missing or invalid ) are found by scanning the log record headers,  |
+		// |  stopping at the first incomplete record.                                                                |
+		// |                                                                                                          |
+		// |  <IN> -> sFileName - The log file name.                                                                  |
+		// |                                                                                                          |
+		// |  Throws std::runtime_error, std::invalid_argument                                                        |
+		// +----------------------------------------------------------------------------------------------------------+
+		void CArcFrameLogReader::open( const std::string& sFileName )
+		{
+			if ( sFileName.empty() )
+			{
+				THROW_INVALID_ARGUMENT( "Invalid file name : %s", sFileName.c_str() );
+			}
+
+			close();
+
+			m_tLog.open( sFileName, std::ios::in | std::ios::binary );
+
+			if ( !m_tLog.is_open() )
+			{
+				THROW( "Failed to open frame log: %s, error: %e", sFileName.c_str(), arc::gen3::CArcBase::getSystemError() );
+			}
+
+			m_tLog.seekg( 0, std::ios::end );
+
+			std::uint64_t u64LogBytes = static_cast<std::uint64_t>( m_tLog.tellg() );
+
+			m_tLog.seekg( 0, std::ios::beg );
+
+			std::uint8_t a_uiHeader[ CArcFrameLog::HEADER_BYTES ];
+
+			m_tLog.read( reinterpret_cast<char*>( a_uiHeader ), CArcFrameLog::HEADER_BYTES );
+
+			if ( !m_tLog || !checkHeader( a_uiHeader, CArcFrameLog::LOG_MAGIC ) )
+			{
+				m_tLog.close();
+
+				THROW( "Invalid frame log file: %s", sFileName.c_str() );
+			}
+
+			m_sFileName = sFileName;
+
+			if ( !loadIndex( sFileName + ".idx", u64LogBytes ) )
+			{
+				m_vIndex.clear();
+			}
+
+			scanLog( u64LogBytes );
+
+			m_vByFrame.reserve( m_vIndex.size() );
+
+			for ( std::uint64_t i = 0; i < m_vIndex.size(); i++ )
+			{
+				m_vByFrame.push_back( std::make_pair( m_vIndex[ i ].u64Frame, i ) );
+			}
+
+			std::sort( m_vByFrame.begin(), m_vByFrame.end() );
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  close                                                                                                   |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Closes the log.                                                                                         |
+		// +----------------------------------------------------------------------------------------------------------+
+		void CArcFrameLogReader::close( void )
+		{
+			if ( m_tLog.is_open() )
+			{
+				m_tLog.close();
+			}
+
+			m_tLog.clear();
+
+			m_sFileName.clear();
+
+			m_vIndex.clear();
+
+			m_vByFrame.clear();
+
+			m_bRecovered = false;
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  getFrameCount                                                                                           |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Returns the number of frames in the log.                                                                |
+		// +----------------------------------------------------------------------------------------------------------+
+		std::uint64_t CArcFrameLogReader::getFrameCount( void )
+		{
+			return static_cast<std::uint64_t>( m_vIndex.size() );
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  isRecovered                                                                                             |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Returns 'true' if any part of the index was rebuilt from the log rather than read from the index file.  |
+		// +----------------------------------------------------------------------------------------------------------+
+		bool CArcFrameLogReader::isRecovered( void )
+		{
+			return m_bRecovered;
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  getEntry                                                                                                |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Returns the index entry for a frame.                                                                    |
+		// |                                                                                                          |
+		// |  <IN> -> u64Index - The position of the frame within the log ( 0 = first frame appended ).               |
+		// |                                                                                                          |
+		// |  Throws std::out_of_range                                                                                |
+		// +----------------------------------------------------------------------------------------------------------+
+		arc::gen3::fits::FrameLogEntry CArcFrameLogReader::getEntry( std::uint64_t u64Index )
+		{
+			if ( u64Index >= m_vIndex.size() )
+			{
+				arc::gen3::CArcBase::throwException<std::out_of_range>( __FUNCTION__, __LINE__,
+																		 "Frame log position %J is out of range. The log holds %J frames.",
+																		 static_cast<unsigned long long>( u64Index ),
+																		 static_cast<unsigned long long>( m_vIndex.size() ) );
+			}
+
+			return m_vIndex[ u64Index ];
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  findFrame                                                                                               |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Returns the log position of the frame with the specified frame number. If the number was appended more  |
+		// |  than once, the first position is returned.                                                              |
+		// |                                                                                                          |
+		// |  <IN> -> u64Frame - The frame number supplied to CArcFrameLog::append().                                 |
+		// |                                                                                                          |
+		// |  Throws std::out_of_range                                                                                |
+		// +----------------------------------------------------------------------------------------------------------+
+		std::uint64_t CArcFrameLogReader::findFrame( std::uint64_t u64Frame )
+		{
+			auto it = std::lower_bound( m_vByFrame.begin(), m_vByFrame.end(), std::make_pair( u64Frame, std::uint64_t( 0 ) ) );
+
+			if ( it == m_vByFrame.end() || it->first != u64Frame )
+			{
+				arc::gen3::CArcBase::throwException<std::out_of_range>( __FUNCTION__, __LINE__,
+																		 "Frame %J is not in the frame log",
+																		 static_cast<unsigned long long>( u64Frame ) );
+			}
+
+			return it->second;
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  read                                                                                                    |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Reads a frame into the specified user buffer.                                                           |
+		// |                                                                                                          |
+		// |  <IN> -> u64Index	- The position of the frame within the log.                                           |
+		// |  <IN> -> pBuf		- The user supplied buffer.                                                           |
+		// |  <IN> -> u64Bytes	- The buffer size ( in bytes ).                                                       |
+		// |                                                                                                          |
+		// |  Throws std::runtime_error, std::invalid_argument, std::out_of_range, std::length_error                  |
+		// +----------------------------------------------------------------------------------------------------------+
+		void CArcFrameLogReader::read( std::uint64_t u64Index, void* pBuf, std::uint64_t u64Bytes )
+		{
+			auto tEntry = getEntry( u64Index );
+
+			if ( pBuf == nullptr )
+			{
+				THROW_INVALID_ARGUMENT( "Invalid frame buffer, cannot be nullptr" );
+			}
+
+			if ( u64Bytes < tEntry.bytes() )
+			{
+				THROW_LENGTH_ERROR( "Buffer too small. Frame requires %J bytes, buffer holds %J bytes.",
+									static_cast<unsigned long long>( tEntry.bytes() ),
+									static_cast<unsigned long long>( u64Bytes ) );
+			}
+
+			m_tLog.clear();
+
+			m_tLog.seekg( static_cast<std::streamoff>( tEntry.u64Offset ), std::ios::beg );
+
+			m_tLog.read( static_cast<char*>( pBuf ), static_cast<std::streamsize>( tEntry.bytes() ) );
+
+			if ( !m_tLog )
+			{
+				m_tLog.clear();
+
+				THROW( "Failed to read frame log position %J from: %s", static_cast<unsigned long long>( u64Index ), m_sFileName.c_str() );
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  read                                                                                                    |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Reads a frame into a new buffer.                                                                        |
+		// |                                                                                                          |
+		// |  <IN> -> u64Index	- The position of the frame within the log.                                           |
+		// |                                                                                                          |
+		// |  Throws std::runtime_error, std::out_of_range                                                            |
+		// +----------------------------------------------------------------------------------------------------------+
+		std::unique_ptr<std::uint8_t[]> CArcFrameLogReader::read( std::uint64_t u64Index )
+		{
+			auto u64Bytes = getEntry( u64Index ).bytes();
+
+			std::unique_ptr<std::uint8_t[]> pBuf( new std::uint8_t[ u64Bytes ] );
+
+			read( u64Index, pBuf.get(), u64Bytes );
+
+			return pBuf;
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  toFitsCube                                                                                              |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Writes frames from the log to a new FITS data cube, one image plane per frame, in log order. The frame  |
+		// |  numbers and timestamps are written to a FRAMELOG binary table extension, one row per plane.             |
+		// |                                                                                                          |
+		// |  <IN> -> sFitsFile	- The FITS file name. An existing file is overwritten.                                |
+		// |  <IN> -> u64First	- The position of the first frame to convert.                                         |
+		// |  <IN> -> u64Count	- The number of frames to convert; 0 converts to the end of the log.                  |
+		// |                                                                                                          |
+		// |  Throws std::runtime_error, std::invalid_argument                                                        |
+		// +----------------------------------------------------------------------------------------------------------+
+		void CArcFrameLogReader::toFitsCube( const std::string& sFitsFile, std::uint64_t u64First, std::uint64_t u64Count )
+		{
+			ARC_TRACE_SPAN( "CArcFrameLogReader::toFitsCube", "fits" );
+
+			if ( !m_tLog.is_open() )
+			{
+				THROW( "No frame log open" );
+			}
+
+			if ( u64First >= m_vIndex.size() )
+			{
+				THROW_INVALID_ARGUMENT( "Invalid first frame position: %J. The log holds %J frames.",
+										static_cast<unsigned long long>( u64First ),
+										static_cast<unsigned long long>( m_vIndex.size() ) );
+			}
+
+			if ( u64Count == 0 )
+			{
+				u64Count = ( m_vIndex.size() - u64First );
+			}
+
+			if ( u64Count > ( m_vIndex.size() - u64First ) )
+			{
+				THROW_INVALID_ARGUMENT( "Invalid frame count: %J. Only %J frames follow position %J.",
+										static_cast<unsigned long long>( u64Count ),
+										static_cast<unsigned long long>( m_vIndex.size() - u64First ),
+										static_cast<unsigned long long>( u64First ) );
+			}
+
+			//
+			// All planes of a data cube share one geometry
+			//
+			auto& tFirst = m_vIndex[ u64First ];
+
+			for ( auto i = u64First; i < ( u64First + u64Count ); i++ )
+			{
+				if ( m_vIndex[ i ].uiCols != tFirst.uiCols || m_vIndex[ i ].uiRows != tFirst.uiRows || m_vIndex[ i ].uiBpp != tFirst.uiBpp )
+				{
+					THROW_INVALID_ARGUMENT( "Frame log position %J geometry [ %u x %u x %u ] differs from position %J [ %u x %u x %u ]",
+											static_cast<unsigned long long>( i ), m_vIndex[ i ].uiCols, m_vIndex[ i ].uiRows, m_vIndex[ i ].uiBpp,
+											static_cast<unsigned long long>( u64First ), tFirst.uiCols, tFirst.uiRows, tFirst.uiBpp );
+				}
+			}
+
+			if ( tFirst.uiBpp == 16 )
+			{
+				writeCube<arc::gen3::fits::BPP_16>( sFitsFile, u64First, u64Count );
+			}
+
+			else
+			{
+				writeCube<arc::gen3::fits::BPP_32>( sFitsFile, u64First, u64Count );
+			}
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  loadIndex                                                                                               |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Reads the index file into m_vIndex. Each entry is checked against the log: frames must follow one      |
+		// |  another and lie entirely within the log. A trailing partial entry is ignored.                           |
+		// |                                                                                                          |
+		// |  <IN> -> sIndexFile	- The index file name.                                                            |
+		// |  <IN> -> u64LogBytes	- The log file size ( in bytes ).                                                 |
+		// |                                                                                                          |
+		// |  Returns 'false' if the index file is missing or inconsistent with the log.                              |
+		// +----------------------------------------------------------------------------------------------------------+
+		bool CArcFrameLogReader::loadIndex( const std::string& sIndexFile, std::uint64_t u64LogBytes )
+		{
+			std::ifstream tIndex( sIndexFile, std::ios::in | std::ios::binary );
+
+			if ( !tIndex.is_open() )
+			{
+				return false;
+			}
+
+			tIndex.seekg( 0, std::ios::end );
+
+			std::uint64_t u64IndexBytes = static_cast<std::uint64_t>( tIndex.tellg() );
+
+			tIndex.seekg( 0, std::ios::beg );
+
+			std::uint8_t a_uiHeader[ CArcFrameLog::HEADER_BYTES ];
+
+			tIndex.read( reinterpret_cast<char*>( a_uiHeader ), CArcFrameLog::HEADER_BYTES );
+
+			if ( !tIndex || !checkHeader( a_uiHeader, CArcFrameLog::INDEX_MAGIC ) )
+			{
+				return false;
+			}
+
+			auto u64Entries = ( ( u64IndexBytes - CArcFrameLog::HEADER_BYTES ) / sizeof( arc::gen3::fits::FrameLogEntry ) );
+
+			m_vIndex.resize( u64Entries );
+
+			tIndex.read( reinterpret_cast<char*>( m_vIndex.data() ), static_cast<std::streamsize>( u64Entries * sizeof( arc::gen3::fits::FrameLogEntry ) ) );
+
+			if ( !tIndex )
+			{
+				return false;
+			}
+
+			std::uint64_t u64Offset = ( CArcFrameLog::HEADER_BYTES + CArcFrameLog::RECORD_BYTES );
+
+			for ( auto& tEntry : m_vIndex )
+			{
+				if ( tEntry.u64Offset != u64Offset || !isValidGeometry( tEntry ) || ( tEntry.u64Offset + tEntry.bytes() ) > u64LogBytes )
+				{
+					return false;
+				}
+
+				u64Offset += ( tEntry.bytes() + CArcFrameLog::RECORD_BYTES );
+			}
+
+			return true;
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  scanLog                                                                                                 |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Adds the frames that follow the last indexed frame by reading the log record headers. Stops at the      |
+		// |  end of the log or at the first incomplete or invalid record, such as the one being written when a       |
+		// |  capture was cut short.                                                                                  |
+		// |                                                                                                          |
+		// |  <IN> -> u64LogBytes - The log file size ( in bytes ).                                                   |
+		// +----------------------------------------------------------------------------------------------------------+
+		void CArcFrameLogReader::scanLog( std::uint64_t u64LogBytes )
+		{
+			std::uint64_t u64Pos = CArcFrameLog::HEADER_BYTES;
+
+			if ( !m_vIndex.empty() )
+			{
+				u64Pos = ( m_vIndex.back().u64Offset + m_vIndex.back().bytes() );
+			}
+
+			std::uint8_t a_uiRecord[ CArcFrameLog::RECORD_BYTES ];
+
+			while ( ( u64Pos + CArcFrameLog::RECORD_BYTES ) <= u64LogBytes )
+			{
+				m_tLog.seekg( static_cast<std::streamoff>( u64Pos ), std::ios::beg );
+
+				m_tLog.read( reinterpret_cast<char*>( a_uiRecord ), CArcFrameLog::RECORD_BYTES );
+
+				if ( !m_tLog )
+				{
+					break;
+				}
+
+				std::uint32_t a_uiRecordId[ 2 ];
+
+				arc::gen3::fits::FrameLogEntry tEntry;
+
+				std::memcpy( a_uiRecordId, a_uiRecord, sizeof( a_uiRecordId ) );
+				std::memcpy( &tEntry, a_uiRecord + sizeof( a_uiRecordId ), sizeof( tEntry ) );
+
+				if ( a_uiRecordId[ 0 ] != CArcFrameLog::RECORD_MAGIC || a_uiRecordId[ 1 ] != CArcFrameLog::RECORD_BYTES ||
+					 tEntry.u64Offset != ( u64Pos + CArcFrameLog::RECORD_BYTES ) || !isValidGeometry( tEntry ) ||
+					 ( tEntry.u64Offset + tEntry.bytes() ) > u64LogBytes )
+				{
+					break;
+				}
+
+				m_vIndex.push_back( tEntry );
+
+				m_bRecovered = true;
+
+				u64Pos = ( tEntry.u64Offset + tEntry.bytes() );
+			}
+
+			m_tLog.clear();
+		}
+
+
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  writeCube                                                                                               |
+		// +----------------------------------------------------------------------------------------------------------+
+		// |  Writes a range of frames to a new FITS data cube. The cube is sized once for all planes and written     |
+		// |  without the per-plane header update and flush CArcFitsFile::write3D() does for live capture.            |
+		// |                                                                                                          |
+		// |  <IN> -> sFitsFile	- The FITS file name.                                                                 |
+		// |  <IN> -> u64First	- The position of the first frame to convert.                                         |
+		// |  <IN> -> u64Count	- The number of frames to convert.                                                    |
+		// |                                                                                                          |
+		// |  Throws std::runtime_error                                                                               |
+		// +----------------------------------------------------------------------------------------------------------+
+		template <typename T> void CArcFrameLogReader::writeCube( const std::string& sFitsFile, std::uint64_t u64First, std::uint64_t u64Count )
+		{
+			auto tFirst = m_vIndex[ u64First ];
+
+			auto throwFitsError = []( std::int32_t iStatus )
+			{
+				char szFitsMsg[ 100 ];
+
+				fits_get_errstatus( iStatus, szFitsMsg );
+
+				THROW( "%s", szFitsMsg );
+			};
+
+			arc::gen3::CArcFitsFile<T> cFits;
+
+			cFits.create3D( sFitsFile, tFirst.uiCols, tFirst.uiRows );
+
+			fitsfile* pFits = cFits.getBaseFile();
+
+			std::int32_t iStatus = 0;
+
+			long a_lNAxes[] = { static_cast<long>( tFirst.uiCols ), static_cast<long>( tFirst.uiRows ), static_cast<long>( u64Count ) };
+
+			fits_resize_img( pFits, ( ( sizeof( T ) == sizeof( std::uint16_t ) ) ? USHORT_IMG : ULONG_IMG ), 3, a_lNAxes, &iStatus );
+
+			if ( iStatus )
+			{
+				throwFitsError( iStatus );
+			}
+
+			std::vector<long long> vFrames( u64Count );
+			std::vector<long long> vTimestamps( u64Count );
+
+			auto u64Pixels = ( static_cast<std::uint64_t>( tFirst.uiCols ) * tFirst.uiRows );
+
+			std::unique_ptr<T[]> pPlane( new T[ u64Pixels ] );
+
+			for ( std::uint64_t i = 0; i < u64Count; i++ )
+			{
+				read( u64First + i, pPlane.get(), u64Pixels * sizeof( T ) );
+
+				fits_write_img( pFits,
+								( sizeof( T ) == sizeof( std::uint16_t ) ? TUSHORT : TUINT ),
+								static_cast<LONGLONG>( i * u64Pixels + 1 ),
+								static_cast<LONGLONG>( u64Pixels ),
+								pPlane.get(),
+								&iStatus );
+
+				if ( iStatus )
+				{
+					throwFitsError( iStatus );
+				}
+
+				vFrames[ i ]	 = static_cast<long long>( m_vIndex[ u64First + i ].u64Frame );
+				vTimestamps[ i ] = static_cast<long long>( m_vIndex[ u64First + i ].i64Timestamp );
+			}
+
+			cFits.writeKeyword( "LOGFILE", const_cast<char*>( m_sFileName.c_str() ), arc::gen3::fits::e_Type::FITS_STRING_KEY, "Source frame log" );
+
+			//
+			// Frame numbers and timestamps, one row per plane
+			//
+			char szFrame[] = "FRAME";
+			char szTimestamp[] = "TIMESTAMP";
+			char szFormat[] = "1K";
+
+			char* a_pszType[] = { szFrame, szTimestamp };
+			char* a_pszForm[] = { szFormat, szFormat };
+
+			fits_create_tbl( pFits, BINARY_TBL, static_cast<LONGLONG>( u64Count ), 2, a_pszType, a_pszForm, nullptr, "FRAMELOG", &iStatus );
+
+			fits_write_col( pFits, TLONGLONG, 1, 1, 1, static_cast<LONGLONG>( u64Count ), vFrames.data(), &iStatus );
+
+			fits_write_col( pFits, TLONGLONG, 2, 1, 1, static_cast<LONGLONG>( u64Count ), vTimestamps.data(), &iStatus );
+
+			if ( iStatus )
+			{
+				throwFitsError( iStatus );
+			}
+
+			cFits.close();
+		}
+
+	}	// end gen3 namespace
+}	// end arc namespace